@@ -0,0 +1,337 @@
+//----------------------------------------------------------------------------------------
+// Benchmark for the log durability policies.
+// Events are ingested into the ERROR and TRACE logs with each sync mode, the ingest
+// rate and the worst case data loss are printed. The worst case data loss is the
+// largest amount of ingested data that was not yet synced to disk.
+//----------------------------------------------------------------------------------------
+
+#include <appendtask.h>
+#include <parameters.h>
+#include <cmdparser.h>
+#include <message.h>
+#include <exception.h>
+#include <boost/lexical_cast.hpp>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <string>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <cstdlib>
+#include <time.h>
+
+using namespace std;
+using namespace PES_CLH;
+
+namespace fs = boost::filesystem;
+
+//----------------------------------------------------------------------------------------
+// Log task writing to a benchmark directory
+//----------------------------------------------------------------------------------------
+template<t_logtype logtype>
+class BenchTask: public AppendTask
+{
+public:
+   BenchTask(const fs::path& logdir):
+   AppendTask(),
+   m_parameters(),
+   m_logdir(logdir)
+   {
+   }
+
+   ~BenchTask()
+   {
+   }
+
+   void event(const fs::path& path) {readMsgs(path);}
+   const BaseParameters& getParameters() const {return m_parameters;}
+   fs::path getParentDir() const {return m_logdir.parent_path();}
+   fs::path getLogDir() const {return m_logdir;}
+   void createLogDir() const {fs::create_directories(m_logdir);}
+
+   // Get bytes ingested but not yet synced
+   size_t getUnsynced() const {return m_syncstate.m_unsynced;}
+
+private:
+   void stream(ostream& s) const {s << "Log type: " << m_parameters.getLogName();}
+
+   Parameters<logtype> m_parameters;
+   fs::path m_logdir;
+};
+
+struct t_result
+{
+   double m_rate;                      // Events per second
+   double m_bytes;                     // Bytes per second
+   size_t m_maxunsynced;               // Worst case data loss in bytes
+};
+
+//----------------------------------------------------------------------------------------
+// Get monotonic time in seconds
+//----------------------------------------------------------------------------------------
+double getTime()
+{
+   timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//----------------------------------------------------------------------------------------
+// Create a temporary log file with a batch of events
+//----------------------------------------------------------------------------------------
+size_t createBatch(const fs::path& path, t_headertype headertype, size_t events)
+{
+   fs::ofstream fs(path, ios_base::binary | ios_base::trunc);
+   if (fs.is_open() == false)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to open file '" << path << "'.";
+      ex.sysError();
+      throw ex;
+   }
+
+   size_t total = 0;
+   for (size_t i = 0; i < events; i++)
+   {
+      size_t size = 1 + rand() % 0x3ff;
+      const uint64_t time = Time::now();
+      if (headertype == e_tesrvHeader)
+      {
+         fs << TESRVMessage::s_headerTag << endl;
+         fs.write(reinterpret_cast<const char*>(&time), sizeof(uint64_t));
+         fs.write(reinterpret_cast<const char*>(&size), sizeof(uint64_t));
+         fs.put(0x0a);
+      }
+      else
+      {
+         fs.setf(ios::left, ios::adjustfield);
+         fs << CLHMessage::s_headerTag << endl;
+         ostringstream t;
+         t << time << endl;
+         fs << setw(18) << setfill(' ') << t.str();
+         ostringstream s;
+         s << size << endl;
+         fs << setw(14) << setfill(' ') << s.str();
+      }
+      for (size_t j = 0; j < size - 1; j++)
+      {
+         fs << ((j % 72)? 'X': '\n');
+      }
+      fs << endl;
+      total += size;
+   }
+   return total;
+}
+
+//----------------------------------------------------------------------------------------
+// Run the benchmark for one log and sync mode
+//----------------------------------------------------------------------------------------
+template<t_logtype logtype>
+t_result runBench(
+      const fs::path& dir,
+      const t_durability& durability,
+      size_t events,
+      size_t batch
+      )
+{
+   Parameters<logtype> parameters;
+   parameters.setDurability(durability);
+
+   const fs::path& logdir = dir / parameters.getLogName();
+   fs::remove_all(logdir);
+
+   BenchTask<logtype> task(logdir);
+   task.createLogDir();
+   task.open();
+
+   fs::path tmppath = logdir / parameters.getFilePrefix();
+   tmppath.replace_extension(".tmp");
+
+   t_result result = {0, 0, 0};
+   double elapsed = 0;
+   size_t bytes = 0;
+   for (size_t done = 0; done < events; done += batch)
+   {
+      size_t count = min(batch, events - done);
+      bytes += createBatch(tmppath, parameters.getHeaderType(), count);
+
+      double start = getTime();
+      task.event(tmppath);
+      elapsed += getTime() - start;
+
+      result.m_maxunsynced = max(result.m_maxunsynced, task.getUnsynced());
+   }
+   task.close();
+   fs::remove_all(logdir);
+
+   result.m_rate = events / elapsed;
+   result.m_bytes = bytes / elapsed;
+   return result;
+}
+
+//----------------------------------------------------------------------------------------
+// Get kernel write back delay in seconds for data that is not synced
+//----------------------------------------------------------------------------------------
+double getWriteBackDelay()
+{
+   double delay = 0;
+   const char* files[] = {
+         "/proc/sys/vm/dirty_expire_centisecs",
+         "/proc/sys/vm/dirty_writeback_centisecs"
+   };
+   for (size_t i = 0; i < sizeof(files) / sizeof(files[0]); i++)
+   {
+      ifstream ifs(files[i]);
+      long centisecs = 0;
+      if (ifs >> centisecs)
+      {
+         delay += centisecs / 100.0;
+      }
+   }
+   return delay;
+}
+
+//----------------------------------------------------------------------------------------
+// Print result
+//----------------------------------------------------------------------------------------
+void printResult(
+      const string& logname,
+      const string& mode,
+      const t_result& result,
+      double delay
+      )
+{
+   cout << setw(8) << left << logname << setw(16) << mode << right
+        << setw(12) << fixed << setprecision(0) << result.m_rate
+        << setw(12) << setprecision(2) << result.m_bytes / 1e6;
+   if (mode == "none")
+   {
+      // Unsynced data is written back by the kernel
+      cout << setw(16) << setprecision(0) << result.m_bytes * delay
+           << "  (kernel write back after " << delay << " s)";
+   }
+   else
+   {
+      cout << setw(16) << result.m_maxunsynced;
+   }
+   cout << endl;
+}
+
+//----------------------------------------------------------------------------------------
+// Run the benchmark for one sync mode on the ERROR and TRACE logs
+//----------------------------------------------------------------------------------------
+void runMode(
+      const fs::path& dir,
+      const string& mode,
+      const t_durability& durability,
+      size_t events,
+      size_t batch,
+      double delay
+      )
+{
+   printResult("ERROR", mode, runBench<e_error>(dir, durability, events, batch), delay);
+   printResult("TRACE", mode, runBench<e_trace>(dir, durability, events, batch), delay);
+}
+
+//----------------------------------------------------------------------------------------
+// Usage
+//----------------------------------------------------------------------------------------
+void usage(const string& cmdname)
+{
+   cout << "Usage: " << cmdname << " -d dir [-n events] [-b batch] [-i ms:kbytes]" << endl;
+}
+
+//----------------------------------------------------------------------------------------
+// Main program
+//----------------------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+   const string& path = argv[0];
+   size_t pos = path.find_last_of('/') + 1;
+   const string& cmdname = path.substr(pos);
+
+   try
+   {
+      CmdParser::Optarg optDir("d");
+      CmdParser::Optarg optEvents("n");
+      CmdParser::Optarg optBatch("b");
+      CmdParser::Optarg optInterval("i");
+
+      CmdParser cmdparser(argc, argv);
+      cmdparser.fetchOpt(optDir);
+      cmdparser.fetchOpt(optEvents);
+      cmdparser.fetchOpt(optBatch);
+      cmdparser.fetchOpt(optInterval);
+      cmdparser.check();
+
+      if (optDir.found() == false)
+      {
+         throw Exception(Exception::usage(), WHERE__);
+      }
+
+      size_t events = 20000;
+      size_t batch = 50;
+      uint32_t interval = 1000;
+      uint32_t kbytes = 512;
+      try
+      {
+         if (optEvents.found())
+         {
+            events = boost::lexical_cast<size_t>(optEvents.getArg());
+         }
+         if (optBatch.found())
+         {
+            batch = boost::lexical_cast<size_t>(optBatch.getArg());
+         }
+         if (optInterval.found())
+         {
+            const string& arg = optInterval.getArg();
+            size_t colon = arg.find(':');
+            interval = boost::lexical_cast<uint32_t>(arg.substr(0, colon));
+            kbytes = boost::lexical_cast<uint32_t>(arg.substr(colon + 1));
+         }
+      }
+      catch (exception&)
+      {
+         Exception ex(Exception::parameter(), WHERE__);
+         ex << "Illegal option value.";
+         throw ex;
+      }
+      if ((events == 0) || (batch == 0))
+      {
+         throw Exception(Exception::usage(), WHERE__);
+      }
+
+      const fs::path dir(optDir.getArg());
+      const double delay = getWriteBackDelay();
+      srand(time(0));
+
+      cout << events << " events in batches of " << batch << " events." << endl;
+      cout << setw(8) << left << "Log" << setw(16) << "Sync mode" << right
+           << setw(12) << "Events/s" << setw(12) << "MB/s"
+           << setw(16) << "Max loss bytes" << endl;
+
+      const t_durability none = {e_syncNone, 0, 0};
+      const t_durability group = {e_syncInterval, interval, kbytes * 1000};
+      const t_durability batchsync = {e_syncBatch, 0, 0};
+
+      ostringstream s;
+      s << interval << "ms:" << kbytes << "kB";
+      runMode(dir, "none", none, events, batch, delay);
+      runMode(dir, s.str(), group, events, batch, delay);
+      runMode(dir, "batch", batchsync, events, batch, delay);
+   }
+   catch (Exception& ex)
+   {
+      cerr << ex << endl;
+      if (ex.getErrCode() == Exception::usage().first)
+      {
+         cerr << endl;
+         usage(cmdname);
+      }
+      cerr << endl;
+      return ex.getErrCode();
+   }
+
+   return 0;
+}
@@ -0,0 +1,191 @@
+//----------------------------------------------------------------------------------------
+// Test of merging logs with and without CP time.
+// Events with a CP time are inserted into the ERROR log, and events without a CP time
+// into the SEL log, as the SEL task does. The logs are merged on AP time and on CP time,
+// all events must be read back, and the CP time text must be empty for the SEL events.
+//----------------------------------------------------------------------------------------
+
+#include <appendtask.h>
+#include <logmerger.h>
+#include <parameters.h>
+#include <cmdparser.h>
+#include <exception.h>
+#include <boost/filesystem.hpp>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+
+using namespace std;
+using namespace PES_CLH;
+
+namespace fs = boost::filesystem;
+
+//----------------------------------------------------------------------------------------
+// Log task writing to a test directory
+//----------------------------------------------------------------------------------------
+template<t_logtype logtype>
+class TestTask: public AppendTask
+{
+public:
+   TestTask(const fs::path& logdir):
+   AppendTask(),
+   m_parameters(),
+   m_logdir(logdir)
+   {
+   }
+
+   ~TestTask()
+   {
+   }
+
+   void event(const fs::path&) {}
+   const BaseParameters& getParameters() const {return m_parameters;}
+   fs::path getParentDir() const {return m_logdir.parent_path();}
+   fs::path getLogDir() const {return m_logdir;}
+   void createLogDir() const {fs::create_directories(m_logdir);}
+
+private:
+   void stream(ostream& s) const {s << "Log type: " << m_parameters.getLogName();}
+
+   Parameters<logtype> m_parameters;
+   fs::path m_logdir;
+};
+
+//----------------------------------------------------------------------------------------
+// Merge the logs and check the events
+//----------------------------------------------------------------------------------------
+bool runTest(
+      LogMerger::t_key key,
+      const AppendTask& errortask,
+      const AppendTask& seltask,
+      size_t count
+      )
+{
+   LogMerger merger(key);
+   merger.add(errortask, "ERROR");
+   merger.add(seltask, "SEL");
+
+   size_t found[2] = {0, 0};
+   size_t bad = 0;
+   for (bool valid = merger.seek(Period()); valid; valid = merger.next())
+   {
+      // The CP time text is formatted as for the merged log callback
+      const string& cptime = merger.getCPTimeText();
+      const size_t source = merger.getSource();
+      if (source == 0)
+      {
+         if (cptime != merger.getCPTime().get(Time::e_long))
+         {
+            bad++;
+         }
+      }
+      else if (cptime.empty() == false)
+      {
+         bad++;
+      }
+
+      ostringstream s;
+      printMergedEvent(
+            merger.getTag(),
+            merger.getCPTime(),
+            merger.getAPTime(),
+            merger.getSize(),
+            merger.getData(),
+            s
+            );
+      found[source]++;
+   }
+
+   const bool ok = (found[0] == count) && (found[1] == count) && (bad == 0);
+   cout << setw(10) << left << ((key == LogMerger::e_cptime)? "CP time": "AP time") << right
+        << setw(6) << found[0] << "/" << count << " ERROR"
+        << setw(6) << found[1] << "/" << count << " SEL"
+        << setw(6) << bad << " bad"
+        << (ok? "  OK": "  FAILED") << endl;
+   return ok;
+}
+
+//----------------------------------------------------------------------------------------
+// Usage
+//----------------------------------------------------------------------------------------
+void usage(const string& cmdname)
+{
+   cout << "Usage: " << cmdname << " -d dir" << endl;
+}
+
+//----------------------------------------------------------------------------------------
+// Main program
+//----------------------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+   const string& path = argv[0];
+   size_t pos = path.find_last_of('/') + 1;
+   const string& cmdname = path.substr(pos);
+
+   try
+   {
+      CmdParser::Optarg optDir("d");
+
+      CmdParser cmdparser(argc, argv);
+      cmdparser.fetchOpt(optDir);
+      cmdparser.check();
+
+      if (optDir.found() == false)
+      {
+         throw Exception(Exception::usage(), WHERE__);
+      }
+
+      const fs::path dir(optDir.getArg());
+      Parameters<e_error> errorparameters;
+      Parameters<e_sel> selparameters;
+      const fs::path& errordir = dir / errorparameters.getLogName();
+      const fs::path& seldir = dir / selparameters.getLogName();
+      fs::remove_all(errordir);
+      fs::remove_all(seldir);
+
+      TestTask<e_error> errortask(errordir);
+      errortask.createLogDir();
+      errortask.open();
+      TestTask<e_sel> seltask(seldir);
+      seltask.createLogDir();
+      seltask.open();
+
+      // Interleave the events, the SEL events have no CP time
+      const size_t count = 10;
+      for (size_t i = 0; i < count; i++)
+      {
+         ostringstream s;
+         s << "Event " << i << endl;
+         const string& str = s.str();
+         errortask.insert(Time::now(), str.c_str(), str.size());
+         seltask.insert(Time(), str.c_str(), str.size());
+      }
+
+      bool ok = runTest(LogMerger::e_aptime, errortask, seltask, count);
+      ok = runTest(LogMerger::e_cptime, errortask, seltask, count) && ok;
+
+      errortask.close();
+      seltask.close();
+      fs::remove_all(errordir);
+      fs::remove_all(seldir);
+
+      if (ok == false)
+      {
+         return 1;
+      }
+   }
+   catch (Exception& ex)
+   {
+      cerr << ex << endl;
+      if (ex.getErrCode() == Exception::usage().first)
+      {
+         cerr << endl;
+         usage(cmdname);
+      }
+      cerr << endl;
+      return ex.getErrCode();
+   }
+
+   return 0;
+}
@@ -0,0 +1,233 @@
+//----------------------------------------------------------------------------------------
+// Test of the event size limit of the append logs.
+// Events of exactly the max size are ingested into the ERROR and TRACE logs, mixed with
+// small events, and one event that is one byte too big into the ERROR log. All events
+// but the too big one must be read back with their sizes, and every subfile must hold
+// at least one event.
+//----------------------------------------------------------------------------------------
+
+#include <appendtask.h>
+#include <logcursor.h>
+#include <parameters.h>
+#include <cmdparser.h>
+#include <message.h>
+#include <exception.h>
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/regex.hpp>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <vector>
+#include <set>
+
+using namespace std;
+using namespace PES_CLH;
+
+namespace fs = boost::filesystem;
+
+//----------------------------------------------------------------------------------------
+// Log task writing to a test directory
+//----------------------------------------------------------------------------------------
+template<t_logtype logtype>
+class TestTask: public AppendTask
+{
+public:
+   TestTask(const fs::path& logdir):
+   AppendTask(),
+   m_parameters(),
+   m_logdir(logdir)
+   {
+   }
+
+   ~TestTask()
+   {
+   }
+
+   void event(const fs::path& path) {readMsgs(path);}
+   const BaseParameters& getParameters() const {return m_parameters;}
+   fs::path getParentDir() const {return m_logdir.parent_path();}
+   fs::path getLogDir() const {return m_logdir;}
+   void createLogDir() const {fs::create_directories(m_logdir);}
+
+private:
+   void stream(ostream& s) const {s << "Log type: " << m_parameters.getLogName();}
+
+   Parameters<logtype> m_parameters;
+   fs::path m_logdir;
+};
+
+//----------------------------------------------------------------------------------------
+// Create a temporary log file with events of the given sizes
+//----------------------------------------------------------------------------------------
+void createEvents(const fs::path& path, t_headertype headertype, const vector<size_t>& sizes)
+{
+   fs::ofstream fs(path, ios_base::binary | ios_base::trunc);
+   if (fs.is_open() == false)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to open file '" << path << "'.";
+      ex.sysError();
+      throw ex;
+   }
+
+   for (vector<size_t>::const_iterator iter = sizes.begin(); iter != sizes.end(); ++iter)
+   {
+      const uint64_t size = *iter;
+      const uint64_t time = Time::now();
+      if (headertype == e_tesrvHeader)
+      {
+         fs << TESRVMessage::s_headerTag << endl;
+         fs.write(reinterpret_cast<const char*>(&time), sizeof(uint64_t));
+         fs.write(reinterpret_cast<const char*>(&size), sizeof(uint64_t));
+         fs.put(0x0a);
+      }
+      else
+      {
+         fs.setf(ios::left, ios::adjustfield);
+         fs << CLHMessage::s_headerTag << endl;
+         ostringstream t;
+         t << time << endl;
+         fs << setw(18) << setfill(' ') << t.str();
+         ostringstream s;
+         s << size << endl;
+         fs << setw(14) << setfill(' ') << s.str();
+      }
+      for (size_t j = 0; j < size - 1; j++)
+      {
+         fs << ((j % 72)? 'X': '\n');
+      }
+      fs << endl;
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Run the test for one log
+//----------------------------------------------------------------------------------------
+template<t_logtype logtype>
+bool runTest(const fs::path& dir)
+{
+   Parameters<logtype> parameters;
+   const fs::path& logdir = dir / parameters.getLogName();
+   fs::remove_all(logdir);
+
+   TestTask<logtype> task(logdir);
+   task.createLogDir();
+   task.open();
+
+   // Max size events fill a subfile each, the small events must not leave a
+   // subfile without events
+   const size_t maxsize = AppendTask::getMaxEventSize();
+   vector<size_t> sizes;
+   sizes.push_back(maxsize);
+   sizes.push_back(maxsize);
+   sizes.push_back(1);
+   sizes.push_back(maxsize);
+
+   fs::path tmppath = logdir / parameters.getFilePrefix();
+   tmppath.replace_extension(".tmp");
+   createEvents(tmppath, parameters.getHeaderType(), sizes);
+   task.event(tmppath);
+
+   // The too big event is ignored. A TESRV file with a too big event is retained as
+   // an incomplete message file, it is not tested.
+   if (parameters.getHeaderType() != e_tesrvHeader)
+   {
+      createEvents(tmppath, parameters.getHeaderType(), vector<size_t>(1, maxsize + 1));
+      task.event(tmppath);
+   }
+
+   vector<size_t> more(2, 1);
+   createEvents(tmppath, parameters.getHeaderType(), more);
+   task.event(tmppath);
+
+   vector<size_t> expected(sizes);
+   expected.insert(expected.end(), more.begin(), more.end());
+
+   // Read back the events
+   vector<size_t> found;
+   set<size_t> files;
+   LogCursor cursor(task);
+   for (bool valid = cursor.seekFirst(); valid; valid = cursor.next())
+   {
+      found.push_back(cursor.getSize());
+      files.insert(cursor.getPosition().m_file);
+   }
+
+   // Count the subfiles
+   size_t subfiles = 0;
+   fs::directory_iterator end;
+   for (fs::directory_iterator iter(logdir); iter != end; ++iter)
+   {
+      if (regex_match(fs::path(*iter).filename().string(), parameters.getLogFile()))
+      {
+         subfiles++;
+      }
+   }
+
+   task.close();
+   fs::remove_all(logdir);
+
+   const bool ok = (found == expected) && (files.size() == subfiles);
+   cout << setw(8) << left << parameters.getLogName() << right
+        << setw(10) << found.size() << "/" << expected.size() << " events"
+        << setw(6) << files.size() << "/" << subfiles << " subfiles"
+        << (ok? "  OK": "  FAILED") << endl;
+   return ok;
+}
+
+//----------------------------------------------------------------------------------------
+// Usage
+//----------------------------------------------------------------------------------------
+void usage(const string& cmdname)
+{
+   cout << "Usage: " << cmdname << " -d dir" << endl;
+}
+
+//----------------------------------------------------------------------------------------
+// Main program
+//----------------------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+   const string& path = argv[0];
+   size_t pos = path.find_last_of('/') + 1;
+   const string& cmdname = path.substr(pos);
+
+   try
+   {
+      CmdParser::Optarg optDir("d");
+
+      CmdParser cmdparser(argc, argv);
+      cmdparser.fetchOpt(optDir);
+      cmdparser.check();
+
+      if (optDir.found() == false)
+      {
+         throw Exception(Exception::usage(), WHERE__);
+      }
+
+      const fs::path dir(optDir.getArg());
+      cout << "Max event size " << AppendTask::getMaxEventSize() << " bytes." << endl;
+
+      bool ok = runTest<e_error>(dir);
+      ok = runTest<e_trace>(dir) && ok;
+      if (ok == false)
+      {
+         return 1;
+      }
+   }
+   catch (Exception& ex)
+   {
+      cerr << ex << endl;
+      if (ex.getErrCode() == Exception::usage().first)
+      {
+         cerr << endl;
+         usage(cmdname);
+      }
+      cerr << endl;
+      return ex.getErrCode();
+   }
+
+   return 0;
+}
@@ -0,0 +1,188 @@
+//----------------------------------------------------------------------------------------
+// Microbenchmark for time stamp formatting.
+// Time stamps one millisecond apart are formatted in the plain, long and pretty formats,
+// like the time stamps of a sequence of log events. The reference is the formatting
+// with localtime_r, mktime and strftime for every time stamp. The results of the
+// reference and Time::format are compared.
+//----------------------------------------------------------------------------------------
+
+#include <ltime.h>
+#include <cmdparser.h>
+#include <exception.h>
+#include <boost/lexical_cast.hpp>
+#include <string>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <time.h>
+
+using namespace std;
+using namespace PES_CLH;
+
+//----------------------------------------------------------------------------------------
+// Get monotonic time in seconds
+//----------------------------------------------------------------------------------------
+double getTime()
+{
+   timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+//----------------------------------------------------------------------------------------
+// Reference formatting, one localtime_r, mktime and strftime per time stamp
+//----------------------------------------------------------------------------------------
+string refFormat(const timeval& tv, Time::t_format format)
+{
+   tm tmtime;
+   localtime_r(&tv.tv_sec, &tmtime);
+   tmtime.tm_isdst = -1;
+   mktime(&tmtime);
+
+   ostringstream s;
+   switch (format)
+   {
+   case Time::e_plain:
+      s << "%Y%m%d_%H%M%S";
+      break;
+
+   case Time::e_long:
+      s << "%Y%m%d_%H%M%S_" << setw(6) << setfill('0') << tv.tv_usec;
+      break;
+
+   default:
+      s << "%F  %T." << setw(3) << setfill('0') << tv.tv_usec / 1000 << "  %Z";
+      break;
+   }
+
+   char buf[64];
+   strftime(buf, sizeof(buf), s.str().c_str(), &tmtime);
+   return buf;
+}
+
+//----------------------------------------------------------------------------------------
+// Run the benchmark for one format
+//----------------------------------------------------------------------------------------
+void runFormat(
+      const string& name,
+      Time::t_format format,
+      int64_t start,
+      size_t count
+      )
+{
+   const int64_t step = 1000;          // One millisecond
+
+   // Reference
+   size_t refsize = 0;
+   double t0 = getTime();
+   for (size_t i = 0; i < count; i++)
+   {
+      const int64_t t = start + i * step;
+      const timeval tv = {static_cast<time_t>(t / 1000000), static_cast<suseconds_t>(t % 1000000)};
+      refsize += refFormat(tv, format).size();
+   }
+   const double reftime = getTime() - t0;
+
+   // Time::format
+   size_t size = 0;
+   char buf[Time::s_maxformat];
+   t0 = getTime();
+   for (size_t i = 0; i < count; i++)
+   {
+      size += Time(start + i * step).format(buf, format);
+   }
+   const double fasttime = getTime() - t0;
+
+   // Compare the results
+   size_t diffs = 0;
+   for (size_t i = 0; i < count; i += 997)
+   {
+      const int64_t t = start + i * step;
+      const timeval tv = {static_cast<time_t>(t / 1000000), static_cast<suseconds_t>(t % 1000000)};
+      if (Time(t).get(format) != refFormat(tv, format))
+      {
+         diffs++;
+      }
+   }
+
+   cout << setw(8) << left << name << right
+        << setw(14) << fixed << setprecision(0) << count / reftime
+        << setw(14) << count / fasttime
+        << setw(10) << setprecision(1) << reftime / fasttime
+        << setw(8) << diffs
+        << ((refsize == size)? "": "  (size differs)") << endl;
+}
+
+//----------------------------------------------------------------------------------------
+// Usage
+//----------------------------------------------------------------------------------------
+void usage(const string& cmdname)
+{
+   cout << "Usage: " << cmdname << " [-n timestamps] [-s YYYYMMDD]" << endl;
+}
+
+//----------------------------------------------------------------------------------------
+// Main program
+//----------------------------------------------------------------------------------------
+int main(int argc, const char* argv[])
+{
+   const string& path = argv[0];
+   size_t pos = path.find_last_of('/') + 1;
+   const string& cmdname = path.substr(pos);
+
+   try
+   {
+      CmdParser::Optarg optCount("n");
+      CmdParser::Optarg optStart("s");
+
+      CmdParser cmdparser(argc, argv);
+      cmdparser.fetchOpt(optCount);
+      cmdparser.fetchOpt(optStart);
+      cmdparser.check();
+
+      size_t count = 1000000;
+      try
+      {
+         if (optCount.found())
+         {
+            count = boost::lexical_cast<size_t>(optCount.getArg());
+         }
+      }
+      catch (exception&)
+      {
+         Exception ex(Exception::parameter(), WHERE__);
+         ex << "Illegal option value.";
+         throw ex;
+      }
+      if (count == 0)
+      {
+         throw Exception(Exception::usage(), WHERE__);
+      }
+
+      // Start time, default is now
+      const Time start = optStart.found()? Time(optStart.getArg(), "000000"): Time::now();
+
+      cout << count << " time stamps, one millisecond apart, from "
+           << Time::e_pretty << start << "." << endl;
+      cout << setw(8) << left << "Format" << right
+           << setw(14) << "Reference/s" << setw(14) << "Format/s"
+           << setw(10) << "Speedup" << setw(8) << "Diffs" << endl;
+
+      runFormat("plain", Time::e_plain, start, count);
+      runFormat("long", Time::e_long, start, count);
+      runFormat("pretty", Time::e_pretty, start, count);
+   }
+   catch (Exception& ex)
+   {
+      cerr << ex << endl;
+      if (ex.getErrCode() == Exception::usage().first)
+      {
+         cerr << endl;
+         usage(cmdname);
+      }
+      cerr << endl;
+      return ex.getErrCode();
+   }
+
+   return 0;
+}
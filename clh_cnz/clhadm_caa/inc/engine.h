@@ -47,15 +47,19 @@
 #include <seltask.h>
 #include <rptask.h>
 #include <inotify.h>
+#include <ingeststatus.h>
 #include <cpinfo.h>
 #include <acs_apbm_api.h>
 #include <boost/filesystem.hpp>
 #include <string>
 #include <map>
+#include <deque>
+#include <vector>
 #include <common.h>
 
 #include <boost/thread.hpp>
 #include <boost/thread/thread.hpp>
+#include <boost/scoped_ptr.hpp>
 #include <transfertask.h>
 
 namespace fs = boost::filesystem;
@@ -96,7 +100,8 @@ public:
          const std::string& logname,         // Log name
          uint32_t& maxsize,                  // Max size
          PES_CLH::Time& maxtime,             // Max time
-         uint16_t& divider                   // Divider value
+         uint16_t& divider,                  // Divider value
+         PES_CLH::t_durability& durability   // Durability policy
          );
 
    // Set log parameters read from the parameter handling table
@@ -161,9 +166,83 @@ private:
    // Subscribe for APBM trap events
    void apbmSubscribe();
 
-   // Create all log instances belonging to a CP identity
+   struct t_openjob;
+   typedef std::vector<t_openjob> OPENLIST;
+
+   // Create all log instances belonging to a CP identity, the logs are opened later
    void create(
-         const CPInfo& cpinfo
+         const CPInfo& cpinfo,
+         OPENLIST& openlist                  // Logs to open, the logs of the CP are added
+         );
+
+   struct t_openjob
+   {
+      BaseTask* m_taskp;                     // Log to open
+      std::string m_cpname;                  // CP the log belongs to
+      bool m_selap2;                         // Open as SEL log on AP2
+      bool m_sel;                            // Insert in list of CP SEL logs
+      CPKEY m_cpkey;                         // CP identity for SEL log
+      bool m_watch;                          // Add a file watch when opened
+      uint32_t m_mask;                       // File watch mask
+      std::string m_error;                   // Error message if open failed
+   };
+
+   struct t_cpopen
+   {
+      size_t m_count;                        // Number of logs to open
+      size_t m_done;                         // Number of finished opens
+      size_t m_opened;                       // Number of opened logs
+   };
+
+   typedef std::map<std::string, t_cpopen> CPOPENMAP;
+
+   struct t_openqueue
+   {
+      t_openqueue(): m_list(), m_next(0), m_donelist(), m_mutex(), m_fd(-1), m_threadgroup(),
+                     m_cpmap(), m_starttime(), m_done(0), m_opened(0) {}
+
+      OPENLIST m_list;                       // Jobs to run
+      size_t m_next;                         // Next job to start
+      std::deque<size_t> m_donelist;         // Finished jobs not yet registered
+      boost::mutex m_mutex;                  // Mutex
+      int m_fd;                              // Event file descriptor, signalled when a
+                                             // job is finished
+      boost::thread_group m_threadgroup;     // Worker threads
+
+      // Used by the engine thread only
+      CPOPENMAP m_cpmap;                     // Open progress for each CP
+      struct timespec m_starttime;           // Start of the startup
+      size_t m_done;                         // Number of finished opens
+      size_t m_opened;                       // Number of opened logs
+   };
+
+   // Create a job for opening a log
+   static t_openjob createOpenJob(
+         BaseTask* logtaskp,                 // Log to open
+         const std::string& cpname           // CP the log belongs to
+         );
+
+   // Start opening logs in parallel, each log is registered and its file watch added
+   // by handleOpenEvent as soon as it is opened
+   void startOpenLogs(
+         OPENLIST& openlist,                 // Logs to open, the list is emptied
+         const struct timespec& starttime    // Start of the startup
+         );
+
+   // Register the opened logs, called from the main loop
+   void handleOpenEvent();
+
+   // Stop opening logs, the opens running are finished and registered
+   void finishOpenLogs();
+
+   // Register an opened log
+   void registerLog(
+         size_t index                        // Job index
+         );
+
+   // Worker thread, open logs from the queue until it is empty
+   static void openWorker(
+         t_openqueue& queue                  // Job queue
          );
 
    // Insert entry in the log table
@@ -212,6 +291,7 @@ private:
    SelTask m_seltask;                        // System event log (SEL) task object
    SelTask m_selap2task;                     // Handle the non-cpub SEL log transferred from AP2.
    Inotify m_inotify;                        // File notification
+   IngestStatus m_ingest;                    // Ingest status for the transfers
    Common::ArchitectureValue m_architecture; // Node architecture
    SUBRACKMAP m_subracklist;                 // List of eGEM2 subracks
    acs_apbm_api m_apbm;                      // APBM instance
@@ -230,6 +310,8 @@ private:
    bool m_initiatedlogs;                     // Check if all logs are initiated
    bool m_cptablesubscribed;                 // Check if CP table is subscribed
    bool m_hwctablesubscribed;                // Check if HWC table is subscribed
+   boost::scoped_ptr<t_openqueue> m_openqueuep; // Logs being opened, null when all
+                                             // logs are registered
 
    static const std::string s_tesrv;
    static const std::string s_tracelog_cpa;
@@ -237,6 +319,7 @@ private:
    static const std::string s_tesrv_cpa;
    static const std::string s_tesrv_cpb;
    static bool stoppoint;                    // Check if CLH needs to be stopped in startup phase
+   static const size_t s_maxopenthreads;     // Max number of threads opening logs
    bool m_isAPZ21240_21250;
 };
 
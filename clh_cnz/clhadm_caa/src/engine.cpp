@@ -57,6 +57,7 @@
 #include <sys/select.h>
 #include <sys/eventfd.h>
 #include <sys/timerfd.h>
+#include <time.h>
 #include <boost/bind.hpp>
 #include <ACS_CS_API.h>
 #include <mausinfo.h>
@@ -72,6 +73,7 @@ const string Engine::s_tesrv_cpa = "/data/cps/logs/tesrv/cpa";
 const string Engine::s_tesrv_cpb = "/data/cps/logs/tesrv/cpb";
 
 bool Engine::stoppoint = false;
+const size_t Engine::s_maxopenthreads = 8;
 
 //----------------------------------------------------------------------------------------
 // Constructor
@@ -84,6 +86,7 @@ m_seltasklist(),
 m_seltask(),
 m_selap2task(),
 m_inotify(),
+m_ingest(),
 m_architecture(),
 m_apbm(),
 m_errorcount(0),
@@ -113,13 +116,16 @@ Engine::~Engine()
 }
 
 //----------------------------------------------------------------------------------------
-// Read log parameters from the parameter handling table
+// Read log parameters from the parameter handling table.
+// Format: maxsize,hours[:minutes],divider[,durability]
+// where durability is 'none', 'batch' or milliseconds:kbytes between syncs.
 //----------------------------------------------------------------------------------------
 bool Engine::getLogParameters(
                   const string& logname,
                   uint32_t& maxsize,
                   Time& maxtime,
-                  uint16_t& divider
+                  uint16_t& divider,
+                  t_durability& durability
                   )
 {
    acs_apgcc_paramhandling par;
@@ -151,6 +157,8 @@ bool Engine::getLogParameters(
 
    uint32_t hours;
    uint16_t minutes(0);
+   unsigned long interval(0);
+   unsigned long kbytes(0);
    try
    {
       // Parse maxsize
@@ -185,6 +193,37 @@ bool Engine::getLogParameters(
       divider = static_cast<uint16_t>(strtoul(ptr, &ptr1, 10));
       if (ptr == ptr1) throw ptr;
       ptr = ptr1 + strspn(ptr1, s_space);
+
+      // Parse optional durability policy
+      durability.m_mode = e_syncNone;
+      durability.m_interval = 0;
+      durability.m_size = 0;
+      if (*ptr == ',')
+      {
+         ptr++;
+         ptr += strspn(ptr, s_space);
+         size_t len = strcspn(ptr, s_space);
+         if ((len == 4) && (strncmp(ptr, "none", len) == 0))
+         {
+            ptr1 = ptr + len;
+         }
+         else if ((len == 5) && (strncmp(ptr, "batch", len) == 0))
+         {
+            durability.m_mode = e_syncBatch;
+            ptr1 = ptr + len;
+         }
+         else
+         {
+            if (!isdigit(*ptr)) throw ptr;
+            durability.m_mode = e_syncInterval;
+            interval = strtoul(ptr, &ptr1, 10);
+            if (*ptr1 != ':') throw ptr;
+            ptr = ptr1 + 1;
+            if (!isdigit(*ptr)) throw ptr;
+            kbytes = strtoul(ptr, &ptr1, 10);
+         }
+         ptr = ptr1 + strspn(ptr1, s_space);
+      }
       if (*ptr != 0) throw ptr;
 
       free(tstr);
@@ -254,6 +293,24 @@ bool Engine::getLogParameters(
       return false;
    }
 
+   // Validate durability, max one hour or 1000000 kbytes between syncs
+   if ((durability.m_mode == e_syncInterval) &&
+       ((interval < 1) || (interval > 3600000) || (kbytes < 1) || (kbytes > 1000000)))
+   {
+      ostringstream s;
+      s << "Error detected when parsing string for parameter '" << logname << "'."
+        << endl;
+      s << "Durability value incorrect.";
+      Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
+
+      // Report to event handler
+      EventHandler::send(Exception::parameter().first, s.str());
+
+      return false;
+   }
+   durability.m_interval = interval;
+   durability.m_size = kbytes * 1000;
+
    return true;
 }
 
@@ -265,6 +322,7 @@ void Engine::setLogParameters()
    uint32_t maxsize;
    Time maxtime;
    uint16_t divider;
+   t_durability durability;
    bool ok;
 
    LogTable logtable;
@@ -278,11 +336,13 @@ void Engine::setLogParameters()
       if (!parameters.getLogFile().str().empty())
       {
          // Read log parameters
-         ok = getLogParameters(parameters.getLogName(), maxsize, maxtime, divider);
+         ok = getLogParameters(parameters.getLogName(), maxsize, maxtime, divider,
+               durability);
          if (ok)
          {
             // Set log parameters
             parameters.setParameters(maxsize, maxtime, divider);
+            parameters.setDurability(durability);
          }
       }
    }
@@ -344,6 +404,13 @@ void Engine::initiateLogs()
    bool sellogging = false;
    bool rplogging = false;
 
+   // The logs of all CPs are created first and then opened in parallel, the main loop
+   // handles events for each log as soon as it is opened
+   struct timespec starttime;
+   clock_gettime(CLOCK_MONOTONIC, &starttime);
+   OPENLIST openlist;
+   boost::thread_group cleanupgroup;
+
    if (m_cptable.isMultiCPSystem() == false)
    {
       // One CP system
@@ -353,7 +420,7 @@ void Engine::initiateLogs()
       const CPInfo &cpinfo = m_cptable.get();
       try
       {
-         create(cpinfo);
+         create(cpinfo, openlist);
       }
       catch (Exception& ex)
       {
@@ -406,11 +473,10 @@ void Engine::initiateLogs()
          // Multi CP system
          Logger::event(LOG_LEVEL_INFO, WHERE__, "A multi CP system was detected.");
 
-         // Remove CLH directories that are not used
-         cleanupLogDir(apzpath);
-
-         // Remove TESRV directories that are not used
-         cleanupLogDir(cpspath);
+         // Remove CLH and TESRV directories that are not used, while the logs are
+         // created and opened. Only directories of other CPs are removed.
+         cleanupgroup.create_thread(boost::bind(&Engine::cleanupLogDir, this, apzpath));
+         cleanupgroup.create_thread(boost::bind(&Engine::cleanupLogDir, this, cpspath));
 
          for (CPTable::const_iterator iter = m_cptable.begin();
               iter != m_cptable.end();
@@ -432,7 +498,7 @@ void Engine::initiateLogs()
             // Create a list of all log entries
             try
             {
-               create(cpinfo);
+               create(cpinfo, openlist);
             }
             catch (Exception& ex)
             {
@@ -448,6 +514,11 @@ void Engine::initiateLogs()
       sellogging = true;
    }
 
+   // Start opening the logs of all CPs, the main loop registers each log and adds its
+   // file watch when it is opened
+   startOpenLogs(openlist, starttime);
+   cleanupgroup.join_all();
+
    if (sellogging)
    {
       // Initiate System Event Logs (SEL)
@@ -708,6 +779,9 @@ void Engine::execute()
       Logger::event(LOG_LEVEL_INFO, WHERE__, s.str());
    }
 
+   // Publish the ingest status, transfers back off when the temporary files queue up
+   m_ingest.create();
+
    // Here is the main loop for processing the logs
    int errorlevel(0);
    eventfd_t runstate;
@@ -760,6 +834,12 @@ void Engine::execute()
          {
 
             fd_set fds = m_fds;
+            if (m_openqueuep && (m_trapfd != -1))
+            {
+               // The traps are read when all logs are registered, the SEL log of
+               // the CP must be found
+               FD_CLR(m_trapfd, &fds);
+            }
 
             // Wait for an event
             int ret = select(m_maxfd + 1, &fds, NULL, NULL, NULL);
@@ -779,6 +859,12 @@ void Engine::execute()
                }
             }
 
+            if (m_openqueuep && FD_ISSET(m_openqueuep->m_fd, &fds))
+            {
+               // Register the opened logs
+               handleOpenEvent();
+            }
+
             if (FD_ISSET(m_inotifyfd, &fds))
             {
 
@@ -924,6 +1010,9 @@ void Engine::execute()
 
       try
       {
+         // Stop opening logs
+         finishOpenLogs();
+
          // Terminiate transfer thread
          if (m_runningap == Common::AP2 && m_enableselap2 && !needretry)
          {
@@ -986,7 +1075,7 @@ void Engine::execute()
 //----------------------------------------------------------------------------------------
 // Create all log instances belonging to a CP identity
 //----------------------------------------------------------------------------------------
-void Engine::create(const CPInfo& cpinfo)
+void Engine::create(const CPInfo& cpinfo, OPENLIST& openlist)
 {
    CPID cpid = cpinfo.getCPID();
    t_mauType mauType = e_mauundefined;
@@ -1073,19 +1162,11 @@ void Engine::create(const CPInfo& cpinfo)
                if (logtype == e_sel)
                {
                   logtaskp->createLogDir();                 // Create log directory
-                  if (m_runningap == Common::AP1)
-                  {
-                     logtaskp->open();                      // Open log
-                  }
-                  else
-                  {
-                     logtaskp->openSELAP2();
-                  }
 
-                  // Insert in list of CP SEL logs
-                  CPKEY cpkey(cpid, cpside);
-                  Sel* const seltaskp = dynamic_cast<Sel*>(logtaskp);
-                  m_seltasklist.insert(SELTASKLIST::value_type(cpkey, seltaskp));
+                  t_openjob job = createOpenJob(logtaskp, cpname);
+                  job.m_selap2 = (m_runningap != Common::AP1);
+                  job.m_sel = true;
+                  job.m_cpkey = CPKEY(cpid, cpside);
 
                   if (m_hascp2)
                   {
@@ -1095,24 +1176,12 @@ void Engine::create(const CPInfo& cpinfo)
                         const string& cp2name = "cp2";
                         if (cpname.compare(cp2name) == 0)
                         {
-                           const fs::path& logdir = logtaskp->getLogDir();
-                           // Log event
-                           Logger logger(LOG_LEVEL_INFO);
-                           if (logger)
-                           {
-                              ostringstream s;
-                              s << "Directory " << logdir << " are being monitored.";
-                              logger.event(WHERE__, s.str());
-                           }
-                           uint32_t mask;
-                           mask = IN_CLOSE_WRITE;
-                           int hwatcht = m_inotify.addWatch(logdir.c_str(), mask);
-
-                           // Insert in list of CP logs
-                           m_cptasklist[hwatcht] = logtaskp;
+                           job.m_watch = true;
+                           job.m_mask = IN_CLOSE_WRITE;
                         }
                      }
                   }
+                  openlist.push_back(job);
                }
                else
                {
@@ -1129,28 +1198,24 @@ void Engine::create(const CPInfo& cpinfo)
                   // Add a file watch
                   if (m_runningap == Common::AP1)
                   {
-                     logtaskp->open();                      // Open log
-                     const fs::path& logdir = logtaskp->getLogDir();
-                     uint32_t mask;
+                     t_openjob job = createOpenJob(logtaskp, cpname);
+                     job.m_watch = true;
                      if (dynamic_cast<DirTask*>(logtaskp))
                      {
-                        mask = IN_CREATE | IN_ISDIR;
+                        job.m_mask = IN_CREATE | IN_ISDIR;
                      }
                      else
                      {
                         if (logtype != e_xpucore)
                         {
-                           mask = IN_CLOSE_WRITE;
+                           job.m_mask = IN_CLOSE_WRITE;
                         }
                         else
                         {
-                           mask = IN_MOVED_TO;
+                           job.m_mask = IN_MOVED_TO;
                         }
                      }
-                     int hwatch = m_inotify.addWatch(logdir.c_str(), mask);
-
-                     // Insert in list of CP logs
-                     m_cptasklist[hwatch] = logtaskp;
+                     openlist.push_back(job);
                   }
                }
             }
@@ -1181,22 +1246,19 @@ void Engine::create(const CPInfo& cpinfo)
 
                   swmau.setPath(fullpath.string());
                   BaseTask* const logtaskp = createTask(logtype, cpinfo, swmau);
-                  const fs::path& logdir = logtaskp->getLogDir();
                   logtaskp->createLogDir();
-                  logtaskp->open();                      // Open log
-                  uint32_t mask;
+
+                  t_openjob job = createOpenJob(logtaskp, cpname);
+                  job.m_watch = true;
                   if (logtype != e_mcore)
                   {
-                     mask = IN_CLOSE_WRITE;
+                     job.m_mask = IN_CLOSE_WRITE;
                   }
                   else
                   {
-                     mask = IN_MOVED_TO;
+                     job.m_mask = IN_MOVED_TO;
                   }
-                  int hwatch = m_inotify.addWatch(logdir.c_str(), mask);
-
-                  // Insert in list of CP logs
-                  m_cptasklist[hwatch] = logtaskp;
+                  openlist.push_back(job);
                }
             }
          }
@@ -1204,6 +1266,305 @@ void Engine::create(const CPInfo& cpinfo)
    }
 }
 
+//----------------------------------------------------------------------------------------
+// Create a job for opening a log
+//----------------------------------------------------------------------------------------
+Engine::t_openjob Engine::createOpenJob(BaseTask* logtaskp, const string& cpname)
+{
+   t_openjob job;
+   job.m_taskp = logtaskp;
+   job.m_cpname = cpname;
+   job.m_selap2 = false;
+   job.m_sel = false;
+   job.m_cpkey = CPKEY();
+   job.m_watch = false;
+   job.m_mask = 0;
+   job.m_error.clear();
+   return job;
+}
+
+//----------------------------------------------------------------------------------------
+// Start opening logs in parallel, each log is registered and its file watch added by
+// handleOpenEvent as soon as it is opened
+//----------------------------------------------------------------------------------------
+void Engine::startOpenLogs(OPENLIST& openlist, const struct timespec& starttime)
+{
+   m_openqueuep.reset(new t_openqueue());
+   t_openqueue& queue = *m_openqueuep;
+   queue.m_list.swap(openlist);
+   queue.m_starttime = starttime;
+   for (OPENLIST::const_iterator iter = queue.m_list.begin();
+        iter != queue.m_list.end();
+        ++iter)
+   {
+      t_cpopen& cpopen = queue.m_cpmap[iter->m_cpname];
+      cpopen.m_count++;
+   }
+
+   if (queue.m_list.empty())
+   {
+      finishOpenLogs();
+      return;
+   }
+
+   // The workers signal each finished open to the main loop
+   queue.m_fd = eventfd(0, EFD_NONBLOCK);
+   if (queue.m_fd == -1)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to create event notification.";
+      ex.sysError();
+      throw ex;
+   }
+   FD_SET(queue.m_fd, &m_fds);
+   m_maxfd = std::max(queue.m_fd, m_maxfd);
+
+   // Bounded number of worker threads
+   size_t maxthreads = boost::thread::hardware_concurrency();
+   if (maxthreads > s_maxopenthreads)
+   {
+      maxthreads = s_maxopenthreads;
+   }
+   if (maxthreads == 0)
+   {
+      maxthreads = 1;
+   }
+   if (maxthreads > queue.m_list.size())
+   {
+      maxthreads = queue.m_list.size();
+   }
+
+   for (size_t i = 0; i < maxthreads; i++)
+   {
+      queue.m_threadgroup.create_thread(boost::bind(&Engine::openWorker, boost::ref(queue)));
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Register the opened logs, called from the main loop
+//----------------------------------------------------------------------------------------
+void Engine::handleOpenEvent()
+{
+   if (!m_openqueuep)
+   {
+      return;
+   }
+   t_openqueue& queue = *m_openqueuep;
+
+   eventfd_t count;
+   eventfd_read(queue.m_fd, &count);
+
+   // Register the logs in the order the opens finish
+   while (true)
+   {
+      size_t index;
+      {
+         boost::mutex::scoped_lock lock(queue.m_mutex);
+         if (queue.m_donelist.empty())
+         {
+            break;
+         }
+         index = queue.m_donelist.front();
+         queue.m_donelist.pop_front();
+      }
+      registerLog(index);
+   }
+
+   if (queue.m_done == queue.m_list.size())
+   {
+      finishOpenLogs();
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Stop opening logs, the opens running are finished and registered
+//----------------------------------------------------------------------------------------
+void Engine::finishOpenLogs()
+{
+   if (!m_openqueuep)
+   {
+      return;
+   }
+   t_openqueue& queue = *m_openqueuep;
+
+   // No new opens are started
+   size_t started;
+   {
+      boost::mutex::scoped_lock lock(queue.m_mutex);
+      started = queue.m_next;
+      queue.m_next = queue.m_list.size();
+   }
+   queue.m_threadgroup.join_all();
+
+   for (deque<size_t>::const_iterator iter = queue.m_donelist.begin();
+        iter != queue.m_donelist.end();
+        ++iter)
+   {
+      try
+      {
+         registerLog(*iter);
+      }
+      catch (Exception& ex)
+      {
+         // Failed to add the file watch
+         Logger::event(LOG_LEVEL_WARN, WHERE__, ex.getMessage());
+      }
+   }
+   queue.m_donelist.clear();
+
+   // The logs that were never opened are not registered
+   for (size_t index = started; index < queue.m_list.size(); index++)
+   {
+      delete queue.m_list[index].m_taskp;
+   }
+
+   if (queue.m_fd != -1)
+   {
+      FD_CLR(queue.m_fd, &m_fds);
+      close(queue.m_fd);
+   }
+
+   struct timespec stoptime;
+   clock_gettime(CLOCK_MONOTONIC, &stoptime);
+   {
+      // Log event
+      const long msec = (stoptime.tv_sec - queue.m_starttime.tv_sec) * 1000 +
+                        (stoptime.tv_nsec - queue.m_starttime.tv_nsec) / 1000000;
+      ostringstream s;
+      s << "Startup of all logs took " << msec << " ms, " << queue.m_opened << " of "
+        << queue.m_list.size() << " log(s) were opened.";
+      Logger::event(LOG_LEVEL_INFO, WHERE__, s.str());
+   }
+   m_openqueuep.reset();
+}
+
+//----------------------------------------------------------------------------------------
+// Register an opened log
+//----------------------------------------------------------------------------------------
+void Engine::registerLog(size_t index)
+{
+   t_openqueue& queue = *m_openqueuep;
+   const t_openjob& job = queue.m_list[index];
+   t_cpopen& cpopen = queue.m_cpmap[job.m_cpname];
+   queue.m_done++;
+   cpopen.m_done++;
+
+   if (job.m_error.empty() == false)
+   {
+      // Failed to open
+      Logger::event(LOG_LEVEL_WARN, WHERE__, job.m_error);
+   }
+   else if (Engine::checkStopPoint() == false)
+   {
+      BaseTask* const logtaskp = job.m_taskp;
+      if (job.m_sel)
+      {
+         // Insert in list of CP SEL logs
+         Sel* const seltaskp = dynamic_cast<Sel*>(logtaskp);
+         m_seltasklist.insert(SELTASKLIST::value_type(job.m_cpkey, seltaskp));
+      }
+
+      if (job.m_watch)
+      {
+         const fs::path& logdir = logtaskp->getLogDir();
+         if (job.m_sel)
+         {
+            // Log event
+            Logger logger(LOG_LEVEL_INFO);
+            if (logger)
+            {
+               ostringstream s;
+               s << "Directory " << logdir << " are being monitored.";
+               logger.event(WHERE__, s.str());
+            }
+         }
+         int hwatch = m_inotify.addWatch(logdir.c_str(), job.m_mask);
+
+         // Insert in list of CP logs
+         m_cptasklist[hwatch] = logtaskp;
+      }
+      queue.m_opened++;
+      cpopen.m_opened++;
+   }
+
+   if (cpopen.m_done == cpopen.m_count)
+   {
+      // The last log of the CP is opened
+      struct timespec stoptime;
+      clock_gettime(CLOCK_MONOTONIC, &stoptime);
+      Logger logger(LOG_LEVEL_INFO);
+      if (logger)
+      {
+         const long msec = (stoptime.tv_sec - queue.m_starttime.tv_sec) * 1000 +
+                           (stoptime.tv_nsec - queue.m_starttime.tv_nsec) / 1000000;
+         ostringstream s;
+         s << "Startup ";
+         if (job.m_cpname.empty() == false)
+         {
+            s << "for CP '" << boost::to_upper_copy(job.m_cpname) << "' ";
+         }
+         s << "took " << msec << " ms, " << cpopen.m_opened << " of " << cpopen.m_count
+           << " log(s) were opened.";
+         logger.event(WHERE__, s.str());
+      }
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Worker thread, open logs from the queue until it is empty
+//----------------------------------------------------------------------------------------
+void Engine::openWorker(t_openqueue& queue)
+{
+   while (true)
+   {
+      size_t index;
+      {
+         boost::mutex::scoped_lock lock(queue.m_mutex);
+         if (queue.m_next == queue.m_list.size())
+         {
+            return;
+         }
+         index = queue.m_next++;
+      }
+      t_openjob* const jobp = &queue.m_list[index];
+
+      string error;
+      if (Engine::checkStopPoint() == false)
+      {
+         try
+         {
+            if (jobp->m_selap2)
+            {
+               jobp->m_taskp->openSELAP2();
+            }
+            else
+            {
+               jobp->m_taskp->open();           // Open log
+            }
+         }
+         catch (Exception& ex)
+         {
+            error = ex.getMessage();
+         }
+         catch (std::exception& ex)
+         {
+            error = ex.what();
+         }
+         catch (...)
+         {
+            error = "Unknown exception while opening log.";
+         }
+      }
+
+      {
+         boost::mutex::scoped_lock lock(queue.m_mutex);
+         jobp->m_error = error;
+         queue.m_donelist.push_back(index);
+      }
+      eventfd_write(queue.m_fd, 1);
+   }
+}
+
 //----------------------------------------------------------------------------------------
 // Handle a CP log event
 //----------------------------------------------------------------------------------------
@@ -1268,7 +1629,9 @@ void Engine::handleCPEvent()
 
             if (boost::regex_match(file, logtaskp->getParameters().getTempFile()))
             {
+               m_ingest.startEvent(path);
                m_selap2task.readMsgs(path);
+               m_ingest.endEvent();
                isDone = true;
             }
          }
@@ -1289,7 +1652,9 @@ void Engine::handleCPEvent()
             if (!isDone)
             {
                // A valid temp. log file - process it
+               m_ingest.startEvent(path);
                logtaskp->event(path);
+               m_ingest.endEvent();
             }
          }
          else
@@ -1371,11 +1736,13 @@ void Engine::handleCPEvent()
    }
    catch (Exception& ex)
    {
+      m_ingest.endEvent();
       m_errorcount++;
       Logger::event(ex);
    }
    catch (std::exception& e)
    {
+      m_ingest.endEvent();
       m_errorcount++;
       // Boost exception
       Exception ex(Exception::system(), WHERE__);
@@ -41,6 +41,7 @@
 #include <string>
 #include <string.h>
 #include <stdlib.h>
+#include <stdint.h>
 
 enum desttype_t
 {
@@ -62,12 +63,43 @@ public:
 
    // Callback for log messages
    typedef void (*t_eventcb)(
-         const char* cptime,               // CP time, format is "YYYYMMDD_HHmmss_uuuuuu"
+         const char* cptime,               // CP time, format is "YYYYMMDD_HHmmss_uuuuuu",
+                                           // empty if the event has no CP time
          const char* aptime,               // AP time, format is "YYYYMMDD_HHmmss"
          size_t size,                      // Message size
          const char* evmsg                 // Log message
          );
 
+   // Callback for merged log messages
+   typedef void (*t_mergedeventcb)(
+         const char* tag,                  // Log name, followed by "/A" or "/B" if both CP sides
+                                           // are read
+         const char* cptime,               // CP time, format is "YYYYMMDD_HHmmss_uuuuuu",
+                                           // empty if the event has no CP time
+         const char* aptime,               // AP time, format is "YYYYMMDD_HHmmss"
+         size_t size,                      // Message size
+         const char* evmsg                 // Log message
+         );
+
+   // Log event, delivered in batches to the event batch callback
+   struct t_event
+   {
+      int64_t cptime;                      // CP time, microseconds since 1970-01-01 00:00 UTC.
+                                           // s_notime if the event has no CP time.
+      int64_t aptime;                      // AP time, microseconds since 1970-01-01 00:00 UTC
+      size_t size;                         // Message size
+      const char* evmsg;                   // Log message
+   };
+
+   // Callback for batches of log events
+   typedef bool (*t_eventbatchcb)(         // Returns false to stop reading
+         void* context,                    // User context given in the read call
+         const t_event* events,            // Events, valid until the callback returns
+         size_t count                      // Number of events, at least one
+         );
+
+   static const int64_t s_notime;          // Time value for a missing time
+
    // Read trace log, receive events in the callback, the call is blocked until all data
    // has been received 
    int readLog(                           // Returns 0 for successful operation. See description for
@@ -112,6 +144,101 @@ public:
       return res;
    }
 
+   // Read trace log, receive the events in batches in the callback, oldest event first.
+   // The call is blocked until all data has been received or the callback returns false.
+   // The call may be made concurrently from several threads, also on the same object.
+   int readLogEvents(                     // Returns 0 for successful operation. See error handling
+                                          // for possible error codes.
+         const std::string& cpname,       // CP name, for a one CP system an empty string is provided
+         const std::string& cpside,       // CP side, "A" or "B" for a one CP system or SPX and an
+                                          // empty string for a single sided CP (blade).
+         const std::string& startdate,    // Start date
+         const std::string& starttime,    // Start time
+         const std::string& stopdate,     // Stop date
+         const std::string& stoptime,     // Stop time
+         t_eventbatchcb eventcb,          // Call back method
+         void* context                    // User context, passed to the call back method
+         ) const
+   {
+      return readLogEvents_p(
+                           cpname.c_str(),
+                           cpside.c_str(),
+                           startdate.c_str(),
+                           starttime.c_str(),
+                           stopdate.c_str(),
+                           stoptime.c_str(),
+                           eventcb,
+                           context
+                           );
+   }
+
+   // Read trace log events committed since a previous call. The events are received in
+   // batches in the callback, oldest event first. The call is blocked until all new data
+   // has been received or the callback returns false. A poll with the returned token
+   // only reads the events added since the token was returned.
+   int readLogEventsSince(                // Returns 0 for successful operation. See error handling
+                                          // for possible error codes.
+         const std::string& cpname,       // CP name, for a one CP system an empty string is provided
+         const std::string& cpside,       // CP side, "A" or "B" for a one CP system or SPX and an
+                                          // empty string for a single sided CP (blade).
+         const std::string& startdate,    // Start date, used if the token is empty
+         const std::string& starttime,    // Start time, used if the token is empty
+         std::string& token,              // Resume token, an empty string for the first call.
+                                          // Returns the token for the next call, the token is
+                                          // unchanged if there are no new events. The token
+                                          // is opaque and names the last event received.
+         t_eventbatchcb eventcb,          // Call back method
+         void* context                    // User context, passed to the call back method
+         ) const
+   {
+      char* ttoken = strdup(token.c_str());
+
+      int res = readLogEventsSince_p(
+                           cpname.c_str(),
+                           cpside.c_str(),
+                           startdate.c_str(),
+                           starttime.c_str(),
+                           ttoken,
+                           eventcb,
+                           context
+                           );
+
+      token = ttoken;
+      free(ttoken);
+
+      return res;
+   }
+
+   // Read several logs of a CP merged in time order, oldest event first. The events are
+   // received in the callback, the call is blocked until all data has been received
+   int readMergedLogs(                    // Returns 0 for successful operation. See error handling
+                                          // for possible error codes.
+         const std::string& cpname,       // CP name, for a one CP system an empty string is provided
+         const std::string& cpside,       // CP side, "A" or "B". An empty string for both CP sides
+                                          // or for a single sided CP (blade).
+         const std::string& logs,         // Comma separated list of log names, e.g. "ERROR,SYSLOG".
+                                          // An empty string for all logs.
+         const std::string& startdate,    // Start date
+         const std::string& starttime,    // Start time
+         const std::string& stopdate,     // Stop date
+         const std::string& stoptime,     // Stop time
+         bool cptimeorder,                // true to merge on CP time, false to merge on AP time
+         t_mergedeventcb eventcb          // Call back method
+         ) const
+   {
+      return readMergedLogs_p(
+                           cpname.c_str(),
+                           cpside.c_str(),
+                           logs.c_str(),
+                           startdate.c_str(),
+                           starttime.c_str(),
+                           stopdate.c_str(),
+                           stoptime.c_str(),
+                           cptimeorder,
+                           eventcb
+                           );
+   }
+
    // Transfer logs to a destination
    int transferLogs(                      // Returns 0 for successful operation. See error handling
                                           // for possible error codes.
@@ -135,6 +262,29 @@ public:
                            );
    }
 
+   // Transfer what was added to the logs since the last incremental transfer.
+   // Each log continues after the last event or file of the previous incremental
+   // transfer, the first one transfers the whole period.
+   int transferLogsSince(                 // Returns 0 for successful operation. See error handling
+                                          // for possible error codes.
+         const std::string& cpname,       // CP name, as for transferLogs
+         const std::string& startdate,    // Start date
+         const std::string& starttime,    // Start time
+         const std::string& stopdate,     // Stop date
+         const std::string& stoptime,     // Stop time
+          desttype_t desttype             // Destination type.
+         ) const
+   {
+      return transferLogsSince_p(
+                           cpname.c_str(),
+                           startdate.c_str(),
+                           starttime.c_str(),
+                           stopdate.c_str(),
+                           stoptime.c_str(),
+                           desttype
+                           );
+   }
+
    // Following table shows legal string values for the start and stop dates/times
    // and the resulting start and stop times
 
@@ -160,7 +310,7 @@ public:
    // | ""         | ""         | 9999-12-31 23:59:59.999999 |
    // +============+============+============================+
 
-   // Get error text for previous call
+   // Get error text for previous call in the calling thread
    std::string getErrorText() const
    {
       return getErrorText_p();
@@ -180,7 +330,11 @@ public:
    // 100          Parameter error
    // 101          System error
    // 102          Internal error
+   //  26          Illegal log type.
+   //  27          Log type not valid for this APZ type.
+   // 115          Illegal command in this system configuration.
    // 118          CP is not defined.
+   // 122          APZ system value is not defined.
 
 private:
    Pes_clhapi(const Pes_clhapi&);
@@ -196,6 +350,39 @@ private:
          Pes_clhapi::t_eventcb eventcb
          ) const;
 
+   int readLogEvents_p(
+         const char* cpname,
+         const char* cpside,
+         const char* startdate,
+         const char* starttime,
+         const char* stopdate,
+         const char* stoptime,
+         Pes_clhapi::t_eventbatchcb eventcb,
+         void* context
+         ) const;
+
+   int readLogEventsSince_p(
+         const char* cpname,
+         const char* cpside,
+         const char* startdate,
+         const char* starttime,
+         char* &token,
+         Pes_clhapi::t_eventbatchcb eventcb,
+         void* context
+         ) const;
+
+   int readMergedLogs_p(
+         const char* cpname,
+         const char* cpside,
+         const char* logs,
+         const char* startdate,
+         const char* starttime,
+         const char* stopdate,
+         const char* stoptime,
+         bool cptimeorder,
+         Pes_clhapi::t_mergedeventcb eventcb
+         ) const;
+
    int transferLogs_p(
          const char* cpname,
          const char* startdate,
@@ -205,6 +392,15 @@ private:
          desttype_t desttype
          ) const;
 
+   int transferLogsSince_p(
+         const char* cpname,
+         const char* startdate,
+         const char* starttime,
+         const char* stopdate,
+         const char* stoptime,
+         desttype_t desttype
+         ) const;
+
    const char* getErrorText_p() const;
 
    PES_CLH::Api_impl* m_apiptr;           // Pointer to implementation class
@@ -41,8 +41,11 @@
 #include "pes_clhapi.h"
 #include <ltime.h>
 #include <cpinfo.h>
+#include <logcursor.h>
 #include <boost/filesystem.hpp>
+#include <boost/thread/tss.hpp>
 #include <string>
+#include <vector>
 
 namespace fs = boost::filesystem;
 
@@ -72,6 +75,47 @@ public:
          Pes_clhapi::t_eventcb eventcb    // Call back method.
          );
 
+   // Read trace log, receive the events in batches in the callback, the call is blocked
+   // until all data has been received
+   int readLogEvents(
+         const std::string& cpname,       // CP name, for a one CP system an empty string is provided
+         const std::string& cpside,       // CP side, "A" or "B" for a one CP system or SPX and an
+                                          // empty string for a single sided CP system.
+         const char* startdate,           // Start date
+         const char* starttime,           // Start time
+         const char* stopdate,            // Stop date
+         const char* stoptime,            // Stop time
+         Pes_clhapi::t_eventbatchcb eventcb, // Call back method.
+         void* context                    // User context
+         );
+
+   // Read trace log events committed since a previous call, receive the events in
+   // batches in the callback, the call is blocked until all new data has been received
+   int readLogEventsSince(
+         const std::string& cpname,       // CP name, for a one CP system an empty string is provided
+         const std::string& cpside,       // CP side, "A" or "B" for a one CP system or SPX and an
+                                          // empty string for a single sided CP system.
+         const char* startdate,           // Start date, used if the token is empty
+         const char* starttime,           // Start time, used if the token is empty
+         char* &token,                    // Resume token, returns token for the next call
+         Pes_clhapi::t_eventbatchcb eventcb, // Call back method.
+         void* context                    // User context
+         );
+
+   // Read several logs merged in time order, receive events in the callback, the call
+   // is blocked until all data has been received
+   int readMergedLogs(
+         const std::string& cpname,       // CP name, for a one CP system an empty string is provided
+         const std::string& cpside,       // CP side, "A" or "B", an empty string for both CP sides
+         const std::string& logs,         // Comma separated list of log names, empty for all logs
+         const char* startdate,           // Start date
+         const char* starttime,           // Start time
+         const char* stopdate,            // Stop date
+         const char* stoptime,            // Stop time
+         bool cptimeorder,                // true to merge on CP time, false on AP time
+         Pes_clhapi::t_mergedeventcb eventcb // Call back method.
+         );
+
    // Write logs to a destination
    int transferLogs(
          const std::string& cpname,       // CP name, in a one CP system an empty string is provided.
@@ -79,13 +123,29 @@ public:
          const char* starttime,           // Start time
          const char* stopdate,            // Stop date
          const char* stoptime,            // Stop time
-         desttype_t desttype              // Destination type.
+         desttype_t desttype,             // Destination type.
+         bool incremental = false         // Only what was added since the last incremental
+                                          // transfer
          );
 
-   // Get error text
+   // Get error text for the previous call in the calling thread
    const char* getErrorText() const;
 
 private:
+   typedef std::vector<Pes_clhapi::t_event> EVENTLIST;
+
+   // Set error text for the calling thread
+   void setErrorText(
+         const std::string& text
+         );
+
+   // Get CP and CP side for reading the trace log
+   void getTraceCP(
+         const std::string& cpname,
+         const std::string& cpside,
+         CPInfo& cpinfo,
+         t_cpSide& tcpside
+         ) const;
 
    // Get CP side
    t_cpSide getCpSide(
@@ -108,18 +168,40 @@ private:
          const Period& period
          ) const;
 
-   static void getLogEvent(
-         const Time& cptime,
-         const Time& aptime,
-         size_t size,
-         const char* buf,
-         std::ostream& os
+   // Read events from the cursor to the end of a period, the events are delivered
+   // in batches
+   static bool readEvents(                // Returns false if the call back stopped the read
+         LogCursor& cursor,               // Cursor at the first event
+         bool valid,                      // Cursor is positioned
+         const TimeStamp& end,            // AP time ending the read
+         bool reverse,                    // true for last event first
+         Pes_clhapi::t_eventbatchcb eventcb, // Call back method, 0 for no events
+         void* context,                   // User context
+         TimeStamp& first,                // Returns AP time for the first event read
+         TimeStamp& last,                 // Returns AP time for the last event read
+         LogCursor::t_position& position  // Returns position of the last event read
+         );
+
+   // Deliver a batch of events, the batch is cleared
+   static bool sendEvents(                // Returns false if reading shall stop
+         Pes_clhapi::t_eventbatchcb eventcb,
+         void* context,
+         EVENTLIST& events,
+         std::vector<char>& data
+         );
+
+   // Batch call back for readLog, the context is the readLog call back method
+   static bool getLogEvents(
+         void* context,
+         const Pes_clhapi::t_event* events,
+         size_t count
          );
 
-   std::string m_errortext;
+   boost::thread_specific_ptr<std::string> m_errortext;  // Error text, one per thread
 
    static const char s_success[];
-   static Pes_clhapi::t_eventcb s_eventcb;
+   static const size_t s_batchevents;     // Max number of events in a batch
+   static const size_t s_batchsize;       // Max size of the event data in a batch
 };
 
 }
@@ -42,6 +42,8 @@
 
 using namespace std;
 
+const int64_t Pes_clhapi::s_notime = int64_t(1) << 62;
+
 //----------------------------------------------------------------------------------------
 // Constructor
 //----------------------------------------------------------------------------------------
@@ -84,6 +86,87 @@ int Pes_clhapi::readLog_p(
                      );
 }
 
+//----------------------------------------------------------------------------------------
+// Read trace log, receive the events in batches in the callback, the call is blocked
+// until all data has been received
+//----------------------------------------------------------------------------------------
+int Pes_clhapi::readLogEvents_p(
+                  const char* cpname,
+                  const char* cpside,
+                  const char* startdate,
+                  const char* starttime,
+                  const char* stopdate,
+                  const char* stoptime,
+                  t_eventbatchcb eventcb,
+                  void* context
+                  ) const
+{
+   return m_apiptr->readLogEvents(
+                     cpname,
+                     cpside,
+                     startdate,
+                     starttime,
+                     stopdate,
+                     stoptime,
+                     eventcb,
+                     context
+                     );
+}
+
+//----------------------------------------------------------------------------------------
+// Read trace log events committed since a previous call, receive the events in batches
+// in the callback, the call is blocked until all new data has been received
+//----------------------------------------------------------------------------------------
+int Pes_clhapi::readLogEventsSince_p(
+                  const char* cpname,
+                  const char* cpside,
+                  const char* startdate,
+                  const char* starttime,
+                  char* &token,
+                  t_eventbatchcb eventcb,
+                  void* context
+                  ) const
+{
+   return m_apiptr->readLogEventsSince(
+                     cpname,
+                     cpside,
+                     startdate,
+                     starttime,
+                     token,
+                     eventcb,
+                     context
+                     );
+}
+
+//----------------------------------------------------------------------------------------
+// Read several logs merged in time order, receive events in the callback, the call is
+// blocked until all data has been received
+//----------------------------------------------------------------------------------------
+int Pes_clhapi::readMergedLogs_p(
+                  const char* cpname,
+                  const char* cpside,
+                  const char* logs,
+                  const char* startdate,
+                  const char* starttime,
+                  const char* stopdate,
+                  const char* stoptime,
+                  bool cptimeorder,
+                  t_mergedeventcb eventcb
+                  ) const
+{
+   return m_apiptr->readMergedLogs(
+                     cpname,
+                     cpside,
+                     logs,
+                     startdate,
+                     starttime,
+                     stopdate,
+                     stoptime,
+                     cptimeorder,
+                     eventcb
+                     );
+}
+
 //----------------------------------------------------------------------------------------
 // Write logs to a destination
 //----------------------------------------------------------------------------------------
@@ -106,6 +189,29 @@ int Pes_clhapi::transferLogs_p(
                      );
 }
 
+//----------------------------------------------------------------------------------------
+// Write what was added to the logs since the last incremental transfer
+//----------------------------------------------------------------------------------------
+int Pes_clhapi::transferLogsSince_p(
+                  const char* cpname,
+                  const char* startdate,
+                  const char* starttime,
+                  const char* stopdate,
+                  const char* stoptime,
+                  desttype_t desttype
+                  ) const
+{
+   return m_apiptr->transferLogs(
+                     cpname,
+                     startdate,
+                     starttime,
+                     stopdate,
+                     stoptime,
+                     desttype,
+                     true
+                     );
+}
+
 //----------------------------------------------------------------------------------------
 // Get error text
 //----------------------------------------------------------------------------------------
@@ -38,16 +38,27 @@
 #include "pes_clhapi_impl.h"
 #include <common.h>
 #include <exception.h>
+#include <logcursor.h>
+#include <loginfo.h>
+#include <logmerger.h>
 #include <logtask.h>
+#include <zipwriter.h>
+#include <transferscheduler.h>
+#include <transfercheckpoint.h>
+#include <logger.h>
+#include <boost/shared_ptr.hpp>
 #include <boost/algorithm/string.hpp>
 #include <signal.h>
+#include <list>
+#include <vector>
 
 using namespace std;
 
 namespace PES_CLH {
 
 const char Api_impl::s_success[] = "Successful execution.";
-Pes_clhapi::t_eventcb Api_impl::s_eventcb = NULL;
+const size_t Api_impl::s_batchevents = 256;
+const size_t Api_impl::s_batchsize = 256 * 1024;
 
 //----------------------------------------------------------------------------------------
 // Signal handler
@@ -88,10 +99,237 @@ int Api_impl::readLog(
    try
    {
       // Analyze CP name and side
-      string cp;
+      CPInfo cpinfo;
+      t_cpSide tcpside = e_noside;
+      getTraceCP(cpname, cpside, cpinfo, tcpside);
+
+      // Analyze start and stop times
+      Period period(startdate, starttime, stopdate, stoptime);
+
+      // Create a trace task
+      boost::shared_ptr<const BaseTask> logtaskp(createTask(e_trace, cpinfo, tcpside));
+      const AppendTask& task = dynamic_cast<const AppendTask&>(*logtaskp);
+
+      // Command execution, last event first
+      TimeStamp start;
+      TimeStamp stop;
+      LogCursor::t_position position;
+      LogCursor cursor(task);
+      readEvents(
+            cursor,
+            cursor.seekBefore(period.last()),
+            TimeStamp(period.first()),
+            true,
+            eventcb? getLogEvents: 0,
+            &eventcb,
+            stop,
+            start,
+            position
+            );
+
+      if (start.empty() == false)
+      {
+         // Start greater than stop time
+         if (start > stop)
+         {
+            throw StartGreatStopTimeException(start.getTime(), stop.getTime(), WHERE__);
+         }
+
+         string tstartdate;
+         string tstarttime;
+         string tstopdate;
+         string tstoptime;
+
+         start.getTime().get(tstartdate, tstarttime);
+         stop.getTime().get(tstopdate, tstoptime);
+
+         free(startdate);
+         free(starttime);
+         free(stopdate);
+         free(stoptime);
+
+         startdate = strdup(tstartdate.c_str());
+         starttime = strdup(tstarttime.c_str());
+         stopdate = strdup(tstopdate.c_str());
+         stoptime = strdup(tstoptime.c_str());
+      }
+      else
+      {
+         startdate[0] = 0;
+         starttime[0] = 0;
+         stopdate[0] = 0;
+         stoptime[0] = 0;
+      }
+   }
+   catch (Exception& ex)
+   {
+      setErrorText(ex.getMessage());
+      return ex.getErrCode();
+   }
+
+   setErrorText(s_success);
+   return 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Read trace log, receive the events in batches in the callback, the call is blocked
+// until all data has been received
+//----------------------------------------------------------------------------------------
+int Api_impl::readLogEvents(
+                  const std::string& cpname,
+                  const std::string& cpside,
+                  const char* startdate,
+                  const char* starttime,
+                  const char* stopdate,
+                  const char* stoptime,
+                  Pes_clhapi::t_eventbatchcb eventcb,
+                  void* context
+                  )
+{
+   try
+   {
+      // Analyze CP name and side
+      CPInfo cpinfo;
+      t_cpSide tcpside = e_noside;
+      getTraceCP(cpname, cpside, cpinfo, tcpside);
+
+      // Analyze start and stop times
+      Period period(startdate, starttime, stopdate, stoptime);
+
+      // Create a trace task
+      boost::shared_ptr<const BaseTask> logtaskp(createTask(e_trace, cpinfo, tcpside));
+      const AppendTask& task = dynamic_cast<const AppendTask&>(*logtaskp);
+
+      // Command execution, first event first
+      TimeStamp first;
+      TimeStamp last;
+      LogCursor::t_position position;
+      LogCursor cursor(task);
+      readEvents(
+            cursor,
+            cursor.seek(period.first()),
+            TimeStamp(period.last()),
+            false,
+            eventcb,
+            context,
+            first,
+            last,
+            position
+            );
+   }
+   catch (Exception& ex)
+   {
+      setErrorText(ex.getMessage());
+      return ex.getErrCode();
+   }
+   catch (exception& e)
+   {
+      // Boost exception
+      Exception ex(Exception::system(), WHERE__);
+      ex << e.what() << ".";
+      setErrorText(ex.getMessage());
+      return ex.getErrCode();
+   }
+
+   setErrorText(s_success);
+   return 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Read trace log events committed since a previous call, receive the events in batches
+// in the callback, the call is blocked until all new data has been received
+//----------------------------------------------------------------------------------------
+int Api_impl::readLogEventsSince(
+                  const std::string& cpname,
+                  const std::string& cpside,
+                  const char* startdate,
+                  const char* starttime,
+                  char* &token,
+                  Pes_clhapi::t_eventbatchcb eventcb,
+                  void* context
+                  )
+{
+   try
+   {
+      // Analyze CP name and side
+      CPInfo cpinfo;
+      t_cpSide tcpside = e_noside;
+      getTraceCP(cpname, cpside, cpinfo, tcpside);
+
+      // Analyze start time, the read continues to the last event
+      Period period(startdate, starttime, "", "");
+
+      // Create a trace task
+      boost::shared_ptr<const BaseTask> logtaskp(createTask(e_trace, cpinfo, tcpside));
+      const AppendTask& task = dynamic_cast<const AppendTask&>(*logtaskp);
+
+      // Command execution, continue after the event in the token
+      TimeStamp first;
+      TimeStamp last;
+      LogCursor::t_position position;
+      LogCursor cursor(task);
+      const bool valid = (token[0] == 0)? cursor.seek(period.first()): cursor.seekAfter(token);
+      readEvents(
+            cursor,
+            valid,
+            TimeStamp(period.last()),
+            false,
+            eventcb,
+            context,
+            first,
+            last,
+            position
+            );
+
+      // The token is unchanged if there are no new events
+      if (last.empty() == false)
+      {
+         const string& ttoken = cursor.getToken(position);
+         free(token);
+         token = strdup(ttoken.c_str());
+      }
+   }
+   catch (Exception& ex)
+   {
+      setErrorText(ex.getMessage());
+      return ex.getErrCode();
+   }
+   catch (exception& e)
+   {
+      // Boost exception
+      Exception ex(Exception::system(), WHERE__);
+      ex << e.what() << ".";
+      setErrorText(ex.getMessage());
+      return ex.getErrCode();
+   }
+
+   setErrorText(s_success);
+   return 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Read several logs merged in time order, receive events in the callback, the call is
+// blocked until all data has been received
+//----------------------------------------------------------------------------------------
+int Api_impl::readMergedLogs(
+                  const std::string& cpname,
+                  const std::string& cpside,
+                  const std::string& logs,
+                  const char* startdate,
+                  const char* starttime,
+                  const char* stopdate,
+                  const char* stoptime,
+                  bool cptimeorder,
+                  Pes_clhapi::t_mergedeventcb eventcb
+                  )
+{
+   try
+   {
+      // Analyze CP name and side
       CPTable cptable;
       CPInfo cpinfo;
       t_cpSide tcpside = e_noside;
+      string cp;
 
       if (CPTable::isMultiCPSystem())
       {
@@ -110,34 +348,7 @@ int Api_impl::readLog(
          {
             throw Exception(Exception::cpNotDefined(cp), WHERE__);
          }
-
          cpinfo = *iter;
-         CPID cpid = cpinfo.getCPID();
-
-         // CP or BC?
-         if (cpid < ACS_CS_API_HWC_NS::SysType_CP)
-         {
-            // BC has no CP sides
-            if (cpside.empty() == false)
-            {
-               throw Exception(Exception::cpSideNotAllowed(), WHERE__);
-            }
-            tcpside = e_cpa;
-         }
-         else
-         {
-            // Dual CP system - check CP side
-            if (cpside.empty() == false)
-            {
-               tcpside = getCpSide(cpside);
-            }
-            else
-            {
-               Exception ex(Exception::parameter(), WHERE__);
-               ex << "CP side is missing.";
-               throw ex;
-            }
-         }
       }
       else
       {
@@ -147,75 +358,131 @@ int Api_impl::readLog(
             ex << "CP name is not allowed for a single CP system.";
             throw ex;
          }
+         cpinfo = cptable.get();
+      }
 
-         // Check CP side
+      if (cpinfo.getCPID() < ACS_CS_API_HWC_NS::SysType_CP)
+      {
+         // BC has no CP sides
          if (cpside.empty() == false)
          {
-            tcpside = getCpSide(cpside);
-         }
-         else
-         {
-            Exception ex(Exception::parameter(), WHERE__);
-            ex << "CP side is missing.";
-            throw ex;
+            throw Exception(Exception::cpSideNotAllowed(), WHERE__);
          }
+         tcpside = e_cpa;
+      }
+      else
+      {
+         // Dual CP - both sides unless a side is given
+         tcpside = (cpside.empty())? e_bothsides: getCpSide(cpside);
       }
 
-      // Analyze start and stop times
-      Period period(startdate, starttime, stopdate, stoptime);
-
-      // Create a trace task
-      const BaseTask* logtaskp = createTask(e_trace, cpinfo, tcpside);
-
-      // Command execution
-      Period tperiod;
-      if (eventcb == 0)
+      t_apzSystem apzsys = cpinfo.getAPZSystem();
+      if (apzsys == e_classic)
       {
-         tperiod = logtaskp->readEvents(period, NoFilter());
+         throw Exception(Exception::illCommand(), WHERE__);
       }
-      else
+      if (apzsys == e_undefined)
       {
-         s_eventcb = eventcb;
-         tperiod = logtaskp->readEvents(period, NoFilter(), getLogEvent);
+         throw Exception(Exception::apzSystemNotDefined(cp), WHERE__);
       }
 
-      delete logtaskp;
+      // Analyze start and stop times
+      Period period(startdate, starttime, stopdate, stoptime);
 
-      if (tperiod.empty() == false)
+      // Analyze list of logs
+      LogTable logtable;
+      logtable.initialize(LogTable::s_error);
+      logtable.initialize(LogTable::s_event);
+      logtable.initialize(LogTable::s_syslog);
+      logtable.initialize(LogTable::s_sel);
+      logtable.initialize(LogTable::s_consolsrm);
+      logtable.initialize(LogTable::s_consolbmc);
+      logtable.initialize(LogTable::s_consolmp);
+      logtable.initialize(LogTable::s_consolpcih);
+      logtable.initialize(LogTable::s_consolsyscon);
+
+      list<string> namelist;
+      if (logs.empty() == false)
       {
-         string tstartdate;
-         string tstarttime;
-         string tstopdate;
-         string tstoptime;
-
-         tperiod.first().get(tstartdate, tstarttime);
-         tperiod.last().get(tstopdate, tstoptime);
+         boost::split(namelist, logs, boost::is_any_of(","));
+         for (list<string>::iterator iter = namelist.begin(); iter != namelist.end(); ++iter)
+         {
+            boost::trim(*iter);
+            boost::to_upper(*iter);
+         }
+      }
+      const LogTable::LIST& loglist = namelist.empty()?
+                                      logtable.getList(apzsys):
+                                      logtable.getList(namelist, apzsys);
 
-         free(startdate);
-         free(starttime);
-         free(stopdate);
-         free(stoptime);
+      // Open the logs
+      typedef boost::shared_ptr<const BaseTask> TASKPTR;
+      vector<TASKPTR> tasklist;
+      vector<XmFilter> xmfilterlist;
+      LogMerger merger(cptimeorder? LogMerger::e_cptime: LogMerger::e_aptime);
 
-         startdate = strdup(tstartdate.c_str());
-         starttime = strdup(tstarttime.c_str());
-         stopdate = strdup(tstopdate.c_str());
-         stoptime = strdup(tstoptime.c_str());
+      for (LogTable::LISTCITER iter = loglist.begin(); iter != loglist.end(); ++iter)
+      {
+         const LogInfo& loginfo = *iter;
+         const BaseParameters& parameters = loginfo.getParameters();
+         for (int i = e_cpa; i <= e_cpb; i++)
+         {
+            if (tcpside & i)
+            {
+               t_cpSide side = static_cast<t_cpSide>(i);
+               TASKPTR logtaskp(createTask(parameters.getLogType(), cpinfo, side));
+               const AppendTask* apptaskp = dynamic_cast<const AppendTask*>(logtaskp.get());
+               if (apptaskp == 0)
+               {
+                  continue;
+               }
+
+               string tag = parameters.getShortName();
+               if (tcpside == e_bothsides)
+               {
+                  tag += (side == e_cpa)? "/A": "/B";
+               }
+               tasklist.push_back(logtaskp);
+               xmfilterlist.push_back(loginfo.getXmFilter());
+               merger.add(*apptaskp, tag);
+            }
+         }
       }
-      else
+
+      // Read the events
+      for (bool valid = merger.seek(period); valid; valid = merger.next())
       {
-         startdate[0] = 0;
-         starttime[0] = 0;
-         stopdate[0] = 0;
-         stoptime[0] = 0;
+         const size_t size = merger.getSize();
+         const char* const buf = merger.getData();
+         const XmFilter& filter = xmfilterlist[merger.getSource()];
+         if (filter.needsData() && (filter.test(buf, size) == false))
+         {
+            continue;
+         }
+         eventcb(
+               merger.getTag().c_str(),
+               merger.getCPTimeText().c_str(),
+               merger.getAPTime().get().c_str(),
+               size,
+               buf
+               );
       }
    }
    catch (Exception& ex)
    {
-      m_errortext = ex.getMessage();
+      setErrorText(ex.getMessage());
+      return ex.getErrCode();
+   }
+   catch (exception& e)
+   {
+      // Boost exception
+      Exception ex(Exception::system(), WHERE__);
+      ex << e.what() << ".";
+      setErrorText(ex.getMessage());
       return ex.getErrCode();
    }
 
-   m_errortext = s_success;
+   setErrorText(s_success);
    return 0;
 }
 
@@ -228,7 +495,8 @@ int Api_impl::transferLogs(
                   const char* starttime,
                   const char* stopdate,
                   const char* stoptime,
-                  desttype_t desttype
+                  desttype_t desttype,
+                  bool incremental
                   )
 {
    CPTable cptable;
@@ -279,7 +547,7 @@ int Api_impl::transferLogs(
    }
    catch (Exception& ex)
    {
-      m_errortext = ex.getMessage();
+      setErrorText(ex.getMessage());
       return ex.getErrCode();
    }
 
@@ -326,6 +594,12 @@ int Api_impl::transferLogs(
       // Change current working directory to archive path
       fs::current_path(archpath);
 
+      // Archive written in-process, the logs are inserted as they are transferred
+      const fs::path& archive = archpath / "archive.zip";
+      ArchiveSession session(archive);
+      TransferScheduler scheduler;        // Backs off while the log server is behind
+      TransferCheckpoint checkpoints(supportpath / "clh_checkpoint", incremental);
+
       // Execute command
       if (cpname.empty() == false)
       {
@@ -338,8 +612,15 @@ int Api_impl::transferLogs(
          // In a single CP system: Transfer log files
          transferLogs(period);
       }
+      session.close();
 
-      const fs::path& archive = archpath / "archive.zip";
+      Logger logger(LOG_LEVEL_INFO);
+      if (logger)
+      {
+         ostringstream s;
+         scheduler.report(s);
+         logger.event(WHERE__, s.str());
+      }
 
       if (fs::exists(archive))
       {
@@ -351,6 +632,7 @@ int Api_impl::transferLogs(
          {
             // Move archive to ftp volume
             fs::rename(archive, supportpath / archfile);
+            checkpoints.commit();
 
             // Transfer finished, remove temporary files
             fs::remove_all(temppath);
@@ -376,6 +658,7 @@ int Api_impl::transferLogs(
             }
             // Execute in background
             Common::emfpoll(archfile);
+            checkpoints.commit();
 
             // Copying finished, remove temporary files
             fs::remove_all(temppath);
@@ -410,7 +693,7 @@ int Api_impl::transferLogs(
       fs::remove_all(temppath);
 
       // Return code
-      m_errortext = ex.getMessage();
+      setErrorText(ex.getMessage());
       return ex.getErrCode();
    }
    catch (exception& e)
@@ -425,11 +708,11 @@ int Api_impl::transferLogs(
       // Return code
       Exception ex(Exception::system(), WHERE__);
       ex << e.what() << ".";
-      m_errortext = ex.getMessage();
+      setErrorText(ex.getMessage());
       return ex.getErrCode();
    }
 
-   m_errortext = s_success;
+   setErrorText(s_success);
    return 0;
 }
 
@@ -438,7 +721,100 @@ int Api_impl::transferLogs(
 //----------------------------------------------------------------------------------------
 const char* Api_impl::getErrorText() const
 {
-   return m_errortext.c_str();
+   const string* const textp = m_errortext.get();
+   return textp? textp->c_str(): s_success;
+}
+
+//----------------------------------------------------------------------------------------
+// Set error text for the calling thread
+//----------------------------------------------------------------------------------------
+void Api_impl::setErrorText(const string& text)
+{
+   if (m_errortext.get() == 0)
+   {
+      m_errortext.reset(new string);
+   }
+   *m_errortext = text;
+}
+
+//----------------------------------------------------------------------------------------
+// Get CP and CP side for reading the trace log
+//----------------------------------------------------------------------------------------
+void Api_impl::getTraceCP(
+      const string& cpname,
+      const string& cpside,
+      CPInfo& cpinfo,
+      t_cpSide& tcpside
+      ) const
+{
+   CPTable cptable;
+   if (CPTable::isMultiCPSystem())
+   {
+      // Multi CP system
+      if (cpname.empty())
+      {
+         Exception ex(Exception::parameter(), WHERE__);
+         ex << "CP name is required for a multi CP system";
+         throw ex;
+      }
+
+      // CP information
+      const string& cp = boost::to_lower_copy(cpname);
+      CPTable::const_iterator iter = cptable.find(cp);
+      if (iter == cptable.end())
+      {
+         throw Exception(Exception::cpNotDefined(cp), WHERE__);
+      }
+
+      cpinfo = *iter;
+      CPID cpid = cpinfo.getCPID();
+
+      // CP or BC?
+      if (cpid < ACS_CS_API_HWC_NS::SysType_CP)
+      {
+         // BC has no CP sides
+         if (cpside.empty() == false)
+         {
+            throw Exception(Exception::cpSideNotAllowed(), WHERE__);
+         }
+         tcpside = e_cpa;
+      }
+      else
+      {
+         // Dual CP system - check CP side
+         if (cpside.empty() == false)
+         {
+            tcpside = getCpSide(cpside);
+         }
+         else
+         {
+            Exception ex(Exception::parameter(), WHERE__);
+            ex << "CP side is missing.";
+            throw ex;
+         }
+      }
+   }
+   else
+   {
+      if (cpname.empty() == false)
+      {
+         Exception ex(Exception::parameter(), WHERE__);
+         ex << "CP name is not allowed for a single CP system.";
+         throw ex;
+      }
+
+      // Check CP side
+      if (cpside.empty() == false)
+      {
+         tcpside = getCpSide(cpside);
+      }
+      else
+      {
+         Exception ex(Exception::parameter(), WHERE__);
+         ex << "CP side is missing.";
+         throw ex;
+      }
+   }
 }
 
 //----------------------------------------------------------------------------------------
@@ -501,17 +877,115 @@ t_cpSide Api_impl::getCpSide(const string& str) const
 }
 
 //----------------------------------------------------------------------------------------
-// Get a log event
+// Read events from the cursor to the end of a period, the events are delivered in
+// batches. The event data is copied to the batch, since the cursor may load another
+// subfile before the batch is delivered.
 //----------------------------------------------------------------------------------------
-void Api_impl::getLogEvent(
-         const Time& cptime,
-         const Time& aptime,
-         size_t size,
-         const char* buf,
-         ostream&
+bool Api_impl::readEvents(
+         LogCursor& cursor,
+         bool valid,
+         const TimeStamp& end,
+         bool reverse,
+         Pes_clhapi::t_eventbatchcb eventcb,
+         void* context,
+         TimeStamp& first,
+         TimeStamp& last,
+         LogCursor::t_position& position
          )
 {
-   s_eventcb(cptime.get(Time::e_long).c_str(), aptime.get().c_str(), size, buf);
+   EVENTLIST events;
+   vector<char> data;
+   if (eventcb)
+   {
+      events.reserve(s_batchevents);
+      data.reserve(s_batchsize);
+   }
+
+   for (; valid; valid = reverse? cursor.prev(): cursor.next())
+   {
+      const TimeStamp aptime = cursor.getAPStamp();
+      if (reverse? (end > aptime): (aptime > end)) break;       // End of period reached
+
+      if (eventcb)
+      {
+         const size_t size = cursor.getSize();
+         if ((events.empty() == false) &&
+             ((events.size() == s_batchevents) || (data.size() + size > s_batchsize)))
+         {
+            // The last event read is the last event in the batch
+            if (sendEvents(eventcb, context, events, data) == false)
+            {
+               return false;
+            }
+         }
+
+         // The message pointer is set when the batch is delivered
+         const Pes_clhapi::t_event event = {cursor.getCPStamp().get(), aptime.get(), size, 0};
+         events.push_back(event);
+         const char* const buf = cursor.getData();
+         data.insert(data.end(), buf, buf + size);
+      }
+
+      if (first.empty())
+      {
+         first = aptime;
+      }
+      last = aptime;
+      position = cursor.getPosition();
+   }
+
+   if (events.empty() == false)
+   {
+      return sendEvents(eventcb, context, events, data);
+   }
+   return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Deliver a batch of events, the batch is cleared
+//----------------------------------------------------------------------------------------
+bool Api_impl::sendEvents(
+         Pes_clhapi::t_eventbatchcb eventcb,
+         void* context,
+         EVENTLIST& events,
+         vector<char>& data
+         )
+{
+   const char* evmsg = data.empty()? 0: &data[0];
+   for (EVENTLIST::iterator iter = events.begin(); iter != events.end(); ++iter)
+   {
+      iter->evmsg = evmsg;
+      evmsg += iter->size;
+   }
+
+   const bool cont = eventcb(context, &events[0], events.size());
+   events.clear();
+   data.clear();
+   return cont;
+}
+
+//----------------------------------------------------------------------------------------
+// Batch call back for readLog, the events are formatted for the readLog call back
+//----------------------------------------------------------------------------------------
+bool Api_impl::getLogEvents(
+         void* context,
+         const Pes_clhapi::t_event* events,
+         size_t count
+         )
+{
+   const Pes_clhapi::t_eventcb eventcb = *static_cast<Pes_clhapi::t_eventcb*>(context);
+   for (size_t i = 0; i < count; i++)
+   {
+      const Pes_clhapi::t_event& event = events[i];
+      const Time cptime(event.cptime);
+      eventcb(
+            cptime.empty()? "": cptime.get(Time::e_long).c_str(),
+            Time(event.aptime).get().c_str(),
+            event.size,
+            event.evmsg
+            );
+   }
+   return true;
 }
 
 }
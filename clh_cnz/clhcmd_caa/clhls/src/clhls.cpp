@@ -41,15 +41,22 @@
 #include <cpinfo.h>
 #include <loginfo.h>
 #include <logtask.h>
+#include <searchfilter.h>
+#include <jobpool.h>
+#include <logmerger.h>
+#include <outputsink.h>
 #include <ltime.h>
 #include <exception.h>
 #include <common.h>
 #include <ACS_APGCC_Util.H>
 #include <boost/algorithm/string.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
 #include <string>
 #include <iostream>
 #include <iomanip>
 #include <list>
+#include <vector>
 #include <mausinfo.h>
 
 namespace fs = boost::filesystem;
@@ -66,38 +73,46 @@ enum t_cmdtype
 
 t_cmdtype cmdtype(static_cast<t_cmdtype>(-1));         // Command type
 
+typedef boost::shared_ptr<const BaseTask> TASKPTR;
+
 //----------------------------------------------------------------------------------------
 // Read events for each log type
 //----------------------------------------------------------------------------------------
 void readEventsForEachLogType(
-         const BaseTask* logtaskp,
+         TASKPTR logtaskp,
          const Period& period,
-         const Filter& filter)
+         const XmFilter& xmfilter,
+         const Filter& searchfilter,
+         ostream& os)
 {
+   const AndFilter filter(xmfilter, searchfilter);
    try
    {
       // Print events
       logtaskp->readEvents(
                        period,
                        filter,
-                       printLogEvent
+                       printLogEvent,
+                       os
                        );
    }
    catch (StartGreatStopTimeException& ex)
    {
-      cout << "Warning: " << *logtaskp  << " First time (" << ex.getStartTime()
-           << ") is greater than Last time (" << ex.getStopTime() << ")." << endl;
+      os << "Warning: " << *logtaskp  << " First time (" << ex.getStartTime()
+         << ") is greater than Last time (" << ex.getStopTime() << ")." << endl;
    }
 }
 //----------------------------------------------------------------------------------------
-// Read events
+// Read events, one job is added for each log and CP side
 //----------------------------------------------------------------------------------------
 void readEvents(
          const CPInfo& cpinfo,
          t_cpSide cpside,
          const LogTable::LIST& loglist,
          const Period& period,
-         const MAUSInfo& mausinfo
+         const MAUSInfo& mausinfo,
+         const Filter& searchfilter,
+         JobPool& jobpool
          )
 {
    bool epopt = mausinfo.epExist();
@@ -105,7 +120,7 @@ void readEvents(
    {
       const LogInfo& loginfo = *iter;
       const BaseParameters& parameters = loginfo.getParameters();
-      const Filter& filter = loginfo.getXmFilter();
+      const XmFilter& xmfilter = loginfo.getXmFilter();
       t_logtype logtype = parameters.getLogType();
       t_loggroup loggroup = parameters.getLogGroup();
 
@@ -118,9 +133,9 @@ void readEvents(
                if (cpside & i)
                {
                   t_cpSide tcpside = static_cast<t_cpSide>(i);
-                  const BaseTask* logtaskp = createTask(logtype, cpinfo, tcpside);
-                  readEventsForEachLogType(logtaskp, period, filter);
-                  delete logtaskp;
+                  TASKPTR logtaskp(createTask(logtype, cpinfo, tcpside));
+                  jobpool.add(boost::bind(readEventsForEachLogType, logtaskp, period,
+                                          xmfilter, boost::cref(searchfilter), _1));
                }
             }
          }
@@ -172,15 +187,80 @@ void readEvents(
             if (isLogTypeValid)
             {
                tmpmaus.setPath(fullpath.string());
-               const BaseTask* logtaskp = createTask(logtype, cpinfo, tmpmaus);
-               readEventsForEachLogType(logtaskp, period, filter);
-               delete logtaskp;
+               TASKPTR logtaskp(createTask(logtype, cpinfo, tmpmaus));
+               jobpool.add(boost::bind(readEventsForEachLogType, logtaskp, period,
+                                       xmfilter, boost::cref(searchfilter), _1));
             }
          }
       }
    }
 }
 
+//----------------------------------------------------------------------------------------
+// Read events from several logs merged in time order, oldest event first
+//----------------------------------------------------------------------------------------
+void readMergedEvents(
+         const CPInfo& cpinfo,
+         t_cpSide cpside,
+         const LogTable::LIST& loglist,
+         const Period& period,
+         LogMerger::t_key key,
+         const Filter& searchfilter,
+         ostream& os
+         )
+{
+   vector<TASKPTR> tasklist;
+   vector<XmFilter> xmfilterlist;
+   LogMerger merger(key);
+
+   for (LogTable::LISTCITER iter = loglist.begin(); iter != loglist.end(); iter++)
+   {
+      const LogInfo& loginfo = *iter;
+      const BaseParameters& parameters = loginfo.getParameters();
+      if (parameters.getLogGroup() == e_lgMAU)
+      {
+         continue;
+      }
+
+      for (int i = e_cpa; i <= e_cpb; i++)
+      {
+         if (cpside & i)
+         {
+            t_cpSide tcpside = static_cast<t_cpSide>(i);
+            TASKPTR logtaskp(createTask(parameters.getLogType(), cpinfo, tcpside));
+
+            // Only logs of append type have events to merge
+            const AppendTask* apptaskp = dynamic_cast<const AppendTask*>(logtaskp.get());
+            if (apptaskp == 0)
+            {
+               continue;
+            }
+
+            string tag = parameters.getShortName();
+            if (cpside == e_bothsides)
+            {
+               tag += (tcpside == e_cpa)? "/A": "/B";
+            }
+            tasklist.push_back(logtaskp);
+            xmfilterlist.push_back(loginfo.getXmFilter());
+            merger.add(*apptaskp, tag);
+         }
+      }
+   }
+
+   for (bool valid = merger.seek(period); valid; valid = merger.next())
+   {
+      const size_t size = merger.getSize();
+      const char* const buf = merger.getData();
+      const AndFilter filter(xmfilterlist[merger.getSource()], searchfilter);
+      if (filter.needsData() && (filter.test(buf, size) == false))
+      {
+         continue;
+      }
+      printMergedEvent(merger.getTag(), merger.getCPTime(), merger.getAPTime(), size, buf, os);
+   }
+}
+
 //----------------------------------------------------------------------------------------
 // List time for first and last event
 //----------------------------------------------------------------------------------------
@@ -364,8 +444,9 @@ void usage(t_cmdtype cmdtype, bool multicp, bool usemaus)
    case e_clhls:
       cout << "Usage: clhls " << cpNameOption
            << "[-s cp_side][-a start_time][-e start_date]" << endl;
-      cout << "             [-b stop_time][-f stop_date]" << mausOption;
-      cout << "[log ...]" << endl;
+      cout << "             [-b stop_time][-f stop_date]" << mausOption << endl;
+      cout << "             [-g search_string [-r][-i]][-j threads]" << endl;
+      cout << "             [-t aptime|cptime][log ...]" << endl;
       cout << "       clhls -d " << cpNameOption
            << "[-e start_date][-f stop_date]" << mausOption << endl;
       break;
@@ -373,8 +454,9 @@ void usage(t_cmdtype cmdtype, bool multicp, bool usemaus)
    case e_xpuls:
       cout << "Usage: xpuls " << cpNameOption
            << "[-s cp_side][-a start_time][-e start_date]" << endl;
-      cout << "             [-b stop_time][-f stop_date]";
-      cout << "[log[xmlist...]]" << endl;
+      cout << "             [-b stop_time][-f stop_date]" << endl;
+      cout << "             [-g search_string [-r][-i]][-j threads]" << endl;
+      cout << "             [log[xmlist...]]" << endl;
       cout << "       xpuls -d " << cpNameOption
            << "[-e start_date][-f stop_date]" << endl;
       break;
@@ -383,6 +465,7 @@ void usage(t_cmdtype cmdtype, bool multicp, bool usemaus)
       cout << "Usage: tesrvls " << cpNameOption
            << "[-s cp_side][-a start_time][-e start_date]" << endl;
       cout << "               [-b stop_time][-f stop_date]" << endl;
+      cout << "               [-g search_string [-r][-i]][-j threads]" << endl;
       cout << "       tesrvls -d " << cpNameOption
            << "[-e start_date][-f stop_date]" << endl;
       break;
@@ -448,6 +531,11 @@ int main(int argc, const char* argv[])
       CmdParser::Optarg optStopDate("f");
       CmdParser::Opt dir("d");
       CmdParser::Optarg optMausEP("m");
+      CmdParser::Optarg optSearch("g");
+      CmdParser::Opt optRegex("r");
+      CmdParser::Opt optIcase("i");
+      CmdParser::Optarg optThreads("j");
+      CmdParser::Optarg optMerge("t");
 
       // Parse command
       CmdParser cmdparser(argc, argv);
@@ -501,6 +589,16 @@ int main(int argc, const char* argv[])
          {
             cmdparser.fetchOpt(optMausEP);
          }
+         if (cmdparser.fetchOpt(optSearch))
+         {
+            cmdparser.fetchOpt(optRegex);
+            cmdparser.fetchOpt(optIcase);
+         }
+         cmdparser.fetchOpt(optThreads);
+         if (cmdtype == e_clhls)
+         {
+            cmdparser.fetchOpt(optMerge);
+         }
 
          // Log types
          string logname;
@@ -623,6 +721,37 @@ int main(int argc, const char* argv[])
       // End of command check
       cmdparser.check();
 
+      // Search the event text
+      SearchFilter searchfilter;
+      if (optSearch.found())
+      {
+         searchfilter = SearchFilter(optSearch.getArg(), optRegex.found(), optIcase.found());
+      }
+
+      // Logs are read in parallel, the printout is in the same order as when read one by one
+      size_t maxthreads(0);
+      if (optThreads.found())
+      {
+         maxthreads = JobPool::getMaxThreads(optThreads.getArg());
+      }
+      JobPool jobpool(maxthreads);
+
+      // Merged view of the logs, on AP time or CP time
+      LogMerger::t_key mergekey(LogMerger::e_aptime);
+      if (optMerge.found())
+      {
+         const string& key = boost::to_lower_copy(optMerge.getArg());
+         if      (key == "aptime") mergekey = LogMerger::e_aptime;
+         else if (key == "cptime") mergekey = LogMerger::e_cptime;
+         else throw Exception(Exception::usage(), WHERE__);
+
+         // MAUS logs are not merged
+         if (optMausEP.found())
+         {
+            throw Exception(Exception::usage(), WHERE__);
+         }
+      }
+
       // Analyze parameters
       if (multicp)
       {
@@ -868,6 +997,12 @@ int main(int argc, const char* argv[])
             listEvents(cpinfo, loglist, period, mausinfo);
          }
       }
+      else if (optMerge.found())
+      {
+         // Read events merged in time order
+         OutputSink sink(cout);
+         readMergedEvents(cpinfo, cpside, loglist, period, mergekey, searchfilter, sink);
+      }
       else
       {
          if (mausinfo.checkValueAll())
@@ -877,14 +1012,16 @@ int main(int argc, const char* argv[])
                MAUSInfo minfo;
                const string& epName = MAUSInfo::getEPName(idx);
                minfo.find(epName);
-               readEvents(cpinfo, cpside, loglist, period, minfo);
+               readEvents(cpinfo, cpside, loglist, period, minfo, searchfilter, jobpool);
             }
          }
          else
          {
              // Read events
-             readEvents(cpinfo, cpside, loglist, period, mausinfo);
+             readEvents(cpinfo, cpside, loglist, period, mausinfo, searchfilter, jobpool);
          }
+         OutputSink sink(cout);
+         jobpool.run(sink);
       }
    }
    catch (Exception& ex)
@@ -40,12 +40,19 @@
 #include <cpinfo.h>
 #include <loginfo.h>
 #include <logtask.h>
+#include <searchfilter.h>
+#include <jobpool.h>
 #include <ltime.h>
 #include <exception.h>
 #include <common.h>
+#include <zipwriter.h>
+#include <transferscheduler.h>
+#include <transfercheckpoint.h>
 #include <ACS_APGCC_Util.H>
 #include <boost/filesystem.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/bind.hpp>
+#include <boost/shared_ptr.hpp>
 #include <string>
 #include <iostream>
 #include <list>
@@ -66,6 +73,8 @@ enum t_cmdtype
 
 t_cmdtype cmdtype(static_cast<t_cmdtype>(-1));         // Command type
 
+typedef boost::shared_ptr<const BaseTask> TASKPTR;
+
 //----------------------------------------------------------------------------------------
 // Signal handler
 //----------------------------------------------------------------------------------------
@@ -77,29 +86,43 @@ void sighandler(int)
 // Read events for each log type
 //----------------------------------------------------------------------------------------
 void transferForEachLogType(
-         const BaseTask* logtaskp,
+         TASKPTR logtaskp,
          const Period& period,
-         const Filter& filter)
+         const XmFilter& xmfilter,
+         const Filter& searchfilter,
+         ostream& os)
 {
+   const AndFilter andfilter(xmfilter, searchfilter);
+   const Filter& filter = searchfilter.empty()? static_cast<const Filter&>(xmfilter): andfilter;
    try
    {
       logtaskp->transferLogs(period, filter);
    }
    catch (StartGreatStopTimeException& ex)
    {
-      cout << "Warning: " << *logtaskp  << " First time (" << ex.getStartTime()
-           << ") is greater than Last time (" << ex.getStopTime() << ")." << endl;
+      os << "Warning: " << *logtaskp  << " First time (" << ex.getStartTime()
+         << ") is greater than Last time (" << ex.getStopTime() << ")." << endl;
    }
 }
 
 //----------------------------------------------------------------------------------------
-// Transfer log files for a CP or blade
+// Print a text, keeps it in order with the printouts from the transfers
+//----------------------------------------------------------------------------------------
+void printText(const string& text, ostream& os)
+{
+   os << text;
+}
+
+//----------------------------------------------------------------------------------------
+// Transfer log files for a CP or blade, one job is added for each log and CP side
 //----------------------------------------------------------------------------------------
 void transferLogs(
       const CPInfo& cpinfo,
       const LogTable::LIST& loglist,
       const Period& period,
-      const MAUSInfo& mausinfo
+      const MAUSInfo& mausinfo,
+      const Filter& searchfilter,
+      JobPool& jobpool
       )
 {
    bool epopt = mausinfo.epExist();
@@ -107,7 +130,7 @@ void transferLogs(
    const string& cpname = cpinfo.getName();
    if (apzsys == e_undefined)
    {
-      cout << "APZ system value is not defined for " << cpname.c_str() << ".";
+      jobpool.add(boost::bind(printText, "APZ system value is not defined for " + cpname + ".", _1));
       return;
    }
    CPID cpid = cpinfo.getCPID();
@@ -131,10 +154,9 @@ void transferLogs(
             {
                if (!epopt)
                {
-                  const BaseTask* logtaskp = createTask(logtype, cpinfo, tcpside);
-                  const Filter& filter = iter->getXmFilter();
-                  transferForEachLogType(logtaskp, period, filter);
-                  delete logtaskp;
+                  TASKPTR logtaskp(createTask(logtype, cpinfo, tcpside));
+                  jobpool.add(boost::bind(transferForEachLogType, logtaskp, period,
+                                          iter->getXmFilter(), boost::cref(searchfilter), _1));
                }
             }
             else
@@ -208,10 +230,9 @@ void transferLogs(
                   {
                      tmpmaus.setParentPath(parentpath.string());
                      tmpmaus.setPath(fullpath.string());
-                     const BaseTask* logtaskp = createTask(logtype, cpinfo, tmpmaus);
-                     const Filter& filter = iter->getXmFilter();
-                     transferForEachLogType(logtaskp, period, filter);
-                     delete logtaskp;
+                     TASKPTR logtaskp(createTask(logtype, cpinfo, tmpmaus));
+                     jobpool.add(boost::bind(transferForEachLogType, logtaskp, period,
+                                             iter->getXmFilter(), boost::cref(searchfilter), _1));
                   }
                }
             }
@@ -227,7 +248,9 @@ void transferLogs(
 void transferLogs(
       const LogTable::LIST& loglist,
       const Period& period,
-      const MAUSInfo& mausinfo
+      const MAUSInfo& mausinfo,
+      const Filter& searchfilter,
+      JobPool& jobpool
       )
 {
    CPTable cptable;
@@ -240,13 +263,13 @@ void transferLogs(
            iter != cptable.end();
            ++iter)
       {
-         transferLogs(*iter, loglist, period, mausinfo);
+         transferLogs(*iter, loglist, period, mausinfo, searchfilter, jobpool);
       }
    }
    else
    {
       // One CP system
-      transferLogs(cptable.get(), loglist, period, mausinfo);
+      transferLogs(cptable.get(), loglist, period, mausinfo, searchfilter, jobpool);
    }
 }
 
@@ -264,19 +287,28 @@ void usage(t_cmdtype cmdtype, bool multicp, bool usemaus)
       cout << "Usage: clhtran -t transfertype " << cpNameOption << endl
            << "               [-a start_time][-e start_date]" << endl
            << "               [-b stop_time][-f stop_date]" << mausOption
-           << "[log...]" << endl;
+           << "[log...]" << endl
+           << "               [-g search_string [-r][-i]][-j threads]" << endl
+           << "               [-p compression_threads][-z compression_level]" << endl
+           << "               [-w read_bandwidth][-u cpu_share][-s]" << endl;
       break;
 
    case e_xputran:
       cout << "Usage: xputran -t transfertype " << cpNameOption << endl
            << "               [-a start_time][-e start_date]" << endl
-           << "               [-b stop_time][-f stop_date][log...]" << endl;
+           << "               [-b stop_time][-f stop_date][log...]" << endl
+           << "               [-g search_string [-r][-i]][-j threads]" << endl
+           << "               [-p compression_threads][-z compression_level]" << endl
+           << "               [-w read_bandwidth][-u cpu_share][-s]" << endl;
       break;
 
    case e_tesrvtran:
       cout << "Usage: tesrvtran -t transfertype " << cpNameOption << endl
            << "                 [-a start_time][-e start_date]" << endl
-           << "                 [-b stop_time][-f stop_date]" << endl;
+           << "                 [-b stop_time][-f stop_date]" << endl
+           << "                 [-g search_string [-r][-i]][-j threads]" << endl
+           << "                 [-p compression_threads][-z compression_level]" << endl
+           << "                 [-w read_bandwidth][-u cpu_share][-s]" << endl;
       break;
 
    default:
@@ -340,6 +372,15 @@ int main(int argc, const char* argv[])
       CmdParser::Optarg optStopDate("f");
       CmdParser::Optarg optTransType("t");
       CmdParser::Optarg optMausEP("m");
+      CmdParser::Optarg optSearch("g");
+      CmdParser::Opt optRegex("r");
+      CmdParser::Opt optIcase("i");
+      CmdParser::Optarg optThreads("j");
+      CmdParser::Optarg optZipThreads("p");
+      CmdParser::Optarg optZipLevel("z");
+      CmdParser::Optarg optBandwidth("w");
+      CmdParser::Optarg optCpuShare("u");
+      CmdParser::Opt optSince("s");
 
       // Parse command
       CmdParser cmdparser(argc, argv);
@@ -391,6 +432,17 @@ int main(int argc, const char* argv[])
       {
          cmdparser.fetchOpt(optMausEP);
       }
+      if (cmdparser.fetchOpt(optSearch))
+      {
+         cmdparser.fetchOpt(optRegex);
+         cmdparser.fetchOpt(optIcase);
+      }
+      cmdparser.fetchOpt(optThreads);
+      cmdparser.fetchOpt(optZipThreads);
+      cmdparser.fetchOpt(optZipLevel);
+      cmdparser.fetchOpt(optBandwidth);
+      cmdparser.fetchOpt(optCpuShare);
+      cmdparser.fetchOpt(optSince);
 
       // Log types
       string logname;
@@ -460,6 +512,47 @@ int main(int argc, const char* argv[])
       // End of command check
       cmdparser.check();
 
+      // Search the event text
+      SearchFilter searchfilter;
+      if (optSearch.found())
+      {
+         searchfilter = SearchFilter(optSearch.getArg(), optRegex.found(), optIcase.found());
+      }
+
+      // Logs are transferred in parallel, the archive is the same as when transferred one by one
+      size_t maxthreads(0);
+      if (optThreads.found())
+      {
+         maxthreads = JobPool::getMaxThreads(optThreads.getArg());
+      }
+      JobPool jobpool(maxthreads);
+
+      // Large files are compressed in parallel blocks, the archive is the same for any
+      // number of threads
+      size_t zipthreads(0);
+      if (optZipThreads.found())
+      {
+         zipthreads = JobPool::getMaxThreads(optZipThreads.getArg());
+      }
+      int ziplevel(ZipEntry::s_defaultlevel);
+      if (optZipLevel.found())
+      {
+         ziplevel = ZipWriter::getCompressionLevel(optZipLevel.getArg());
+      }
+
+      // Log reads are paced to protect the log server, read bandwidth in MB/s and CPU
+      // share in percent of all cores
+      uint64_t bandwidth(0);
+      if (optBandwidth.found())
+      {
+         bandwidth = TransferScheduler::getBandwidth(optBandwidth.getArg());
+      }
+      unsigned int cpushare(0);
+      if (optCpuShare.found())
+      {
+         cpushare = TransferScheduler::getCpuShare(optCpuShare.getArg());
+      }
+
       string destination;
       if (optTransType.found())
       {
@@ -712,21 +805,30 @@ int main(int argc, const char* argv[])
          // Change current working directory to archive path
          fs::current_path(archpath);
 
+         // Archive written in-process, the logs are inserted as they are transferred
+         const fs::path& archive = archpath / "archive.zip";
+         ArchiveSession session(archive, zipthreads, ziplevel);
+         TransferScheduler scheduler(bandwidth, cpushare);
+
+         // Incremental transfer, only what was added since the last one
+         TransferCheckpoint checkpoints(supportpath / "clh_checkpoint", optSince.found());
+
          // Execute command
 
          if (optCpName.found())
          {
             // Transfer files for specific CP or blade
-            transferLogs(cpinfo, loglist, period, mausinfo);
+            transferLogs(cpinfo, loglist, period, mausinfo, searchfilter, jobpool);
          }
          else
          {
             // In a multi CP system: Transfer log files for all CP:s and blades
             // In a single CP system: Transfer log files
-            transferLogs(loglist, period, mausinfo);
+            transferLogs(loglist, period, mausinfo, searchfilter, jobpool);
          }
-
-         const fs::path& archive = archpath / "archive.zip";
+         jobpool.run(cout);
+         session.close();
+         scheduler.report(cout);
 
          if (fs::exists(archive))
          {
@@ -735,6 +837,7 @@ int main(int argc, const char* argv[])
             {
                // Move archive to ftp volume
                fs::rename(archive, supportpath / archfile);
+               checkpoints.commit();
 
                  // Transfer finished, remove temporary files
                fs::remove_all(temppath);
@@ -759,6 +862,7 @@ int main(int argc, const char* argv[])
                
                // Execute in background
                Common::emfpoll(archfile);
+               checkpoints.commit();
 
                // Copying finished, remove temporary files
                fs::remove_all(temppath);
@@ -40,8 +40,12 @@
 #define APPENDTASK_H_
 
 #include "basetask.h"
+#include "segment.h"
 #include <boost/filesystem/fstream.hpp>
 #include <iostream>
+#include <vector>
+#include <map>
+#include <set>
 
 namespace fs = boost::filesystem;
 
@@ -57,6 +61,8 @@ void printLogEvent(
 
 class AppendTask: public BaseTask
 {
+   friend class LogCursor;
+
 public:
 
    // Constructor
@@ -72,9 +78,11 @@ public:
    void close();
 
    // Check integrity of log file
-   void checkIntegrity(
-         fs::ifstream& fs,             // File stream
-         uintmax_t size                // File size
+   uintmax_t checkIntegrity(           // Returns length up to the end of the last
+                                       // good record, 0 if no record is good
+         std::istream& fs,             // File stream
+         uintmax_t size,               // File size
+         size_t& last                  // Offset to last good record returned
          ) const;
 
    // Insert event message
@@ -93,6 +101,16 @@ public:
          std::ostream& os = std::cout  // Outstream
          ) const;
 
+   // Read events after a checkpoint, the checkpoint is moved to the newest event in
+   // the period
+   Period readEventsSince(             // Returns time for first and last event
+         const Period& period,         // Time period
+         const Filter& filter,         // Search filter
+         t_eventcb eventcb,            // Event callback function
+         std::ostream& os,             // Outstream
+         std::string& checkpoint       // Resume token from LogCursor, empty for the period
+         ) const;
+
    // List time for first and last event
    Period listEvents(                  // Returns time for first and last event
          const Period& period          // Time period
@@ -112,6 +130,9 @@ public:
    // Set Flag for handling SEL log quota
    void enableSELDivider();
 
+   // Get max size of an event message, a subfile holds at least one event
+   static size_t getMaxEventSize();    // Returns size in bytes
+
 protected:
    typedef std::pair<Time, Time> PAIR;
    typedef std::deque<PAIR> FILELIST;
@@ -131,11 +152,17 @@ protected:
          );
 
    // Open file
-   void openFile(
-         const fs::path& path          // File t open
+   bool openFile(                      // Returns false if the file can not be appended to
+         const fs::path& path          // File to open
          );
 
-   fs::fstream m_fs;                   // File stream object
+   // Close file, the file is truncated to its real length
+   void closeFile();
+
+   Segment m_segment;                  // Active log subfile
+   size_t m_filesize;                  // Size of active log subfile
+   size_t m_firstrec;                  // Offset to first record in active log subfile
+   size_t m_lastrec;                   // Offset to last record in active log subfile
 
    bool m_seldivider;                  // Used for SEL log
 
@@ -150,15 +177,218 @@ protected:
 #pragma pack(push)                     // Push current alignment to stack
 #pragma pack(4)                        // Set alignment to 4 bytes boundary
 
+   // Format v1 subfiles start with the first record, its previous address holds
+   // the address to the last record. Format v2 subfiles start with a file header
+   // holding the address to the last record, the first record has no previous.
+   struct t_fileheader
+   {
+      uint32_t m_magic;                // Magic number
+      uint32_t m_version;              // Format version
+      uint64_t m_last;                 // Address to last record, 0 if none
+   };
+
+   // In format v1 the size is a size_t, the upper half (the CRC) is always zero
    struct t_header
    {
       size_t m_prev;                   // Address to previous record
       int64_t m_cptime;                // CP time
       int64_t m_aptime;                // AP time
-      size_t m_size;                   // Size of log event
+      uint32_t m_size;                 // Size of log event
+      uint32_t m_crc;                  // CRC32C of header and event (format v2)
+   };
+
+   struct t_sidecarheader
+   {
+      uint32_t m_magic;                // Magic number
+      uint32_t m_version;              // Format version
+      uint64_t m_value;                // Index: size of indexed subfile
+                                       // Summary: number of entries
+   };
+
+   struct t_indexentry
+   {
+      int64_t m_aptime;                // AP time
+      uint64_t m_offset;               // Address to record
+   };
+
+   struct t_summaryentry
+   {
+      char m_name[64];                 // Subfile name
+      int64_t m_first;                 // AP time for first event
+      int64_t m_last;                  // AP time for last event
+      uint64_t m_size;                 // Subfile size
+      uint32_t m_checksum;             // Checksum of first and last record header
    };
 
 #pragma pack(pop)                      // Restore original alignment from stack
+
+   typedef std::vector<t_indexentry> INDEX;
+   typedef std::map<std::string, t_summaryentry> SUMMARY;
+
+   // Open a sealed subfile that is covered by the manifest
+   bool openFromManifest(              // Returns false if not covered or mismatched
+         const SUMMARY& manifest,      // Manifest from last run
+         const fs::path& path,         // Subfile
+         uintmax_t size,               // Subfile size
+         const std::set<fs::path>& indexlist  // Existing time indexes
+         );
+
+   // Create a manifest entry for a subfile
+   t_summaryentry createSummaryEntry(  // Returns the entry
+         const fs::path& path,         // Subfile
+         const t_header& first,        // First record header
+         const t_header& last,         // Last record header
+         uintmax_t size                // Subfile size
+         ) const;
+
+   // Calculate checksum for the first and last record header of a subfile
+   static uint32_t getChecksum(        // Returns the checksum
+         const t_header& first,        // First record header
+         const t_header& last          // Last record header
+         );
+
+   struct t_batchevent
+   {
+      Time m_cptime;                   // CP time
+      size_t m_offset;                 // Offset to data in batch buffer
+      size_t m_size;                   // Size of log event
+      bool m_issel;                    // Is Sel log
+   };
+
+   typedef std::vector<t_batchevent> BATCH;
+   typedef BATCH::const_iterator BATCHCITER;
+
+   // Add an event message to a batch
+   void addEvent(
+         BATCH& batch,                 // Batch of events
+         const Time& cptime,           // CP time
+         size_t offset,                // Offset to data in batch buffer
+         uintmax_t size,               // Data size
+         bool issel = false            // Is Sel log
+         ) const;
+
+   // Get used size of batch buffer
+   static size_t getBatchSize(
+         const BATCH& batch            // Batch of events
+         );
+
+   // Insert a batch of event messages, the batch is cleared
+   void insertBatch(
+         BATCH& batch,                 // Batch of events
+         const char* data              // Batch buffer
+         );
+
+   // Write records to the end of the active log subfile
+   void writeRecords(
+         std::vector<t_header>& headers,  // Record headers
+         std::vector<const char*>& datav  // Record data
+         );
+
+   struct t_syncstate
+   {
+      size_t m_unsynced;               // Bytes written since last sync
+      uint64_t m_lastsync;             // Monotonic time for last sync in ms
+   };
+
+   // Account for a write according to the durability policy, the state is reset
+   // when a sync is due
+   bool needSync(                      // Returns true if a sync is due
+         t_syncstate& state,           // Sync state
+         size_t written                // Bytes written
+         ) const;
+
+   // Sync the active log subfile according to the durability policy
+   void syncFile(
+         size_t written,               // Bytes written
+         bool force = false            // Sync any unsynced data, unless policy is none
+         );
+
+   // Read the format version and the addresses to the first and last record
+   static uint32_t readFileHeader(     // Returns the format version
+         std::istream& fs,             // File stream
+         size_t& first,                // Offset to first record returned
+         size_t& last                  // Offset to last record returned
+         );
+
+   // Calculate the checksum of a format v2 record
+   static uint32_t getRecordCrc(       // Returns the checksum
+         const t_header& header,       // Record header
+         const char* data              // Record data
+         );
+
+   // Check a record read from a subfile
+   static bool checkRecord(            // Returns false if the record is corrupt
+         uint32_t version,             // Format version
+         const t_header& header,       // Record header
+         const char* data              // Record data
+         );
+
+   // Truncate a subfile after the last good record
+   void truncateFile(
+         const fs::path& path,         // Subfile
+         uint32_t version,             // Format version
+         uintmax_t size,               // New length
+         size_t last                   // Offset to last good record
+         ) const;
+
+   // Get path to the time index of a subfile
+   static fs::path getIndexPath(       // Returns the index path
+         const fs::path& path          // Subfile
+         );
+
+   // Get path to the log summary
+   fs::path getSummaryPath() const;    // Returns the summary path
+
+   // Build the time index of a subfile from its records
+   void buildIndex(
+         std::istream& fs,             // File stream
+         uintmax_t size,               // File size
+         INDEX& index                  // Time index returned
+         ) const;
+
+   // Read the time index of a subfile
+   bool readIndex(                     // Returns false if index is missing or stale
+         const fs::path& path,         // Subfile
+         uintmax_t size,               // Subfile size
+         INDEX& index                  // Time index returned
+         ) const;
+
+   // Write the time index of a subfile
+   void writeIndex(
+         const fs::path& path,         // Subfile
+         uintmax_t size,               // Subfile size
+         const INDEX& index            // Time index
+         ) const;
+
+   // Replace a sidecar file, the data is written to a temporary file that is synced
+   // and renamed into place
+   bool replaceSidecar(                // Returns false if the file could not be written
+         const fs::path& path,         // Sidecar file
+         const std::string& data       // New contents
+         ) const;
+
+   // Read the log summary
+   void readSummary(
+         SUMMARY& summary              // Summary returned, empty if missing
+         ) const;
+
+   // Write the log summary for the sealed subfiles
+   void writeSummary() const;
+
+   // Look up a subfile in the log summary
+   bool findSummary(                   // Returns false if not found or stale
+         const SUMMARY& summary,       // Log summary
+         const fs::path& path,         // Subfile
+         Time& first,                  // Time for first event returned
+         Time& last                    // Time for last event returned
+         ) const;
+
+   // Get real length of a log subfile, preallocated space excluded
+   size_t getRealSize(                 // Returns the real length
+         std::istream& fs,             // File stream
+         uintmax_t size                // File size
+         ) const;
+
    // Create a log subfile name based on time
    std::string createFileName(         // Returns the file name
           const Time& time             // Time
@@ -168,6 +398,7 @@ protected:
    bool parseXmNo(                     // Returns true if XM number was found,
                                        // false otherwise
          const char* data,             // Data string to parse
+         size_t size,                  // Data size
          uint16_t& xmno                // XM number returned
          ) const;
 
@@ -200,8 +431,18 @@ protected:
 
 
    FILELIST m_filelist;         // Log file list
-   char* m_data;               // Data buffer
+   INDEX m_index;              // Time index for active subfile
+   size_t m_indexnext;         // Offset for next time index entry
+   SUMMARY m_summary;          // Manifest of sealed subfiles
+   t_syncstate m_syncstate;    // Sync state for active subfile
    static const boost::regex s_msgnopattern;
+   static const size_t s_indexstep = 4096;         // Bytes between index entries
+   static const uint32_t s_indexmagic = 0x58444943;   // "CIDX"
+   static const uint32_t s_summarymagic = 0x4d555343; // "CSUM"
+   static const uint32_t s_indexversion = 1;
+   static const uint32_t s_summaryversion = 2;
+   static const uint32_t s_filemagic = 0x46484c43;    // "CLHF"
+   static const uint32_t s_fileversion = 2;
 };
 
 }
@@ -0,0 +1,225 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      blockfile.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Classes for compressed log subfiles.
+//      A compressed subfile holds the original subfile split in frames of fixed
+//      size, each frame is compressed on its own so that a reader can seek to any
+//      offset by decompressing only the frame holding it. BlockIfstream reads
+//      compressed and plain subfiles alike.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef BLOCKFILE_H_
+#define BLOCKFILE_H_
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <istream>
+#include <streambuf>
+#include <vector>
+#include <stdint.h>
+
+namespace fs = boost::filesystem;
+
+namespace PES_CLH {
+
+//========================================================================================
+// Class BlockFile
+//========================================================================================
+
+class BlockFile
+{
+public:
+   // Write a compressed copy of a subfile
+   static uintmax_t compress(          // Returns the compressed size
+         const fs::path& path,         // Subfile
+         const fs::path& tmppath       // Temporary file for the compressed data
+         );
+
+   // Replace a compressed subfile with its uncompressed contents
+   static void decompress(
+         const fs::path& path,         // Subfile
+         uintmax_t size                // Number of bytes to keep
+         );
+
+   // Check if a subfile is compressed
+   static bool isCompressed(
+         const fs::path& path          // Subfile
+         );
+
+   // Get the uncompressed size of a subfile
+   static uintmax_t getSize(
+         const fs::path& path,         // Subfile
+         boost::system::error_code& ec // Error code returned
+         );
+
+#pragma pack(push)                     // Push current alignment to stack
+#pragma pack(4)                        // Set alignment to 4 bytes boundary
+
+   struct t_blockheader
+   {
+      uint32_t m_magic;                // Magic number
+      uint32_t m_version;              // Format version
+      uint64_t m_size;                 // Uncompressed size
+      uint32_t m_framesize;            // Uncompressed size of a frame
+      uint32_t m_frames;               // Number of frames
+   };
+
+#pragma pack(pop)                      // Restore original alignment from stack
+
+   static const uint32_t s_magic = 0x5a484c43;        // "CLHZ"
+   static const uint32_t s_version = 1;
+   static const uint32_t s_framesize = 16384;
+
+private:
+   // Flush a written file to disk
+   static bool sync(                   // Returns false if failed, errno is set
+         const fs::path& path          // File
+         );
+};
+
+//========================================================================================
+// Class BlockStreamBuf
+//========================================================================================
+
+class BlockStreamBuf: public std::streambuf
+{
+public:
+   // Constructor
+   BlockStreamBuf();
+
+   // Destructor
+   virtual ~BlockStreamBuf();
+
+   // Open a compressed subfile
+   bool open(                          // Returns false if not a compressed subfile
+         const fs::path& path          // Subfile
+         );
+
+   // Close subfile
+   void close();
+
+   // Get the uncompressed size
+   uintmax_t size() const;
+
+protected:
+   // Read the next frame
+   int_type underflow();
+
+   // Seek to a relative position
+   pos_type seekoff(
+         off_type off,
+         std::ios_base::seekdir dir,
+         std::ios_base::openmode which
+         );
+
+   // Seek to an absolute position
+   pos_type seekpos(
+         pos_type pos,
+         std::ios_base::openmode which
+         );
+
+private:
+   // Disable default copy constructor
+   BlockStreamBuf(const BlockStreamBuf&);
+
+   // Disable default assignment operator
+   BlockStreamBuf& operator=(const BlockStreamBuf&);
+
+   // Decompress a frame into the read buffer
+   bool loadFrame(                     // Returns false if the frame is corrupt
+         uint32_t frame                // Frame number
+         );
+
+   fs::ifstream m_file;                // Compressed subfile
+   BlockFile::t_blockheader m_header;  // Subfile header
+   std::vector<uint64_t> m_offsets;    // Offsets to the frames
+   std::vector<char> m_buffer;         // Uncompressed frame
+   std::vector<char> m_cbuffer;        // Compressed frame
+   uint64_t m_base;                    // Offset to the start of the read buffer
+   uint32_t m_frame;                   // Frame in the read buffer
+};
+
+//========================================================================================
+// Class BlockIfstream
+//========================================================================================
+
+class BlockIfstream: public std::istream
+{
+public:
+   // Constructor
+   BlockIfstream();
+
+   // Constructor
+   explicit BlockIfstream(
+         const fs::path& path          // Subfile
+         );
+
+   // Destructor
+   virtual ~BlockIfstream();
+
+   // Open a compressed or plain subfile
+   void open(
+         const fs::path& path          // Subfile
+         );
+
+   // Check if subfile is open
+   bool is_open() const;
+
+   // Close subfile
+   void close();
+
+   // Check if subfile is compressed
+   bool isCompressed() const;
+
+   // Get the uncompressed size
+   uintmax_t size() const;
+
+private:
+   // Disable default copy constructor
+   BlockIfstream(const BlockIfstream&);
+
+   // Disable default assignment operator
+   BlockIfstream& operator=(const BlockIfstream&);
+
+   std::filebuf m_filebuf;             // Plain subfile
+   BlockStreamBuf m_blockbuf;          // Compressed subfile
+   bool m_isopen;                      // Subfile is open
+   bool m_compressed;                  // Subfile is compressed
+   uintmax_t m_size;                   // Uncompressed size
+};
+
+}
+
+#endif // BLOCKFILE_H_
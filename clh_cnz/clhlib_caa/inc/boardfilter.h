@@ -58,18 +58,37 @@ public:
    // Check if filter is empty
    bool empty() const;               // Returns true if empty, false otherwise
 
+   // Check if the filter reads the event data
+   bool needsData() const;           // Returns true if data is needed
+
    // Test filter match
    bool test(                        // Return true if matched, false otherwise
-         const std::string& str      // String to be matched towards the filter
+         const char* data,           // Data to be matched towards the filter
+         size_t size                 // Data size
          ) const;
 
+   using Filter::test;
+
 private:
-   std::string getItem(              // Returns item to be parsed
-         const std::string& label,   // Label to be parsed
-         const std::string& str, 
-         size_t& pos
+   bool getItem(                     // Returns false if the label is not found
+         const char* label,          // Label to be parsed
+         const char*& pos,           // Position in data, moved to next line
+         const char* end,            // End of data
+         const char*& item,          // Item returned
+         const char*& itemend        // End of item returned
          ) const;
 
+   static bool parseNumber(          // Returns false if not a number
+         const char* pos,            // Start of number
+         const char* end,            // End of number
+         uint32_t max,               // Max value
+         uint32_t& value             // Value returned
+         );
+
+   static const char s_traplabel[];
+   static const char s_subracklabel[];
+   static const char s_slotlabel[];
+
    Magazine m_magazine;
    Slot m_slot;
 };
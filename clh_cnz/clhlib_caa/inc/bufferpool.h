@@ -0,0 +1,124 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      bufferpool.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Process wide pool of message buffers.
+//      A buffer holds one log event of maximum size. Buffers are borrowed by the
+//      ingest and query paths and returned to the pool when they go out of scope,
+//      a limited number of idle buffers is kept for reuse. The high-water mark for
+//      buffers in use is reported to the internal log.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef BUFFERPOOL_H_
+#define BUFFERPOOL_H_
+
+#include <boost/thread.hpp>
+#include <boost/thread/once.hpp>
+#include <vector>
+#include <stddef.h>
+
+namespace PES_CLH {
+
+class BufferPool
+{
+public:
+   // Buffer borrowed from the pool, the buffer is returned when it goes out of scope
+   class Buffer
+   {
+   public:
+      // Constructor, a buffer is borrowed from the pool
+      Buffer();
+
+      // Destructor, the buffer is returned to the pool
+      ~Buffer();
+
+      // Get the buffer
+      char* get() const;
+
+      // Get the buffer size
+      static size_t size();
+
+   private:
+      // Disable default copy constructor
+      Buffer(const Buffer&);
+
+      // Disable default assignment operator
+      Buffer& operator=(const Buffer&);
+
+      char* m_data;                    // Buffer
+   };
+
+   // Get number of buffers in use
+   static size_t getInUse();
+
+   // Get the high-water mark for buffers in use
+   static size_t getHighWater();
+
+private:
+   // Constructor
+   BufferPool();
+
+   // Disable default copy constructor
+   BufferPool(const BufferPool&);
+
+   // Disable default assignment operator
+   BufferPool& operator=(const BufferPool&);
+
+   // Get the pool
+   static BufferPool& instance();
+
+   // Create the pool
+   static void create();
+
+   // Borrow a buffer
+   char* acquire();                    // Returns the buffer
+
+   // Return a buffer
+   void release(
+         char* data                    // Buffer
+         );
+
+   std::vector<char*> m_free;          // Idle buffers
+   size_t m_inuse;                     // Buffers in use
+   size_t m_highwater;                 // High-water mark for buffers in use
+   boost::mutex m_mutex;               // Mutex
+
+   static BufferPool* s_instance;      // The pool, never deleted
+   static boost::once_flag s_once;     // Create the pool once
+   static const size_t s_maxfree = 4;  // Max number of idle buffers kept
+};
+
+}
+
+#endif // BUFFERPOOL_H_
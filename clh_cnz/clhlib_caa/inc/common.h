@@ -41,12 +41,18 @@
 #define COMMON_H_
 
 #include <string>
+#include <vector>
 #include <boost/filesystem.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 
 namespace fs = boost::filesystem;
 
 namespace PES_CLH {
 
+class ZipEntry;
+class ZipWriter;
+
 class Common
 {
 public:
@@ -64,6 +70,8 @@ public:
        AP1 = 0,
        AP2 = 1
    };
+   typedef std::vector<boost::function<void ()> > ARCHIVELIST;
+
    // Get software version
    static std::string getVersion(               // Returns software version information
          const std::string& swunit              // Software unit
@@ -82,12 +90,34 @@ public:
          std::ostream& os                       // Stream containing output
          );
 
-   // Create archive file
+   // Create archive file, or insert in the archive of the current session
+   // where the destination is not used. The source is removed.
    static void archive(
          const fs::path& source,                // Source path
          const fs::path& dest                   // Destination path
          );
 
+   // Insert an entry compressed in memory in the archive of the current session
+   static void archive(
+         const std::string& name,               // Entry name
+         const boost::shared_ptr<ZipEntry>& entryp // Entry
+         );
+
+   // Get the archive of the current session of the calling thread
+   static ZipWriter* getArchive();              // Returns archive writer, null if none
+
+   // Set archive for the insertions made by the calling thread, a null pointer ends
+   // the session
+   static void setArchive(
+         ZipWriter* writerp                     // Archive writer
+         );
+
+   // Defer archive insertions made by the calling thread, they are stored in
+   // the list instead of being executed. A null pointer ends the deferral.
+   static void setArchiveList(
+         ARCHIVELIST* archivelistp              // List of deferred insertions
+         );
+
    // Get data disk path
    static fs::path getDataDiskPath(             // Returns data disk path
          const std::string& logicalName         // Logical disk path
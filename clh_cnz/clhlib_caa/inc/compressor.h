@@ -0,0 +1,114 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      compressor.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Class for background compression of sealed log subfiles.
+//      Subfiles are compressed one at a time by a worker thread. The compressed
+//      subfile replaces the original only if the original is unchanged, subfiles
+//      that are removed or appended to again must be reported to the compressor.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef COMPRESSOR_H_
+#define COMPRESSOR_H_
+
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include <boost/thread/once.hpp>
+#include <deque>
+
+namespace fs = boost::filesystem;
+
+namespace PES_CLH {
+
+class Compressor
+{
+public:
+   // Queue a sealed subfile for compression
+   static void add(
+         const fs::path& path          // Subfile
+         );
+
+   // Cancel compression of a subfile that is to be appended to
+   static void cancel(
+         const fs::path& path          // Subfile
+         );
+
+   // Remove a subfile, a compression in progress for the subfile is cancelled
+   static void remove(
+         const fs::path& path          // Subfile
+         );
+
+private:
+   // Constructor
+   Compressor();
+
+   // Disable default copy constructor
+   Compressor(const Compressor&);
+
+   // Disable default assignment operator
+   Compressor& operator=(const Compressor&);
+
+   // Get the compressor, the worker thread is started at first use
+   static Compressor& instance();
+
+   // Create the compressor
+   static void create();
+
+   // Worker thread, compress subfiles from the queue
+   void run();
+
+   // Compress a subfile
+   void compress(
+         const fs::path& path          // Subfile
+         );
+
+   // Remove a subfile from the queue, the mutex must be locked
+   void dequeue(
+         const fs::path& path          // Subfile
+         );
+
+   std::deque<fs::path> m_queue;       // Subfiles to compress
+   fs::path m_current;                 // Subfile being compressed
+   bool m_cancelled;                   // Set if the current compression is cancelled
+   boost::mutex m_mutex;               // Mutex
+   boost::condition_variable m_cond;   // Signalled when a subfile is queued
+   boost::thread m_thread;             // Worker thread
+
+   static Compressor* s_instance;      // The compressor, never deleted
+   static boost::once_flag s_once;     // Create the compressor once
+};
+
+}
+
+#endif // COMPRESSOR_H_
@@ -0,0 +1,83 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      crc32c.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      CRC32C (Castagnoli) checksum for the log record headers.
+//      The SSE4.2 CRC32 instruction is used when the processor supports it,
+//      otherwise a table driven implementation is used.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef CRC32C_H_
+#define CRC32C_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace PES_CLH {
+
+class Crc32c
+{
+public:
+   // Update a checksum with a block of data
+   static uint32_t update(             // Returns the new checksum
+         uint32_t crc,                 // Checksum so far, 0 for the first block
+         const void* data,             // Data block
+         size_t size                   // Data size
+         );
+
+   // Check if the CRC32 instruction is used
+   static bool isHardware();
+
+private:
+   // Calculate checksum with the CRC32 instruction
+   static uint32_t updateHardware(
+         uint32_t crc,                 // Inverted checksum so far
+         const unsigned char* data,    // Data block
+         size_t size                   // Data size
+         );
+
+   // Calculate checksum with the lookup table
+   static uint32_t updateSoftware(
+         uint32_t crc,                 // Inverted checksum so far
+         const unsigned char* data,    // Data block
+         size_t size                   // Data size
+         );
+
+   static const bool s_hardware;       // Set if the CRC32 instruction is supported
+   static const uint32_t s_poly = 0x82f63b78;   // Reflected Castagnoli polynomial
+};
+
+}
+
+#endif // CRC32C_H_
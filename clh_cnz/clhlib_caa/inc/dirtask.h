@@ -103,6 +103,12 @@ protected:
          const std::string& file2
          );
 
+   // Check if the date and time part of a subfile name is before a time
+   static bool isKeyBefore(            // Returns true if before the time
+         const std::string& key,       // Date and time, "YYYYMMDD_HHMMSS"
+         const Time& time              // Time
+         );
+
    FILELISTITER getDivIter();
 
    void maintainLogSize();
@@ -144,6 +144,11 @@ public:
    static t_error illToUseWithSingleSidedCP(void);
    static t_error mausLogsNotSupported(const std::string& logtype);
    static t_error illEndpoint(const std::string& ep);
+   static t_error illSearchPattern(const std::string& pattern);
+   static t_error illNoOfThreads(const std::string& threads);
+   static t_error illCompressionLevel(const std::string& level);
+   static t_error illBandwidth(const std::string& bandwidth);
+   static t_error illCpuShare(const std::string& cpushare);
 
 protected:
    uint16_t m_errcode;              // Error code
@@ -114,6 +114,23 @@ private:
          const std::string& file2
          );
 
+   // Get the date and time part of a log subfile name, "YYYYMMDD_HHMMSS".
+   // The parts sort in time order.
+   static std::string getTimeKey(      // Returns the date and time
+         const std::string& file       // Subfile name
+         );
+
+   // Get time from the date and time part of a subfile name
+   static Time getKeyTime(             // Returns the time
+         const std::string& key        // Date and time, "YYYYMMDD_HHMMSS"
+         );
+
+   // Check if the date and time part of a subfile name is before a time
+   static bool isKeyBefore(            // Returns true if before the time
+         const std::string& key,       // Date and time, "YYYYMMDD_HHMMSS"
+         const Time& time              // Time
+         );
+
    void copyFile(
          const fs::path& source,
          const fs::path& target,
@@ -40,6 +40,8 @@
 #define FILTER_H_
 
 #include <iostream>
+#include <string>
+#include <stddef.h>
 
 namespace PES_CLH {
 
@@ -61,11 +63,24 @@ public:
    // Check if filter is empty
    virtual bool empty() const = 0;  // Returns true if empty, false otherwise
 
+   // Check if the filter reads the event data, if not the data need not be read
+   virtual bool needsData() const = 0; // Returns true if data is needed
+
    // Test filter match
    virtual bool test(               // Return true if matched, false otherwise
-         const std::string& str     // String to be matched towards the filter
+         const char* data,          // Data to be matched towards the filter,
+                                    // not null terminated
+         size_t size                // Data size
          ) const = 0;
 
+   // Test filter match
+   bool test(                       // Return true if matched, false otherwise
+         const std::string& str     // String to be matched towards the filter
+         ) const
+   {
+      return test(str.data(), str.size());
+   }
+
 private:
 };
 
@@ -86,15 +101,69 @@ public:
       return true;
    }
 
+   // Check if the filter reads the event data
+   bool needsData() const           // Returns false
+   {
+      return false;
+   }
+
    // Test filter match
    bool test(                      // Returns true
-         const std::string&        // Not used
+         const char*,              // Not used
+         size_t                    // Not used
          ) const
    {
       return true;
    }
 
+   using Filter::test;
+
+private:
+};
+
+class AndFilter: public Filter
+{
+public:
+   // Constructor, the filters must outlive this object
+   AndFilter(
+         const Filter& first,      // First filter
+         const Filter& second      // Second filter
+         ):
+   Filter(),
+   m_first(first),
+   m_second(second)
+   {
+   }
+
+   // Destructor
+   virtual ~AndFilter() {};
+
+   // Check if filter is empty
+   bool empty() const               // Returns true if both filters are empty
+   {
+      return m_first.empty() && m_second.empty();
+   }
+
+   // Check if the filter reads the event data
+   bool needsData() const           // Returns true if any filter needs data
+   {
+      return m_first.needsData() || m_second.needsData();
+   }
+
+   // Test filter match
+   bool test(                       // Return true if both filters matched
+         const char* data,          // Data to be matched towards the filters
+         size_t size                // Data size
+         ) const
+   {
+      return m_first.test(data, size) && m_second.test(data, size);
+   }
+
+   using Filter::test;
+
 private:
+   const Filter& m_first;
+   const Filter& m_second;
 };
 
 }
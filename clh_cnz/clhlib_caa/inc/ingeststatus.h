@@ -0,0 +1,107 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      ingeststatus.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Ingest status published by the log server to the transfer commands.
+//      The log server records in a small memory mapped file when it handles
+//      a temporary log file and how long the file waited. A transfer backs
+//      off while the log server is behind.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef INGESTSTATUS_H_
+#define INGESTSTATUS_H_
+
+#include <boost/filesystem.hpp>
+#include <stdint.h>
+
+namespace fs = boost::filesystem;
+
+namespace PES_CLH {
+
+class IngestStatus
+{
+public:
+   // Constructor
+   IngestStatus();
+
+   // Destructor
+   ~IngestStatus();
+
+   // Create the status file, done by the log server. A failure is logged and the
+   // status is then not published.
+   void create();
+
+   // Handling of a temporary log file is started
+   void startEvent(
+         const fs::path& path          // Temporary log file
+         );
+
+   // Handling of the temporary log file is finished
+   void endEvent();
+
+   // Check if the log server is behind
+   static bool isBacklogged();         // Returns true if the log server is behind
+
+private:
+   // Disable default copy constructor
+   IngestStatus(const IngestStatus&);
+
+   // Disable default assignment operator
+   IngestStatus& operator=(const IngestStatus&);
+
+   // Times are in microseconds from the monotonic clock, except the lag
+   struct t_status
+   {
+      uint32_t m_version;              // Status format version
+      uint32_t m_spare;                // Spare, for alignment
+      int64_t m_busysince;             // Start of the current event, 0 when idle
+      int64_t m_lag;                   // Age of the latest temporary file when handled
+      int64_t m_updated;               // Time of the latest event
+   };
+
+   // Get monotonic time in microseconds
+   static int64_t getMonotonic();
+
+   volatile t_status* m_statusp;       // Mapped status, null if not published
+
+   static const char* const s_path;    // Status file
+   static const uint32_t s_version;    // Status format version
+   static const int64_t s_maxlag;      // Longest lag without backlog
+   static const int64_t s_maxbusy;     // Longest event without backlog
+   static const int64_t s_stale;       // Age when the latest lag is no longer used
+};
+
+}
+
+#endif // INGESTSTATUS_H_
@@ -0,0 +1,185 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      jobpool.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Pool of worker threads running independent command jobs, e.g. reading or
+//      transferring one log for one CP side.
+//      The first unfinished job in order writes its printout directly to the
+//      stream. The other jobs buffer their printouts, and a job is blocked when
+//      its buffer is full until it is the first job. Workers start jobs only a
+//      few jobs ahead of the first job, so the buffered printouts are bounded.
+//      Archive insertions are deferred. The workers use the archive session,
+//      the transfer checkpoints and the transfer scheduler of the thread that
+//      runs the pool. The printouts are written and the archive insertions
+//      executed in the order the jobs were added, so the result is the same as
+//      when the jobs are run one after another.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef JOBPOOL_H_
+#define JOBPOOL_H_
+
+#include "common.h"
+#include "exception.h"
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread.hpp>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+
+namespace PES_CLH {
+
+class TransferCheckpoint;
+class TransferScheduler;
+
+class JobPool
+{
+public:
+   typedef boost::function<void (std::ostream&)> t_job;
+
+   // Constructor
+   JobPool(
+         size_t maxthreads             // Max number of worker threads, 0 for default
+         );
+
+   // Destructor
+   ~JobPool();
+
+   // Add a job
+   void add(
+         const t_job& job              // Job, writes its printout to the stream
+         );
+
+   // Run all jobs, the first error in job order is thrown
+   void run(
+         std::ostream& os              // Stream for the printouts
+         );
+
+   // Parse the max number of worker threads from a command option argument
+   static size_t getMaxThreads(        // Returns max number of threads
+         const std::string& arg        // Option argument
+         );
+
+private:
+   // Disable default copy constructor
+   JobPool(const JobPool&);
+
+   // Disable default assignment operator
+   JobPool& operator=(const JobPool&);
+
+   // Printout of a job, buffered until the job is the first unfinished job
+   class Output: public std::streambuf
+   {
+   public:
+      Output();
+      ~Output();
+
+      // Write the buffered printout to the stream, and the rest of the printout
+      // directly as it is written
+      void attach(
+            std::ostream& os           // Stream for the printout
+            );
+
+      // Discard the rest of the printout, a blocked job is released
+      void discard();
+
+   protected:
+      int_type overflow(int_type ch);
+      int sync();
+
+   private:
+      // Write the put area to the stream or to the buffer, blocks while the
+      // buffer is full
+      void flush();
+
+      std::vector<char> m_putarea;     // Data not yet written or buffered
+      std::vector<char> m_buffer;      // Buffered printout
+      std::ostream* m_osp;             // Stream written directly, null while buffered
+      bool m_discard;                  // Printout is discarded
+      boost::mutex m_mutex;            // Mutex
+      boost::condition_variable m_cond;   // Signalled when attached or discarded
+   };
+
+   struct t_entry
+   {
+      t_entry(const t_job& job): m_job(job), m_output(), m_archivelist(), m_done(false), m_errorp() {}
+
+      t_job m_job;                           // Job to run
+      Output m_output;                       // Printout
+      Common::ARCHIVELIST m_archivelist;     // Deferred archive insertions
+      bool m_done;                           // Job is finished
+      boost::shared_ptr<Exception> m_errorp; // Error if the job failed
+   };
+
+   typedef boost::shared_ptr<t_entry> ENTRYPTR;
+   typedef std::vector<ENTRYPTR> ENTRYLIST;
+
+   // Worker thread, run jobs until there are no more jobs
+   void worker();
+
+   // Transfer state of the thread that runs the pool, used by the workers
+   struct t_session
+   {
+      t_session(): m_writerp(0), m_checkpointp(0), m_schedulerp(0) {}
+
+      ZipWriter* m_writerp;                  // Archive, null if none
+      TransferCheckpoint* m_checkpointp;     // Checkpoints, null if none
+      TransferScheduler* m_schedulerp;       // Scheduler, null if none
+   };
+
+   // Run a job in the calling thread
+   static void execute(
+         t_entry& entry,               // Job entry
+         const t_session& session      // Transfer state for the job
+         );
+
+   size_t m_maxthreads;                // Max number of worker threads
+   t_session m_session;                // Transfer state of the caller of run
+   ENTRYLIST m_entrylist;              // Jobs
+   size_t m_next;                      // Next job to start
+   size_t m_first;                     // First unfinished job in order
+   size_t m_maxahead;                  // Max number of jobs started from the first
+   boost::mutex m_mutex;               // Mutex
+   boost::condition_variable m_cond;   // Signalled when a job is finished or the
+                                       // first job is advanced
+
+   static const size_t s_defaultthreads;  // Default max number of worker threads
+   static const size_t s_maxthreads;      // Highest allowed max number of threads
+   static const size_t s_maxbuffer;       // Max printout buffered by a job
+};
+
+}
+
+#endif // JOBPOOL_H_
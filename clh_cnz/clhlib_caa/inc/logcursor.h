@@ -0,0 +1,268 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      logcursor.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Cursor over the events of an append type log.
+//      The cursor is positioned by time and steps forwards or backwards over the
+//      events in all log subfiles. One subfile at a time is held in a buffer
+//      borrowed from the buffer pool, the header fields and the event data are
+//      read directly from the buffer. The memory used is independent of the
+//      number of events in the log.
+//      A resume token names an event by subfile, record offset and AP time. A read
+//      resumed from a token loads the subfile only from the record onwards.
+//      When the cursor is positioned by time, a sealed subfile is loaded only
+//      around the time, the part is found in the time index of the subfile.
+//      Stepping past the loaded part loads the rest of the subfile.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef LOGCURSOR_H_
+#define LOGCURSOR_H_
+
+#include "appendtask.h"
+#include "bufferpool.h"
+#include "ltime.h"
+#include <boost/filesystem.hpp>
+#include <string>
+#include <vector>
+
+namespace fs = boost::filesystem;
+
+namespace PES_CLH {
+
+class LogCursor
+{
+public:
+   // Position of an event, valid for the cursor that returned it
+   struct t_position
+   {
+      size_t m_file;                   // Index in the subfile list
+      size_t m_offset;                 // Offset to the record in the subfile
+      int64_t m_aptime;                // AP time
+   };
+
+   // Constructor, the cursor is not positioned
+   LogCursor(
+         const AppendTask& task        // Log task
+         );
+
+   // Destructor
+   ~LogCursor();
+
+   // Position at the first event in the log
+   bool seekFirst();                   // Returns false if the log is empty
+
+   // Position at the last event in the log
+   bool seekLast();                    // Returns false if the log is empty
+
+   // Position at the first event at or after a time
+   bool seek(                          // Returns false if no such event
+         const Time& time              // AP time
+         );
+
+   // Position at the last event at or before a time
+   bool seekBefore(                    // Returns false if no such event
+         const Time& time              // AP time
+         );
+
+   // Position at the first event after the event named by a resume token. If the
+   // subfile is gone or no longer holds the event, the cursor is positioned at the
+   // first event after the AP time in the token.
+   bool seekAfter(                     // Returns false if no such event
+         const std::string& token      // Resume token
+         );
+
+   // Find the AP time for the first event at or after a time. Only the first and last
+   // record of the subfiles are read, unless the time is inside a subfile.
+   // The cursor is left unpositioned.
+   bool findTime(                      // Returns false if no such event
+         const Time& time,             // AP time
+         Time& found                   // AP time for the event returned
+         );
+
+   // Find the AP time for the last event at or before a time. Only the first and last
+   // record of the subfiles are read, unless the time is inside a subfile.
+   // The cursor is left unpositioned.
+   bool findTimeBefore(                // Returns false if no such event
+         const Time& time,             // AP time
+         Time& found                   // AP time for the event returned
+         );
+
+   // Step to the next event
+   bool next();                        // Returns false if the last event is passed
+
+   // Step to the previous event
+   bool prev();                        // Returns false if the first event is passed
+
+   // Check if the cursor is positioned at an event
+   bool isValid() const;
+
+   // Get CP time for the event
+   Time getCPTime() const;
+
+   // Get AP time for the event
+   Time getAPTime() const;
+
+   // Get CP time stamp for the event, not validated
+   TimeStamp getCPStamp() const;
+
+   // Get AP time stamp for the event, not validated
+   TimeStamp getAPStamp() const;
+
+   // Get size of the event data
+   size_t getSize() const;
+
+   // Get the event data, valid until the cursor is moved
+   const char* getData() const;
+
+   // Get path to the subfile holding the event
+   const fs::path& getPath() const;
+
+   // Get position of the event
+   t_position getPosition() const;
+
+   // Get resume token for an event
+   std::string getToken(               // Returns the token
+         const t_position& position    // Position of the event
+         ) const;
+
+private:
+   // Disable default copy constructor
+   LogCursor(const LogCursor&);
+
+   // Disable default assignment operator
+   LogCursor& operator=(const LogCursor&);
+
+   typedef std::vector<fs::path> FILELIST;
+   typedef std::vector<size_t> RECORDLIST;
+
+   // Times for the first and last event in a subfile
+   struct t_bounds
+   {
+      t_bounds(): m_state(e_unknown), m_first(0), m_last(0), m_size(0) {}
+
+      enum {e_unknown, e_valid, e_invalid} m_state;
+      int64_t m_first;                 // AP time for first event
+      int64_t m_last;                  // AP time for last event
+      uint64_t m_size;                 // Real size of a sealed subfile, 0 if not sealed
+   };
+
+   typedef std::vector<t_bounds> BOUNDSLIST;
+
+   // Get times for the first and last event in a subfile, from the summary or from the
+   // first and last record. The result is cached.
+   bool getBounds(                     // Returns false if the subfile is empty or damaged
+         size_t file,                  // Index in the subfile list
+         int64_t& first,               // AP time for first event returned
+         int64_t& last                 // AP time for last event returned
+         );
+
+   // Read the header of a record without loading the subfile
+   static bool readRecordHeader(       // Returns false if the record is corrupt
+         std::istream& fs,             // File stream
+         uint32_t version,             // Format version
+         size_t offset,                // Offset to the record
+         uintmax_t size,               // Real size of the subfile
+         AppendTask::t_header& header  // Record header returned
+         );
+
+   // Find the first subfile that may hold an event at or after a time
+   size_t findFile(                    // Returns index in the subfile list
+         int64_t time                  // AP time
+         );
+
+   // Find the subfile after the last subfile that may hold an event at or before a time
+   size_t findFileBefore(              // Returns index in the subfile list
+         int64_t time                  // AP time
+         );
+
+   // Find the part of a sealed subfile that holds the event at a time, from the time
+   // index of the subfile. The whole subfile is returned if it has no valid index.
+   void findRange(
+         size_t file,                  // Index in the subfile list
+         int64_t time,                 // AP time
+         bool after,                   // true for the first event at or after the time,
+                                       // false for the last event at or before the time
+         size_t& from,                 // Offset to the oldest record to load returned
+         size_t& to                    // Offset to the oldest record not to load returned,
+                                       // 0 for the end of the subfile
+         );
+
+   // Load a subfile and build its list of records
+   bool loadFile(                      // Returns false if the subfile has no events
+         size_t file,                  // Index in the subfile list
+         size_t from = 0,              // Offset to the oldest record to load, the older
+                                       // records are skipped
+         size_t to = 0                 // Offset to the oldest record not to load, the
+                                       // newer records are skipped. 0 for all records.
+         );
+
+   // Position at a record in the loaded subfile
+   void setRecord(
+         size_t record                 // Index in the record list
+         );
+
+   // Get the header of a record in the loaded subfile
+   AppendTask::t_header getHeader(     // Returns the header
+         size_t record                 // Index in the record list
+         ) const;
+
+   // Find the first record in the loaded subfile at or after a time
+   size_t findRecord(                  // Returns the index in the record list
+         int64_t time                  // AP time
+         ) const;
+
+   // Find the first record in the loaded subfile after a time
+   size_t findRecordAfter(             // Returns the index in the record list
+         int64_t time                  // AP time
+         ) const;
+
+   const AppendTask& m_task;           // Log task
+   FILELIST m_filelist;                // Log subfiles, oldest first
+   AppendTask::SUMMARY m_summary;      // Times for sealed subfiles
+   BOUNDSLIST m_bounds;                // Times for the subfiles, read on demand
+   BufferPool::Buffer m_buffer;        // Loaded subfile
+   size_t m_file;                      // Index of loaded subfile, npos if none
+   size_t m_base;                      // Offset in the subfile to the loaded data
+   size_t m_limit;                     // Offset to the first record not loaded, 0 if the
+                                       // subfile is loaded to the end
+   RECORDLIST m_records;               // Offsets to the records in the loaded subfile
+   size_t m_record;                    // Index of current record, npos if none
+   AppendTask::t_header m_header;      // Header of the current record
+
+   static const size_t npos = static_cast<size_t>(-1);
+};
+
+}
+
+#endif // LOGCURSOR_H_
@@ -0,0 +1,171 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      logmerger.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Merged time ordered view over the events of several append type logs.
+//      A cursor is opened on each log and the cursors are merged with a heap,
+//      oldest event first, on AP time or CP time. Only the current subfile of
+//      each log is held in memory. Events with the same time are given in the
+//      order the logs were added.
+//      A merge on CP time is exact only for logs where the CP time follows the
+//      AP time order, logs without CP time are merged on AP time.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef LOGMERGER_H_
+#define LOGMERGER_H_
+
+#include "logcursor.h"
+#include "ltime.h"
+#include <boost/shared_ptr.hpp>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace PES_CLH {
+
+// Print a merged log event to the stream, the event is preceded by the tag
+void printMergedEvent(
+      const std::string& tag,
+      const Time& cptime,
+      const Time& aptime,
+      size_t size,
+      const char* buf,
+      std::ostream& os
+      );
+
+class LogMerger
+{
+public:
+   enum t_key
+   {
+      e_aptime,                        // Merge on AP time
+      e_cptime                         // Merge on CP time
+   };
+
+   // Constructor
+   LogMerger(
+         t_key key                     // Merge key
+         );
+
+   // Destructor
+   ~LogMerger();
+
+   // Add a log, the task must outlive the merger
+   void add(
+         const AppendTask& task,       // Log task
+         const std::string& tag        // Tag naming the log in the merged view
+         );
+
+   // Position at the oldest event in the period
+   bool seek(                          // Returns false if no event in the period
+         const Period& period          // Period, in AP time
+         );
+
+   // Step to the next event in the period
+   bool next();                        // Returns false if the period is passed
+
+   // Get index of the log holding the event, in the order the logs were added
+   size_t getSource() const;
+
+   // Get tag for the log holding the event
+   const std::string& getTag() const;
+
+   // Get CP time for the event
+   Time getCPTime() const;
+
+   // Get CP time for the event in long format
+   std::string getCPTimeText() const;  // Returns empty string if the event has no
+                                       // CP time, as the SEL events
+
+   // Get AP time for the event
+   Time getAPTime() const;
+
+   // Get size of the event data
+   size_t getSize() const;
+
+   // Get the event data, valid until the merger is moved
+   const char* getData() const;
+
+private:
+   // Disable default copy constructor
+   LogMerger(const LogMerger&);
+
+   // Disable default assignment operator
+   LogMerger& operator=(const LogMerger&);
+
+   struct t_source
+   {
+      std::string m_tag;                     // Tag naming the log
+      boost::shared_ptr<LogCursor> m_cursorp;   // Cursor on the log
+      TimeStamp m_time;                      // Merge key of the current event
+   };
+
+   typedef std::vector<t_source> SOURCELIST;
+   typedef std::vector<size_t> HEAP;
+
+   // Heap order, the source with the oldest event is at the top
+   class Later
+   {
+   public:
+      Later(const SOURCELIST& sourcelist): m_sourcelist(sourcelist) {}
+
+      bool operator()(size_t left, size_t right) const
+      {
+         const TimeStamp& ltime = m_sourcelist[left].m_time;
+         const TimeStamp& rtime = m_sourcelist[right].m_time;
+         if (ltime > rtime) return true;
+         if (rtime > ltime) return false;
+         return left > right;
+      }
+
+   private:
+      const SOURCELIST& m_sourcelist;
+   };
+
+   // Check that the cursor of a source is in the period and set its merge key
+   bool update(                        // Returns false if the period is passed
+         t_source& source              // Source
+         );
+
+   const LogCursor& current() const;   // Returns cursor at the current event
+
+   t_key m_key;                        // Merge key
+   SOURCELIST m_sourcelist;            // Merged logs
+   HEAP m_heap;                        // Sources with events left in the period
+   TimeStamp m_last;                   // Last AP time in the period
+};
+
+}
+
+#endif // LOGMERGER_H_
@@ -44,6 +44,7 @@
 #include <iostream>
 #include <sys/time.h>
 #include <stdint.h>
+#include <time.h>
 
 namespace PES_CLH {
 
@@ -163,6 +164,13 @@ public:
          t_zone zone = e_local
          ) const;
 
+   // Format date and time into a buffer, same result as get()
+   size_t format(                      // Returns the length, excluding the null character
+         char* buf,                    // Buffer, at least s_maxformat characters
+         t_format format = e_plain,
+         t_zone zone = e_local
+         ) const;
+
    bool isDstTime() const; //TR_HY85159
 
    static Time now();
@@ -175,6 +183,8 @@ public:
    static const time_t s_hour;
    static const time_t s_day;
 
+   static const size_t s_maxformat = 64;   // Buffer size for format()
+
 private:
 
    Time(
@@ -188,6 +198,33 @@ private:
 
    int64_t getZoneOffset() const;
 
+   // Get broken-down time, as localtime_r() with the HY85159 correction or gmtime_r()
+   void getTm(
+         tm& tmtime,
+         t_zone zone
+         ) const;
+
+   // Get broken-down local time from the cached time zone offset
+   static bool getCachedLocalTm(       // Returns false if the offset may change this hour
+         time_t sec,
+         tm& tmtime
+         );
+
+   // Convert seconds since the epoch to broken-down time with a known UTC offset
+   static void convertTm(
+         time_t sec,
+         long gmtoff,
+         int isdst,
+         const char* zone,
+         tm& tmtime
+         );
+
+   static char* putNumber(
+         char* buf,
+         long value,
+         int width
+         );
+
    void validate() const;
 
    bool isLeapYear(int year);
@@ -213,13 +250,54 @@ private:
    timeval m_time;
    bool m_empty;
 
-   static t_zone s_zone;
-   static t_format s_format;
    static const int64_t s_empty;
 
    int isDst; //TR_HY85159
 };
 
+//========================================================================================
+// Class TimeStamp
+//
+// Compact time stamp in microseconds since the epoch, the representation used in the
+// log record headers. Comparisons are plain integer comparisons without validation,
+// for use in the record loops. An empty stamp compares greater than any valid time.
+// The stamp is validated when it is converted to a Time.
+//========================================================================================
+
+class TimeStamp
+{
+public:
+   TimeStamp(): m_time(s_empty) {}
+
+   explicit TimeStamp(
+         int64_t time                  // Microseconds, as in a record header
+         ): m_time(time) {}
+
+   explicit TimeStamp(
+         const Time& time              // Validated time, may be empty
+         ): m_time(static_cast<int64_t>(time)) {}
+
+   bool operator==(const TimeStamp& time) const {return m_time == time.m_time;}
+   bool operator!=(const TimeStamp& time) const {return m_time != time.m_time;}
+   bool operator<(const TimeStamp& time) const {return m_time < time.m_time;}
+   bool operator>(const TimeStamp& time) const {return m_time > time.m_time;}
+   bool operator<=(const TimeStamp& time) const {return m_time <= time.m_time;}
+   bool operator>=(const TimeStamp& time) const {return m_time >= time.m_time;}
+
+   bool empty() const {return m_time == s_empty;}
+
+   // Get microseconds
+   int64_t get() const {return m_time;}
+
+   // Get validated time
+   Time getTime() const {return Time(m_time);}
+
+   static const int64_t s_empty = int64_t(1) << 62;   // Empty time stamp
+
+private:
+   int64_t m_time;
+};
+
 //========================================================================================
 // Class Period
 //========================================================================================
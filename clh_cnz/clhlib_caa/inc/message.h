@@ -39,8 +39,11 @@
 #ifndef MESSAGE_H_
 #define MESSAGE_H_
 
+#include "parameters.h"
 #include <string>
 #include <iostream>
+#include <stddef.h>
+#include <stdint.h>
 
 namespace PES_CLH {
 
@@ -51,6 +54,7 @@ namespace PES_CLH {
 class Message
 {
    friend std::ostream& operator<<(std::ostream& s, const Message& message);
+   friend class MessageParser;
 
 public:
    Message();
@@ -104,6 +108,98 @@ public:
    static const std::string s_headerTag;
 };
 
+//========================================================================================
+// Class MessageParser
+//========================================================================================
+
+// Parses log messages from a memory mapped temporary file. The messages are returned
+// as views into the mapping, the parser does no stream seeks and no data copying.
+class MessageParser
+{
+public:
+   struct t_message
+   {
+      int64_t m_time;                  // Message time
+      const char* m_data;              // Message data
+      size_t m_size;                   // Message size
+      bool m_missing;                  // Data is missing, the data is not in the mapping
+   };
+
+   // Constructor
+   MessageParser(
+         t_headertype type             // Header type
+         );
+
+   // Destructor
+   ~MessageParser();
+
+   // Map a temporary file
+   void open(
+         const std::string& path       // File to map
+         );
+
+   // Unmap the file
+   void close();
+
+   // Get next complete message
+   bool next(                          // Returns false if no complete message is left
+         t_message& message            // Message returned
+         );
+
+   // Get the mapped file data
+   const char* data() const;
+
+   // Get the mapped file size
+   size_t size() const;
+
+   // Get offset to the end of the last complete message, the rest is the partial tail
+   size_t tell() const;
+
+private:
+   // Disable default copy constructor
+   MessageParser(const MessageParser&);
+
+   // Disable default assignment operator
+   MessageParser& operator=(const MessageParser&);
+
+   // Find the next header tag
+   const char* findHeader(             // Returns the tag, 0 if not found
+         const char* pos               // Start position
+         ) const;
+
+   // Parse the fields after a CLH header tag
+   int parseCLHFields(                 // Returns 1 if parsed, 0 if incomplete,
+                                       // -1 if corrupt
+         const char* pos,              // Start of fields
+         int64_t& time,                // Time returned
+         uintmax_t& size,              // Data size returned
+         const char*& data             // Start of data returned
+         ) const;
+
+   // Parse the fields after a TESRV header tag
+   int parseTESRVFields(               // Returns 1 if parsed, 0 if incomplete
+         const char* pos,              // Start of fields
+         int64_t& time,                // Time returned
+         uintmax_t& size,              // Data size returned
+         const char*& data             // Start of data returned
+         ) const;
+
+   // Parse a decimal number token
+   const char* parseNumber(            // Returns end of token, 0 if incomplete
+         const char* pos,              // Start position, leading white space is skipped
+         bool issigned,                // Is signed number
+         uintmax_t& value,             // Value returned
+         bool& valid                   // False returned if token is not a number
+         ) const;
+
+   t_headertype m_type;                // Header type
+   const std::string& m_tag;           // Header tag
+   std::string m_path;                 // Mapped file
+   char* m_addr;                       // Mapped address
+   size_t m_size;                      // Mapped size
+   size_t m_pos;                       // Offset to the end of the last complete message
+};
+
 }
 
 #endif // MESSAGE_H_
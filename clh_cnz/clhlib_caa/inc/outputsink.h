@@ -0,0 +1,95 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      outputsink.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Output stream with a large user-space buffer in front of another stream.
+//      The data is written to the target stream in large blocks, when the buffer
+//      is full, when the sink is flushed and when the sink is destroyed. Flushing
+//      the sink, e.g. by endl, also flushes the target stream.
+//
+//  ERROR HANDLING
+//      Write errors set badbit on the sink.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef OUTPUTSINK_H_
+#define OUTPUTSINK_H_
+
+#include <iostream>
+#include <streambuf>
+#include <vector>
+
+namespace PES_CLH {
+
+class OutputSink: public std::ostream
+{
+public:
+   // Constructor
+   OutputSink(
+         std::ostream& os,             // Target stream
+         size_t size = s_defaultsize   // Buffer size
+         );
+
+   // Destructor, the buffer is written to the target stream
+   ~OutputSink();
+
+   static const size_t s_defaultsize = 1024 * 1024;   // Default buffer size
+
+private:
+   // Disable default copy constructor
+   OutputSink(const OutputSink&);
+
+   // Disable default assignment operator
+   OutputSink& operator=(const OutputSink&);
+
+   class Buffer: public std::streambuf
+   {
+   public:
+      Buffer(std::ostream& os, size_t size);
+
+      // Write the buffer to the target stream
+      bool drain();                    // Returns false if the write failed
+
+   protected:
+      int_type overflow(int_type ch);
+      std::streamsize xsputn(const char* data, std::streamsize size);
+      int sync();
+
+   private:
+      std::ostream& m_os;              // Target stream
+      std::vector<char> m_buffer;      // Buffer
+   };
+
+   Buffer m_buffer;
+};
+
+}
+
+#endif // OUTPUTSINK_H_
@@ -112,6 +112,20 @@ enum t_headertype
    e_selHeader       // SEL heander
 };
 
+enum t_syncmode
+{
+   e_syncNone,       // No sync, data is written back by the kernel
+   e_syncInterval,   // Sync when the time or size since last sync is exceeded
+   e_syncBatch       // Sync after each batch
+};
+
+struct t_durability
+{
+   t_syncmode m_mode;   // Sync mode
+   uint32_t m_interval; // Max time between syncs in ms, interval mode only
+   uint32_t m_size;     // Max bytes between syncs, interval mode only
+};
+
 //========================================================================================
 // Class BaseParameters
 //========================================================================================
@@ -141,9 +155,11 @@ public:
    virtual t_headertype getHeaderType() const = 0;
    virtual bool hasMsgNo() const = 0;
    virtual bool hasXmNo() const = 0;
+   virtual bool hasCompression() const = 0;
    virtual uintmax_t getMaxsize() const = 0;
    virtual uint64_t getMaxtime() const = 0;
    virtual uint16_t getDivider() const = 0;
+   virtual t_durability getDurability() const = 0;
    virtual int getNoEndpoints() const = 0;
 
    // Set log parameters
@@ -153,6 +169,11 @@ public:
             uint16_t divider
             ) = 0;
 
+   // Set durability policy
+   virtual void setDurability(
+            const t_durability& durability
+            ) = 0;
+
    static const uint32_t s_maxfilesize;
 
 private:
@@ -195,9 +216,11 @@ public:
    t_headertype getHeaderType() const {return s_headertype;}
    bool hasMsgNo() const {return s_hasmsgno;}
    bool hasXmNo() const {return s_hasxmno;}
+   bool hasCompression() const {return s_hascompression;}
    uintmax_t getMaxsize() const {return s_maxsize;}
    uint64_t getMaxtime() const {return s_maxtime;}
    uint16_t getDivider() const {return s_divider;}
+   t_durability getDurability() const {return s_durability;}
 
    // Set parameters
    void setParameters(
@@ -227,6 +250,36 @@ public:
       }
    }
 
+   // Set durability policy
+   void setDurability(
+         const t_durability& durability
+         )
+   {
+      s_durability = durability;
+
+      // Log event
+      Logger logger(LOG_LEVEL_INFO);
+      if (logger)
+      {
+         std::ostringstream s;
+         s << "Durability set for log type '" << s_logname << "':" << std::endl;
+         switch (s_durability.m_mode)
+         {
+         case e_syncNone:
+            s << "Sync:     none";
+            break;
+         case e_syncInterval:
+            s << "Sync:     every " << s_durability.m_interval << " ms or "
+              << s_durability.m_size/1000 << " kbytes";
+            break;
+         case e_syncBatch:
+            s << "Sync:     each batch";
+            break;
+         }
+         logger.event(WHERE__, s.str());
+      }
+   }
+
    int getNoEndpoints() const {return s_noEP;}
 
 private:
@@ -244,10 +297,12 @@ private:
    static const t_headertype s_headertype;
    static const bool s_hasmsgno;
    static const bool s_hasxmno;
+   static const bool s_hascompression;
 
    static uintmax_t s_maxsize;      // Max size in bytes
    static uint64_t s_maxtime;       // Max time in microseconds
    static uint16_t s_divider;       // Divider value in %
+   static t_durability s_durability;   // Durability policy
 
    static int s_noEP;               // Number of endpoints
 };
@@ -0,0 +1,106 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      searchfilter.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Class for filtering logs based on the event text.
+//      The pattern is either a literal string or a regular expression. A literal
+//      string that every match must contain is searched for first, using SSE2
+//      where available, and the regular expression is only run on the events
+//      that contain it.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef SEARCHFILTER_H_
+#define SEARCHFILTER_H_
+
+#include "filter.h"
+#include <boost/regex.hpp>
+#include <string>
+
+namespace PES_CLH {
+
+class SearchFilter: public Filter
+{
+public:
+   // Constructors
+   SearchFilter(
+         const std::string& pattern,   // Literal string or regular expression
+         bool regex,                   // True if pattern is a regular expression
+         bool icase                    // True if case is ignored
+         );
+   SearchFilter();
+
+   // Destructor
+   ~SearchFilter();
+
+   // Check if filter is empty
+   bool empty() const;                 // Returns true if empty, false otherwise
+
+   // Check if the filter reads the event data
+   bool needsData() const;             // Returns true if data is needed
+
+   // Test filter match
+   bool test(                          // Return true if matched, false otherwise
+         const char* data,             // Data to be searched
+         size_t size                   // Data size
+         ) const;
+
+   using Filter::test;
+
+private:
+   // Get a literal string that every match of a regular expression contains
+   static std::string getLiteral(      // Returns literal, empty if none was found
+         const std::string& pattern    // Regular expression
+         );
+
+   // Search data for the literal string
+   const char* findLiteral(            // Returns first occurrence, 0 if not found
+         const char* data,             // Data to be searched
+         size_t size                   // Data size
+         ) const;
+
+   // Compare data with the literal string
+   bool matchLiteral(                  // Returns true if equal
+         const char* pos               // Data, at least the literal size
+         ) const;
+
+   std::string m_pattern;              // Search pattern
+   bool m_regex;                       // Pattern is a regular expression
+   bool m_icase;                       // Case is ignored
+   std::string m_literal;              // Literal string, lower case if case is ignored
+   boost::regex m_expression;          // Compiled regular expression
+};
+
+}
+
+#endif // SEARCHFILTER_H_
@@ -0,0 +1,129 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      segment.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Class for a memory mapped, preallocated log subfile.
+//      The subfile is preallocated to its maximum size and mapped into memory,
+//      data is appended with memory copies. The file is truncated to the real
+//      length when the segment is closed.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef SEGMENT_H_
+#define SEGMENT_H_
+
+#include <string>
+#include <stddef.h>
+
+namespace PES_CLH {
+
+class Segment
+{
+public:
+   // Constructor
+   Segment();
+
+   // Destructor
+   ~Segment();
+
+   // Create and preallocate a new segment
+   void create(
+         const std::string& path,      // File to create
+         size_t capacity               // Preallocated size
+         );
+
+   // Open an existing segment for appending
+   void open(
+         const std::string& path,      // File to open
+         size_t capacity,              // Preallocated size
+         size_t size                   // Real length of the file
+         );
+
+   // Close segment, the file is truncated to its real length
+   void close();
+
+   // Check if segment is open
+   bool isOpen() const;
+
+   // Get the path to the segment file
+   const std::string& getPath() const;
+
+   // Get real length of the segment
+   size_t size() const;
+
+   // Get free space in the segment
+   size_t avail() const;
+
+   // Append data to the segment
+   void append(
+         const void* data,             // Data to append
+         size_t size                   // Data size
+         );
+
+   // Overwrite data in the segment
+   void write(
+         size_t offset,                // Offset in segment
+         const void* data,             // Data to write
+         size_t size                   // Data size
+         );
+
+   // Read data from the segment
+   void read(
+         size_t offset,                // Offset in segment
+         void* data,                   // Data buffer
+         size_t size                   // Data size
+         ) const;
+
+   // Write the segment data to disk
+   void sync();
+
+private:
+   // Disable default copy constructor
+   Segment(const Segment&);
+
+   // Disable default assignment operator
+   Segment& operator=(const Segment&);
+
+   // Map the preallocated file into memory
+   void map();
+
+   std::string m_path;                 // Segment file
+   int m_fd;                           // File descriptor
+   char* m_addr;                       // Mapped address
+   size_t m_size;                      // Real length
+   size_t m_capacity;                  // Preallocated size
+};
+
+}
+
+#endif // SEGMENT_H_
@@ -116,10 +116,23 @@ public:
          );
 
 private:
+   // Open a tmp file
+   void openTmpFile(
+         fs::fstream& fs,               // File stream
+         const fs::path& path,          // File to open
+         bool create                    // Create new file
+         );
+
+   // Write a tmp file to disk
+   void syncTmpFile(
+         const fs::path& path           // File to sync
+         );
+
    // Stream textual information about the log entry
    void stream(std::ostream& s) const;
 
    Parameters<e_sel> m_parameters;
+   t_syncstate m_tmpsyncstate;          // Sync state for tmp file
 };
 
 }
@@ -0,0 +1,118 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      transfercheckpoint.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Checkpoints for incremental transfers, one per log and CP side.
+//      A checkpoint marks the last record or file exported from a log. In an
+//      incremental transfer the logs export only what was added after their
+//      checkpoints and leave new checkpoints, which are stored when the
+//      archive is complete. The checkpoints of the current transfer are used
+//      by the logs read in the thread that created the object, while it
+//      exists. Other threads working for the transfer are given them with
+//      setCurrent.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef TRANSFERCHECKPOINT_H_
+#define TRANSFERCHECKPOINT_H_
+
+#include <boost/filesystem.hpp>
+#include <boost/thread.hpp>
+#include <map>
+#include <string>
+
+namespace fs = boost::filesystem;
+
+namespace PES_CLH {
+
+class BaseTask;
+
+class TransferCheckpoint
+{
+public:
+   // Constructor, the checkpoints are used by the current transfer of the calling thread
+   // while the object exists
+   TransferCheckpoint(
+         const fs::path& path,         // Checkpoint directory
+         bool incremental              // Export only what was added after the checkpoints
+         );
+
+   // Destructor, checkpoints that are not committed are discarded
+   ~TransferCheckpoint();
+
+   // Get the checkpoint of a log in the current transfer
+   static std::string get(             // Returns checkpoint, empty if none or not incremental
+         const BaseTask& task          // Log
+         );
+
+   // Set the checkpoint of a log in the current transfer, it is stored when committed
+   static void set(
+         const BaseTask& task,         // Log
+         const std::string& checkpoint // Checkpoint
+         );
+
+   // Store the new checkpoints, when the archive is complete
+   void commit();
+
+   // Get the checkpoints of the current transfer of the calling thread
+   static TransferCheckpoint* getCurrent();   // Returns checkpoints, null if none
+
+   // Set the checkpoints of the current transfer of the calling thread, a null pointer
+   // ends the transfer for the thread
+   static void setCurrent(
+         TransferCheckpoint* checkpointp  // Checkpoints
+         );
+
+private:
+   // Disable default copy constructor
+   TransferCheckpoint(const TransferCheckpoint&);
+
+   // Disable default assignment operator
+   TransferCheckpoint& operator=(const TransferCheckpoint&);
+
+   // Get path to the checkpoint file of a log
+   fs::path getPath(                   // Returns checkpoint file
+         const BaseTask& task          // Log
+         ) const;
+
+   typedef std::map<fs::path, std::string> CHECKPOINTMAP;
+
+   fs::path m_path;                    // Checkpoint directory
+   bool m_incremental;                 // Incremental transfer
+   CHECKPOINTMAP m_checkpointmap;      // New checkpoints
+   boost::mutex m_mutex;               // Mutex, logs are transferred in parallel
+};
+
+}
+
+#endif // TRANSFERCHECKPOINT_H_
@@ -0,0 +1,142 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      transferscheduler.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Scheduler pacing the log reads of a transfer, to protect the log server.
+//      The reads are kept below a read bandwidth, the process is kept below a
+//      share of the CPU capacity, and the reads are paused while the log
+//      server reports that it is behind (see IngestStatus). The scheduler of
+//      the current transfer paces the reads in the thread that created it,
+//      while it exists. Other threads working for the transfer are given it
+//      with setCurrent. Reads in other threads are not paced.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef TRANSFERSCHEDULER_H_
+#define TRANSFERSCHEDULER_H_
+
+#include <boost/thread.hpp>
+#include <iostream>
+#include <string>
+#include <stdint.h>
+
+namespace PES_CLH {
+
+class TransferScheduler
+{
+public:
+   // Constructor, the scheduler paces the reads of the calling thread while it exists
+   TransferScheduler(
+         uint64_t bandwidth = 0,       // Max read bandwidth in bytes/s, 0 for no limit
+         unsigned int cpushare = 0     // Max share of the CPU capacity in percent, 0 for no limit
+         );
+
+   // Destructor
+   ~TransferScheduler();
+
+   // Account data read by the current transfer of the calling thread and wait if the
+   // transfer is ahead of its limits. Without a current transfer nothing is done.
+   static void throttle(
+         size_t size                   // Size of the data read, 0 only checks the limits
+         );
+
+   // Get the scheduler of the current transfer of the calling thread
+   static TransferScheduler* getCurrent();   // Returns scheduler, null if none
+
+   // Set the scheduler of the current transfer of the calling thread, a null pointer
+   // ends the transfer for the thread
+   static void setCurrent(
+         TransferScheduler* schedulerp // Scheduler
+         );
+
+   // Print throughput and time spent throttled
+   void report(
+         std::ostream& os              // Output stream
+         ) const;
+
+   // Parse the read bandwidth from a command option argument in MB/s
+   static uint64_t getBandwidth(       // Returns bandwidth in bytes/s
+         const std::string& arg        // Option argument
+         );
+
+   // Parse the CPU share from a command option argument in percent
+   static unsigned int getCpuShare(    // Returns CPU share in percent
+         const std::string& arg        // Option argument
+         );
+
+private:
+   // Disable default copy constructor
+   TransferScheduler(const TransferScheduler&);
+
+   // Disable default assignment operator
+   TransferScheduler& operator=(const TransferScheduler&);
+
+   // Account data read and wait
+   void wait(
+         size_t size                   // Size of the data read
+         );
+
+   // Check if reads are paused for the log server, the mutex must be locked
+   bool isPaused(
+         int64_t now                   // Monotonic time
+         );
+
+   // Get monotonic time in microseconds
+   static int64_t getMonotonic();
+
+   // Get CPU time used by the process in microseconds
+   static int64_t getCpuTime();
+
+   uint64_t m_bandwidth;               // Max read bandwidth in bytes/s
+   unsigned int m_cpushare;            // Max CPU share in percent
+   unsigned int m_cores;               // Number of cores
+   int64_t m_start;                    // Start time
+   int64_t m_cpustart;                 // CPU time at start
+   int64_t m_next;                     // Time when the data read is within the bandwidth
+   int64_t m_checked;                  // Time of the latest ingest status check
+   bool m_backlog;                     // Log server is behind
+   int64_t m_pausestart;               // Start of a pause for the log server, 0 if none
+   uint64_t m_size;                    // Data read
+   size_t m_waiting;                   // Number of threads waiting
+   int64_t m_waitstart;                // Start of the current wait
+   int64_t m_throttled;                // Time when some thread was waiting
+   mutable boost::mutex m_mutex;       // Mutex
+
+   static const int64_t s_checkinterval;  // Interval for ingest status checks
+   static const int64_t s_maxpause;       // Longest pause for the log server
+   static const uint64_t s_maxbandwidth;  // Highest allowed bandwidth in MB/s
+};
+
+}
+
+#endif // TRANSFERSCHEDULER_H_
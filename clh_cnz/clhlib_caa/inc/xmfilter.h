@@ -63,12 +63,18 @@ public:
          uint16_t xmno              // XM number to be matched towards the filter
          ) const;
 
+   // Check if the filter reads the event data
+   bool needsData() const;          // Returns true if data is needed
+
    // Test filter match
    bool test(                       // Return true if matched, false otherwise
-         const std::string& str     // String containing XM number to be matched
+         const char* data,          // Data containing XM number to be matched
                                     // towards the filter
+         size_t size                // Data size
          ) const;
 
+   using Filter::test;
+
    static const uint16_t s_maxmno;
 
 private:
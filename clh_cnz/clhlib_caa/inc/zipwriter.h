@@ -0,0 +1,299 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      zipwriter.h
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      In-process writer for zip archives, replacing the zip command.
+//      ZipEntry is an output stream that deflates the data written to it, for
+//      log printouts whose entry name is known only when the printout is
+//      finished. The compressed data is kept in memory up to a limit, the rest
+//      is spilled to an unlinked temporary file beside the archive and streamed
+//      from there when the entry is added.
+//      ZipWriter writes the entries and files to the archive one after another
+//      and the central directory when it is closed.
+//      Zip64 records are used when the archive or an entry exceeds 4 GB.
+//      Files are split in blocks that are deflated in parallel by worker
+//      threads and joined into one deflate stream. Each block is primed with
+//      the end of the previous block, so the archive does not depend on the
+//      number of threads.
+//      ArchiveSession makes a ZipWriter the target of Common::archive in the
+//      calling thread while it exists.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#ifndef ZIPWRITER_H_
+#define ZIPWRITER_H_
+
+#include <boost/filesystem.hpp>
+#include <boost/filesystem/fstream.hpp>
+#include <boost/shared_ptr.hpp>
+#include <iostream>
+#include <streambuf>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <time.h>
+
+struct z_stream_s;
+
+namespace fs = boost::filesystem;
+
+namespace PES_CLH {
+
+//========================================================================================
+// Class ZipEntry
+//========================================================================================
+
+class ZipEntry: public std::ostream
+{
+   friend class ZipWriter;
+
+public:
+   // Constructor
+   ZipEntry(
+         int level = s_defaultlevel,   // Compression level 0-9
+         const fs::path& tmpdir = fs::path()  // Directory for the spilled data,
+                                       // empty for the system temporary directory
+         );
+
+   // Destructor
+   ~ZipEntry();
+
+   // Finish the compression, no more data can be written
+   void finish();
+
+   // Get size of the data written
+   uint64_t getSize() const;
+
+   static const int s_defaultlevel = -1;  // Default compression level, as zlib
+
+private:
+   // Disable default copy constructor
+   ZipEntry(const ZipEntry&);
+
+   // Disable default assignment operator
+   ZipEntry& operator=(const ZipEntry&);
+
+   class Buffer: public std::streambuf
+   {
+   public:
+      Buffer(
+            int level,                 // Compression level
+            const fs::path& tmpdir     // Directory for the spilled data
+            );
+      ~Buffer();
+
+      // Compress the buffer and finish the compression
+      void finish();
+
+      // Get size of the data written, including the uncompressed part
+      uint64_t getSize() const;
+
+      std::vector<char> m_data;        // Compressed data not spilled
+      int m_fd;                        // Spilled compressed data, -1 if none
+      uint64_t m_spilled;              // Size of the spilled data
+      uint32_t m_crc;                  // CRC-32 of the data
+      uint64_t m_size;                 // Size of the data
+      bool m_ok;                       // No compression or spill error
+
+   protected:
+      int_type overflow(int_type ch);
+      std::streamsize xsputn(const char* data, std::streamsize size);
+      int sync();
+
+   private:
+      // Compress the buffer
+      bool compress(                   // Returns false on error
+            int flush                  // zlib flush mode
+            );
+
+      // Move the compressed data to the temporary file
+      bool spill();                    // Returns false on error
+
+      std::vector<char> m_buffer;      // Uncompressed data
+      fs::path m_tmpdir;               // Directory for the spilled data
+      z_stream_s* m_zstreamp;          // Compression state, null when finished
+   };
+
+   Buffer m_buffer;
+   time_t m_time;                      // Modification time
+};
+
+typedef boost::shared_ptr<ZipEntry> ZIPENTRYPTR;
+
+//========================================================================================
+// Class ZipWriter
+//========================================================================================
+
+class ZipWriter
+{
+public:
+   // Constructor, the archive file is created when the first entry is added
+   ZipWriter(
+         const fs::path& path,         // Path to the archive
+         size_t threads = 0,           // Compression threads, 0 for default
+         int level = ZipEntry::s_defaultlevel   // Compression level 0-9
+         );
+
+   // Destructor, an archive that is not closed is removed
+   ~ZipWriter();
+
+   // Add a file or a directory tree, the entry names are the relative paths
+   void add(
+         const fs::path& path          // File or directory
+         );
+
+   // Add a compressed entry
+   void add(
+         const std::string& name,      // Entry name
+         ZipEntry& entry               // Entry, it is finished if needed
+         );
+
+   // Create an entry with the compression level of the archive, spilling beside it
+   ZIPENTRYPTR createEntry() const;    // Returns entry
+
+   // Write the central directory and close the archive
+   void close();
+
+   // Get path to the archive
+   const fs::path& getPath() const;
+
+   // Get compression level
+   int getLevel() const;
+
+   // Parse the compression level from a command option argument
+   static int getCompressionLevel(     // Returns compression level
+         const std::string& arg        // Option argument
+         );
+
+private:
+   // Disable default copy constructor
+   ZipWriter(const ZipWriter&);
+
+   // Disable default assignment operator
+   ZipWriter& operator=(const ZipWriter&);
+
+   struct t_entry
+   {
+      std::string m_name;              // Entry name
+      uint16_t m_method;               // Compression method
+      uint16_t m_time;                 // Modification time, MS-DOS format
+      uint16_t m_date;                 // Modification date, MS-DOS format
+      uint32_t m_crc;                  // CRC-32 of the data
+      uint64_t m_csize;                // Compressed size
+      uint64_t m_size;                 // Uncompressed size
+      uint64_t m_offset;               // Offset to the local header
+      uint32_t m_attr;                 // External attributes
+   };
+
+   typedef std::vector<t_entry> ENTRYLIST;
+
+   // Create the archive file if not done
+   void open();
+
+   // Add a directory entry
+   void addDirectory(
+         const fs::path& path          // Directory
+         );
+
+   // Add a file, deflated in blocks while it is read
+   void addFile(
+         const fs::path& path          // File
+         );
+
+   // Create an entry description
+   static t_entry makeEntry(
+         const std::string& name,      // Entry name
+         time_t mtime,                 // Modification time
+         uint32_t mode                 // File mode
+         );
+
+   // Write a local header
+   void writeLocalHeader(
+         const t_entry& entry,         // Entry
+         bool zip64                    // Use a zip64 extra field for the sizes
+         );
+
+   // Write to the archive
+   void write(
+         const char* data,
+         size_t size
+         );
+
+   // Throw an exception for a failed write
+   void writeError() const;
+
+   fs::path m_path;                    // Path to the archive
+   fs::ofstream m_fs;                  // Archive file stream
+   uint64_t m_offset;                  // Current offset in the archive
+   ENTRYLIST m_entrylist;              // Entries written
+   bool m_closed;                      // Central directory is written
+   size_t m_threads;                   // Compression threads
+   int m_level;                        // Compression level
+
+   static const size_t s_defaultthreads;  // Default max number of compression threads
+};
+
+//========================================================================================
+// Class ArchiveSession
+//========================================================================================
+
+class ArchiveSession
+{
+public:
+   // Constructor, insertions by Common::archive in the calling thread go to the
+   // archive while the session exists
+   ArchiveSession(
+         const fs::path& path,         // Path to the archive
+         size_t threads = 0,           // Compression threads, 0 for default
+         int level = ZipEntry::s_defaultlevel   // Compression level 0-9
+         );
+
+   // Destructor, an archive that is not closed is removed
+   ~ArchiveSession();
+
+   // Write the central directory and close the archive
+   void close();
+
+private:
+   // Disable default copy constructor
+   ArchiveSession(const ArchiveSession&);
+
+   // Disable default assignment operator
+   ArchiveSession& operator=(const ArchiveSession&);
+
+   ZipWriter m_writer;
+};
+
+}
+
+#endif // ZIPWRITER_H_
@@ -43,9 +43,24 @@
 #include "common.h"
 #include "xmfilter.h"
 #include "eventhandler.h"
+#include "crc32c.h"
+#include "blockfile.h"
+#include "bufferpool.h"
+#include "compressor.h"
+#include "logcursor.h"
+#include "zipwriter.h"
+#include "transfercheckpoint.h"
 #include <boost/smart_ptr.hpp>
 #include <boost/lexical_cast.hpp>
 #include <boost/numeric/conversion/cast.hpp>
+#include <boost/crc.hpp>
+#include <algorithm>
+#include <string.h>
+#include <stddef.h>
+#include <time.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <errno.h>
 
 using namespace std;
 using namespace boost;
@@ -59,11 +74,17 @@ const regex AppendTask::s_msgnopattern("Message \\d{10}");
 //----------------------------------------------------------------------------------------
 AppendTask::AppendTask():
 BaseTask(),
-m_fs(),
+m_segment(),
+m_filesize(0),
+m_firstrec(0),
+m_lastrec(0),
 m_seldivider(false),
-m_filelist()
+m_filelist(),
+m_index(),
+m_indexnext(s_indexstep),
+m_summary(),
+m_syncstate()
 {
-   m_data = new char[BaseParameters::s_maxfilesize];
 }
 
 //----------------------------------------------------------------------------------------
@@ -71,8 +92,8 @@ m_filelist()
 //----------------------------------------------------------------------------------------
 AppendTask::~AppendTask()
 {
-   delete[] m_data;
-   m_data = NULL;
+   // Truncate the active file, the sidecar files are rebuilt when the log is opened
+   m_segment.close();
 }
 
 //----------------------------------------------------------------------------------------
@@ -81,7 +102,10 @@ AppendTask::~AppendTask()
 void AppendTask::open()
 {
    m_logsize = 0;
+   m_summary.clear();
    fs::path tempfile;
+   set<fs::path> subfilelist;
+   set<fs::path> indexlist;
    const fs::path& logdir = getLogDir();
    fs::directory_iterator end;
    for (fs::directory_iterator iter(logdir); iter != end; ++iter)
@@ -91,83 +115,231 @@ void AppendTask::open()
       if (regex_match(file, getParameters().getLogFile()))
       {
          // Log subfile
-         uintmax_t size = fs::file_size(path);
-         try
-         {
-            fs::ifstream fs(path);
-            checkIntegrity(fs, size);           // Check integrity of the log file
-
-            m_logsize += size;                  // Update log size
-            t_header header;
-            fs.seekg(0, ios_base::beg);
-            readData(fs, header);
-            fs.seekg(header.m_prev);
-            const Time& first = header.m_aptime;
-            readData(fs, header);
-            const Time& last = header.m_aptime;
-
-            const Time& time = parseFileName(file);
-
-            //HY85159 : Added DST check so that if any incorrect filenames are created during DST 
-            //change , they will be corrected.
- 
-            if ( time.isDstTime() || (time != first))
-            {
-               // Time zone changed - rename the file
-               const string& newfile = createFileName(first);
-               const fs::path& newpath = logdir / newfile;
+         subfilelist.insert(path);
+      }
+      else if (regex_match(file, getParameters().getTempFile()))
+      {
+         // Temporary log file found
+         tempfile = path;
+      }
+      else if ((path.extension() == ".idx") &&
+               regex_match(path.stem().string() + getParameters().getFileExt(),
+                           getParameters().getLogFile()))
+      {
+         // Time index for a subfile
+         indexlist.insert(path);
+      }
+      else if (path == getSummaryPath())
+      {
+         // Log manifest, rewritten below
+      }
+      else
+      {
+         // Unknown file, remove it
+         fs::remove(path);
 
-               if(newfile != file)
-               {
-            	   fs::rename(path, newpath);
+         // Log event
+         ostringstream s;
+         s << *this << endl;
+         s << "Unknown file " << path << " found - file removed.";
+         Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
+      }
+   }
 
-            	   // Log event
-            	   ostringstream s;
-            	   s << *this << endl;
-            	   s << "Time zone changed, log file renamed from " << path << " to " << newpath << ".";
-            	   Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
+   SUMMARY manifest;
+   readSummary(manifest);                 // Sealed subfiles from last run
+   int verified(0);
 
-               }
-            }
+   for (set<fs::path>::const_iterator siter = subfilelist.begin();
+        siter != subfilelist.end();
+        ++siter)
+   {
+      const fs::path& path = *siter;
+      const string& file = path.filename().c_str();
+      boost::system::error_code ec;
+      uintmax_t size = BlockFile::getSize(path, ec);
+
+      // Sealed subfile covered by the manifest - no integrity check needed.
+      // The last subfile is always checked, it is the one appended to.
+      if ((path != *subfilelist.rbegin()) && openFromManifest(manifest, path, size, indexlist))
+      {
+         continue;
+      }
+      verified++;
+
+      try
+      {
+         BlockIfstream fs(path);
+         uintmax_t realsize = getRealSize(fs, size);
+         fs.clear();
+         if ((realsize < size) && (fs.isCompressed() == false))
+         {
+            // Preallocated subfile was not closed - truncate it to the real length
+            fs::resize_file(path, realsize);
+            size = realsize;
+
+            // Log event
+            ostringstream s;
+            s << *this << endl;
+            s << "Log file " << path << " was not closed, truncated to " << size << " bytes.";
+            Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
 
-            // Insert times in list
-            m_filelist.push_back(make_pair(first, last));
+            if (size == 0)
+            {
+               // No events in file - remove it
+               fs.close();
+               fs::remove(path);
+               continue;
+            }
          }
-         catch (Exception& ex)
+         // Check integrity of the log file
+         size_t firstrec;
+         size_t lastrec;
+         const uint32_t version = readFileHeader(fs, firstrec, lastrec);
+         uintmax_t goodsize = checkIntegrity(fs, size, lastrec);
+         if (goodsize < size)
          {
-            // Corrupt file - remove it
-            fs::remove(path);
+            const bool compressed = fs.isCompressed();
+            fs.close();
 
             // Log event
             ostringstream s;
-            s << "Internal structure of log file '" << path << "' is inconsistent: "
-              << ex.getMessage() << " File is removed." << endl;
+            s << *this << endl;
+            s << "Internal structure of log file " << path << " is inconsistent, ";
+            if (goodsize == 0)
+            {
+               // No good records in file - remove it
+               fs::remove(path);
+               s << "no valid records found. File is removed.";
+            }
+            else
+            {
+               // Keep the records before the damage
+               if (compressed)
+               {
+                  BlockFile::decompress(path, goodsize);
+               }
+               truncateFile(path, version, goodsize, lastrec);
+               s << "truncated from " << size << " to " << goodsize << " bytes.";
+               size = goodsize;
+            }
             Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
 
             // Report to event handler
-            EventHandler::send(ex.getErrCode(), s.str());
+            EventHandler::send(Exception::parameter().first, s.str());
+
+            if (goodsize == 0)
+            {
+               continue;
+            }
+            fs.open(path);
          }
+
+         // Update log size, a compressed subfile counts with its size on disk
+         m_logsize += fs.isCompressed()? fs::file_size(path): size;
+         t_header fheader;
+         t_header lheader;
+         fs.clear();
+         fs.seekg(firstrec);
+         readData(fs, fheader);
+         fs.seekg(lastrec);
+         readData(fs, lheader);
+         const Time first(fheader.m_aptime);
+         const Time last(lheader.m_aptime);
+
+         const Time& time = parseFileName(file);
+
+         //HY85159 : Added DST check so that if any incorrect filenames are created during DST 
+         //change , they will be corrected.
+ 
+         if ( time.isDstTime() || (time != first))
+         {
+            // Time zone changed - rename the file
+            const string& newfile = createFileName(first);
+            const fs::path& newpath = logdir / newfile;
+
+            if(newfile != file)
+            {
+               fs::rename(path, newpath);
+
+               // Log event
+               ostringstream s;
+               s << *this << endl;
+               s << "Time zone changed, log file renamed from " << path << " to " << newpath << ".";
+               Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
+
+            }
+         }
+
+         // Insert times in list
+         m_filelist.push_back(make_pair(first, last));
+
+         // Rebuild the time index of a sealed subfile if it is missing or stale.
+         // The index of the last subfile is built when it is appended to.
+         const fs::path& subfile = logdir / createFileName(first);
+         INDEX index;
+         if ((path != *subfilelist.rbegin()) && (readIndex(subfile, size, index) == false))
+         {
+            buildIndex(fs, size, index);
+            writeIndex(subfile, size, index);
+         }
+
+         // Insert subfile in manifest
+         const t_summaryentry& entry = createSummaryEntry(subfile, fheader, lheader, size);
+         m_summary[entry.m_name] = entry;
       }
-      else if (regex_match(file, getParameters().getTempFile()))
-      {
-         // Temporary log file found
-         tempfile = path;
-      }
-      else
+      catch (Exception& ex)
       {
-         // Unknown file, remove it
+         // Corrupt file - remove it
          fs::remove(path);
 
          // Log event
          ostringstream s;
-         s << *this << endl;
-         s << "Unknown file " << path << " found - file removed.";
+         s << "Internal structure of log file '" << path << "' is inconsistent: "
+           << ex.getMessage() << " File is removed." << endl;
          Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
+
+         // Report to event handler
+         EventHandler::send(ex.getErrCode(), s.str());
       }
    }
 
    sort(m_filelist.begin(), m_filelist.end());       // Sort file list
 
+   // Remove time indexes for subfiles that no longer exist
+   for (set<fs::path>::const_iterator iter = indexlist.begin();
+        iter != indexlist.end();
+        ++iter)
+   {
+      fs::path subfile(*iter);
+      subfile.replace_extension(getParameters().getFileExt());
+      if (fs::exists(subfile) == false)
+      {
+         fs::remove(*iter);
+      }
+   }
+   writeSummary();
+
+   // Compress sealed subfiles left uncompressed by the last run
+   if (getParameters().hasCompression() && (m_filelist.size() > 1))
+   {
+      for (FILELISTCITER iter = m_filelist.begin(); iter + 1 != m_filelist.end(); ++iter)
+      {
+         Compressor::add(logdir / createFileName(iter->first));
+      }
+   }
+
+   // Log event
+   Logger logger(LOG_LEVEL_DEBUG);
+   if (logger)
+   {
+      ostringstream s;
+      s << *this << endl;
+      s << "Opened " << subfilelist.size() << " subfile(s), " << verified
+        << " not covered by the manifest were checked.";
+      logger.event(WHERE__, s.str());
+   }
+
    m_isopen = true;
 
    // A temporary file was found - process it
@@ -184,50 +356,607 @@ void AppendTask::open()
    }
 }
 
+//----------------------------------------------------------------------------------------
+// Open a sealed subfile that is covered by the manifest
+//----------------------------------------------------------------------------------------
+bool AppendTask::openFromManifest(
+      const SUMMARY& manifest,
+      const fs::path& path,
+      uintmax_t size,
+      const set<fs::path>& indexlist
+      )
+{
+   const string& file = path.filename().c_str();
+   SUMMARY::const_iterator iter = manifest.find(file);
+   if ((iter == manifest.end()) || (iter->second.m_size != size))
+   {
+      // Not covered or changed
+      return false;
+   }
+
+   const t_summaryentry& entry = iter->second;
+   try
+   {
+      // File name must match the first event, see the time zone check in open
+      const Time first(entry.m_first);
+      if (first.isDstTime() || (createFileName(first) != file))
+      {
+         return false;
+      }
+
+      // Check the first and last record against the manifest checksum
+      BlockIfstream fs(path);
+      t_header fheader;
+      t_header lheader;
+      size_t firstrec;
+      size_t lastrec;
+      readFileHeader(fs, firstrec, lastrec);
+      if (fs.fail() || (lastrec < firstrec) || (lastrec + sizeof(t_header) > size))
+      {
+         return false;
+      }
+      fs.seekg(firstrec);
+      readData(fs, fheader);
+      fs.seekg(lastrec);
+      readData(fs, lheader);
+      if (fs.fail() ||
+          (lastrec + sizeof(t_header) + lheader.m_size != size) ||
+          (getChecksum(fheader, lheader) != entry.m_checksum))
+      {
+         return false;
+      }
+
+      // Update log size, a compressed subfile counts with its size on disk
+      m_logsize += fs.isCompressed()? fs::file_size(path): size;
+      m_filelist.push_back(make_pair(first, Time(entry.m_last)));
+      m_summary[file] = entry;
+
+      // Rebuild the time index if it is missing
+      if (indexlist.find(getIndexPath(path)) == indexlist.end())
+      {
+         INDEX index;
+         buildIndex(fs, size, index);
+         writeIndex(path, size, index);
+      }
+   }
+   catch (Exception&)
+   {
+      // Invalid time in manifest
+      return false;
+   }
+
+   return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Create a manifest entry for a subfile
+//----------------------------------------------------------------------------------------
+AppendTask::t_summaryentry AppendTask::createSummaryEntry(
+      const fs::path& path,
+      const t_header& first,
+      const t_header& last,
+      uintmax_t size
+      ) const
+{
+   // The name is null terminated and padded with zeros. A longer name is cut, the
+   // entry is then not found and the subfile is read instead.
+   t_summaryentry entry;
+   const string name = path.filename().string();
+   const size_t length = min(name.size(), sizeof(entry.m_name) - 1);
+   memset(entry.m_name, 0, sizeof(entry.m_name));
+   memcpy(entry.m_name, name.data(), length);
+   entry.m_first = first.m_aptime;
+   entry.m_last = last.m_aptime;
+   entry.m_size = size;
+   entry.m_checksum = getChecksum(first, last);
+   return entry;
+}
+
+//----------------------------------------------------------------------------------------
+// Calculate checksum for the first and last record header of a subfile
+//----------------------------------------------------------------------------------------
+uint32_t AppendTask::getChecksum(const t_header& first, const t_header& last)
+{
+   boost::crc_32_type crc;
+   crc.process_bytes(&first, sizeof(t_header));
+   crc.process_bytes(&last, sizeof(t_header));
+   return crc.checksum();
+}
+
 //----------------------------------------------------------------------------------------
 //   Close log
 //----------------------------------------------------------------------------------------
 void AppendTask::close()
 {
+   closeFile();                           // Close present file
    m_filelist.clear();
-   if (m_fs.is_open())
+   m_summary.clear();
+   m_isopen = false;
+}
+
+//----------------------------------------------------------------------------------------
+// Check integrity of log file.
+// Format v2 files only need the last record checked, the other records are checked
+// with their checksum when they are read. Format v1 files have the whole chain of
+// records checked. If the check fails, the records are checked from the start of
+// the file to find the last good one.
+//----------------------------------------------------------------------------------------
+uintmax_t AppendTask::checkIntegrity(istream& fs, uintmax_t size, size_t& last) const
+{
+   size_t first;
+   fs.clear();
+   const uint32_t version = readFileHeader(fs, first, last);
+   if (fs.fail())
    {
-      // Close present file
-      m_fs.close();
+      last = 0;
+      return 0;
    }
-   m_isopen = false;
+
+   t_header header;
+   vector<char> data;
+   bool good = (last >= first) && (last + sizeof(t_header) <= size);
+   if (version == s_fileversion)
+   {
+      if (good)
+      {
+         fs.seekg(last);
+         readData(fs, header);
+         good = fs.good() && (last + sizeof(t_header) + header.m_size == size);
+      }
+      if (good)
+      {
+         data.resize(header.m_size + 1);
+         fs.read(&data[0], header.m_size);
+         good = fs.good() && checkRecord(version, header, &data[0]);
+      }
+   }
+   else
+   {
+      size_t offset = last;
+      size_t next = size;
+      while (good)
+      {
+         fs.seekg(offset);
+         readData(fs, header);
+         good = fs.good() &&
+                (header.m_size + sizeof(t_header) == next - offset) &&
+                checkRecord(version, header, 0);
+         next = offset;
+         offset = header.m_prev;
+         if (next == first) break;
+      }
+   }
+
+   if (good)
+   {
+      return size;
+   }
+
+   // Find the last good record
+   uintmax_t goodsize = 0;
+   size_t offset = first;
+   last = 0;
+   fs.clear();
+   while (offset + sizeof(t_header) <= size)
+   {
+      fs.seekg(offset);
+      readData(fs, header);
+      uintmax_t end = offset + sizeof(t_header) + header.m_size;
+      if (fs.fail() || (end > size)) break;
+
+      if (version == s_fileversion)
+      {
+         // Records are linked to the previous record, the first has no previous
+         if (header.m_prev != last) break;
+
+         data.resize(header.m_size + 1);
+         fs.read(&data[0], header.m_size);
+         if (fs.fail() || (checkRecord(version, header, &data[0]) == false)) break;
+      }
+      else
+      {
+         // The first record holds the address to the last record
+         if ((offset != first) && (header.m_prev != last)) break;
+         if (checkRecord(version, header, 0) == false) break;
+      }
+
+      last = offset;
+      goodsize = end;
+      offset = end;
+   }
+   return goodsize;
 }
 
 //----------------------------------------------------------------------------------------
-// Check integrity of log file
+// Get real length of a log subfile, preallocated space excluded
 //----------------------------------------------------------------------------------------
-void AppendTask::checkIntegrity(fs::ifstream& fs, uintmax_t size) const
+size_t AppendTask::getRealSize(istream& fs, uintmax_t size) const
 {
+   if (size < sizeof(t_header))
+   {
+      return size;
+   }
+
+   size_t first;
+   size_t last;
+   const uint32_t version = readFileHeader(fs, first, last);
    t_header header;
+   fs.seekg(first);
+   readData(fs, header);
+   if (fs.fail())
+   {
+      return size;
+   }
+   if (version == s_fileversion)
+   {
+      if (last == 0)
+      {
+         // Preallocated file without records
+         return 0;
+      }
+   }
+   else if (header.m_aptime == 0 && header.m_size == 0)
+   {
+      // Preallocated file without records
+      return 0;
+   }
 
-   fs.seekg(0, ios_base::beg);
+   // The last record ends the file
+   if (last + sizeof(t_header) > size)
+   {
+      return size;
+   }
+   fs.seekg(last);
    readData(fs, header);
-   size_t offset = header.m_prev;
-   size_t next = size;
+   if (fs.fail())
+   {
+      return size;
+   }
+   uintmax_t end = last + sizeof(t_header) + header.m_size;
+   return (end < size)? end: size;
+}
+
+//----------------------------------------------------------------------------------------
+// Read the format version and the addresses to the first and last record
+//----------------------------------------------------------------------------------------
+uint32_t AppendTask::readFileHeader(istream& fs, size_t& first, size_t& last)
+{
+   t_fileheader fheader;
+   fs.seekg(0, ios_base::beg);
+   readData(fs, fheader);
+   if (fs.good() && (fheader.m_magic == s_filemagic) && (fheader.m_version == s_fileversion))
+   {
+      first = sizeof(t_fileheader);
+      last = fheader.m_last;
+      return s_fileversion;
+   }
+
+   // Format v1, the first record holds the address to the last record
+   size_t prev = 0;
+   fs.clear();
+   fs.seekg(0, ios_base::beg);
+   readData(fs, prev);
+   first = 0;
+   last = prev;
+   return 1;
+}
+
+//----------------------------------------------------------------------------------------
+// Calculate the checksum of a format v2 record
+//----------------------------------------------------------------------------------------
+uint32_t AppendTask::getRecordCrc(const t_header& header, const char* data)
+{
+   t_header crcheader = header;
+   crcheader.m_crc = 0;
+   uint32_t crc = Crc32c::update(0, &crcheader, sizeof(t_header));
+   return Crc32c::update(crc, data, header.m_size);
+}
+
+//----------------------------------------------------------------------------------------
+// Check a record read from a subfile
+//----------------------------------------------------------------------------------------
+bool AppendTask::checkRecord(uint32_t version, const t_header& header, const char* data)
+{
+   if (version == s_fileversion)
+   {
+      return getRecordCrc(header, data) == header.m_crc;
+   }
+
+   // Format v1 has no checksum, the times must be valid
+   if (header.m_crc != 0)
+   {
+      return false;
+   }
+   try
+   {
+      Time(header.m_cptime);
+      Time(header.m_aptime);
+   }
+   catch (Exception&)
+   {
+      return false;
+   }
+   return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Truncate a subfile after the last good record
+//----------------------------------------------------------------------------------------
+void AppendTask::truncateFile(
+      const fs::path& path,
+      uint32_t version,
+      uintmax_t size,
+      size_t last
+      ) const
+{
+   fs::resize_file(path, size);
+
+   fs::fstream fs(path, ios_base::in | ios_base::out | ios_base::binary);
+   if (fs.is_open())
+   {
+      // Write new last pointer
+      if (version == s_fileversion)
+      {
+         uint64_t last64 = last;
+         fs.seekp(offsetof(t_fileheader, m_last));
+         writeData(fs, last64);
+      }
+      else
+      {
+         fs.seekp(0, ios_base::beg);
+         writeData(fs, last);
+      }
+   }
+
+   if (fs.fail() || (fs.is_open() == false))
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << *this << endl;
+      ex << "Failed to truncate file " << path << ".";
+      ex.sysError();
+      throw ex;
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Get path to the time index of a subfile
+//----------------------------------------------------------------------------------------
+fs::path AppendTask::getIndexPath(const fs::path& path)
+{
+   fs::path ipath(path);
+   return ipath.replace_extension(".idx");
+}
+
+//----------------------------------------------------------------------------------------
+// Get path to the log summary
+//----------------------------------------------------------------------------------------
+fs::path AppendTask::getSummaryPath() const
+{
+   return getLogDir() / (getParameters().getFilePrefix() + ".sum");
+}
+
+//----------------------------------------------------------------------------------------
+// Build the time index of a subfile from its records
+//----------------------------------------------------------------------------------------
+void AppendTask::buildIndex(istream& fs, uintmax_t size, INDEX& index) const
+{
+   index.clear();
+   if (size < sizeof(t_header))
+   {
+      return;
+   }
+
+   // Collect all records, the chain is read backwards
+   INDEX records;
+   t_header header;
+   size_t first;
+   size_t offset;
+   fs.clear();
+   readFileHeader(fs, first, offset);
+   size_t next;
    do
    {
+      next = offset;
       fs.seekg(offset);
       readData(fs, header);
-      size_t diff = next - offset;
-      next = offset;
+      if (fs.fail() || (offset + sizeof(t_header) > size))
+      {
+         // Broken chain - no index
+         return;
+      }
+      t_indexentry entry = {header.m_aptime, offset};
+      records.push_back(entry);
       offset = header.m_prev;
+   }
+   while ((next != first) && (records.size() <= size / sizeof(t_header)));
 
-      Time(header.m_cptime);
-      Time(header.m_aptime);
-      size_t size = header.m_size;
-      if (size + sizeof(t_header) != diff)
+   // Keep sparse entries in file order
+   size_t indexnext = s_indexstep;
+   for (INDEX::const_reverse_iterator iter = records.rbegin();
+        iter != records.rend();
+        ++iter)
+   {
+      if (iter->m_offset >= indexnext)
       {
-         Exception ex(Exception::parameter(), WHERE__);
-         ex << "Offset error.";
-         throw ex;
+         index.push_back(*iter);
+         indexnext = iter->m_offset + s_indexstep;
+      }
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Read the time index of a subfile
+//----------------------------------------------------------------------------------------
+bool AppendTask::readIndex(const fs::path& path, uintmax_t size, INDEX& index) const
+{
+   index.clear();
+
+   fs::ifstream fs(getIndexPath(path), ios_base::binary);
+   if (fs.is_open() == false)
+   {
+      return false;
+   }
+
+   t_sidecarheader header;
+   readData(fs, header);
+   if (fs.fail() ||
+       (header.m_magic != s_indexmagic) ||
+       (header.m_version != s_indexversion) ||
+       (header.m_value != size))
+   {
+      // Index is stale
+      return false;
+   }
+
+   t_indexentry entry;
+   for (readData(fs, entry); fs.good(); readData(fs, entry))
+   {
+      if (entry.m_offset + sizeof(t_header) > size)
+      {
+         index.clear();
+         return false;
+      }
+      index.push_back(entry);
+   }
+   return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Write the time index of a subfile
+//----------------------------------------------------------------------------------------
+void AppendTask::writeIndex(const fs::path& path, uintmax_t size, const INDEX& index) const
+{
+   ostringstream fs(ios_base::binary);
+   t_sidecarheader header = {s_indexmagic, s_indexversion, size};
+   writeData(fs, header);
+   if (index.empty() == false)
+   {
+      fs.write(
+            reinterpret_cast<const char*>(&index[0]),
+            index.size() * sizeof(t_indexentry)
+            );
+   }
+
+   // Readers fall back to reading the subfile if the index is not written
+   replaceSidecar(getIndexPath(path), fs.str());
+}
+
+//----------------------------------------------------------------------------------------
+// Replace a sidecar file
+//----------------------------------------------------------------------------------------
+bool AppendTask::replaceSidecar(const fs::path& path, const string& data) const
+{
+   // A reader or a restart after a crash sees either the old or the new file
+   const fs::path& tmppath = path.string() + ".tmp";
+   int fd = ::open(tmppath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666);
+   bool ok = (fd != -1);
+   for (size_t offset = 0; ok && (offset < data.size()); )
+   {
+      const ssize_t bytes = ::write(fd, data.data() + offset, data.size() - offset);
+      if (bytes == -1)
+      {
+         ok = (errno == EINTR);
+         continue;
       }
+      offset += bytes;
+   }
+   ok = ok && (fdatasync(fd) == 0);
+   if (fd != -1)
+   {
+      ok = (::close(fd) == 0) && ok;
+   }
+   ok = ok && (::rename(tmppath.c_str(), path.c_str()) == 0);
+
+   if (ok == false)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << *this << endl;
+      ex << "Failed to write file " << path << ".";
+      ex.sysError();
+      Logger::event(LOG_LEVEL_WARN, ex);
+
+      ::unlink(tmppath.c_str());
+   }
+   return ok;
+}
+
+//----------------------------------------------------------------------------------------
+// Read the log summary
+//----------------------------------------------------------------------------------------
+void AppendTask::readSummary(SUMMARY& summary) const
+{
+   summary.clear();
+
+   fs::ifstream fs(getSummaryPath(), ios_base::binary);
+   if (fs.is_open() == false)
+   {
+      return;
+   }
+
+   t_sidecarheader header;
+   readData(fs, header);
+   if (fs.fail() ||
+       (header.m_magic != s_summarymagic) ||
+       (header.m_version != s_summaryversion))
+   {
+      return;
+   }
+
+   t_summaryentry entry;
+   for (uint64_t i = 0; i < header.m_value; i++)
+   {
+      readData(fs, entry);
+      if (fs.fail()) break;
+
+      entry.m_name[sizeof(entry.m_name) - 1] = 0;
+      summary[entry.m_name] = entry;
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Write the log summary for the sealed subfiles
+//----------------------------------------------------------------------------------------
+void AppendTask::writeSummary() const
+{
+   ostringstream fs(ios_base::binary);
+   t_sidecarheader header = {s_summarymagic, s_summaryversion, m_summary.size()};
+   writeData(fs, header);
+   for (SUMMARY::const_iterator iter = m_summary.begin(); iter != m_summary.end(); ++iter)
+   {
+      writeData(fs, iter->second);
    }
-   while (next != 0);
+
+   // Readers fall back to reading the subfiles if the summary is not written
+   replaceSidecar(getSummaryPath(), fs.str());
+}
+
+//----------------------------------------------------------------------------------------
+// Look up a subfile in the log summary
+//----------------------------------------------------------------------------------------
+bool AppendTask::findSummary(
+      const SUMMARY& summary,
+      const fs::path& path,
+      Time& first,
+      Time& last
+      ) const
+{
+   SUMMARY::const_iterator iter = summary.find(path.filename().string());
+   if (iter == summary.end())
+   {
+      return false;
+   }
+
+   // The summary is stale if the subfile has changed
+   boost::system::error_code ec;
+   uintmax_t size = BlockFile::getSize(path, ec);
+   if (ec || (size != iter->second.m_size))
+   {
+      return false;
+   }
+
+   first = Time(iter->second.m_first);
+   last = Time(iter->second.m_last);
+   return true;
 }
 
 //----------------------------------------------------------------------------------------
@@ -246,159 +975,350 @@ Time AppendTask::parseFileName(const string& file) const
             );
 }
 
-//----------------------------------------------------------------------------------------
-// Construct a file name from time
-//----------------------------------------------------------------------------------------
-string AppendTask::createFileName(const Time& time) const
-{
-   return getParameters().getFilePrefix() + "_" + time.get(Time::e_long) +
-          getParameters().getFileExt();
+//----------------------------------------------------------------------------------------
+// Construct a file name from time
+//----------------------------------------------------------------------------------------
+string AppendTask::createFileName(const Time& time) const
+{
+   return getParameters().getFilePrefix() + "_" + time.get(Time::e_long) +
+          getParameters().getFileExt();
+}
+
+//----------------------------------------------------------------------------------------
+//   Insert message in log
+//----------------------------------------------------------------------------------------
+void AppendTask::insert(const Time& cptime, const char* data, uintmax_t size, bool issel)
+{
+   BATCH batch;
+   addEvent(batch, cptime, 0, size, issel);
+   insertBatch(batch, data);
+}
+
+//----------------------------------------------------------------------------------------
+//   Add an event message to a batch
+//----------------------------------------------------------------------------------------
+void AppendTask::addEvent(
+      BATCH& batch,
+      const Time& cptime,
+      size_t offset,
+      uintmax_t size,
+      bool issel
+      ) const
+{
+   // Check size
+   if (size > getMaxEventSize())
+   {
+      // Event message too big
+      Exception ex(Exception::internal(), WHERE__);
+      ex << *this << endl;
+      ex << "Message size exceeds max allowed size.";
+      throw ex;
+   }
+
+   t_batchevent event;
+   event.m_cptime = cptime;
+   event.m_offset = offset;
+   event.m_size = size;
+   event.m_issel = issel;
+   batch.push_back(event);
+}
+
+//----------------------------------------------------------------------------------------
+//   Get max size of an event message
+//----------------------------------------------------------------------------------------
+size_t AppendTask::getMaxEventSize()
+{
+   return BaseParameters::s_maxfilesize - sizeof(t_fileheader) - sizeof(t_header);
+}
+
+//----------------------------------------------------------------------------------------
+//   Get used size of batch buffer
+//----------------------------------------------------------------------------------------
+size_t AppendTask::getBatchSize(const BATCH& batch)
+{
+   return batch.empty()? 0: batch.back().m_offset + batch.back().m_size;
+}
+
+//----------------------------------------------------------------------------------------
+//   Insert a batch of messages in log.
+//   The records for each log subfile are written with one vectored write followed by
+//   one update of the last pointer, the on-disk format is the same as for single
+//   inserts.
+//----------------------------------------------------------------------------------------
+void AppendTask::insertBatch(BATCH& batch, const char* data)
+{
+   if (batch.empty())
+   {
+      return;
+   }
+
+   if (m_isopen == false)
+   {
+      // Log is not opened
+      batch.clear();
+      Exception ex(Exception::internal(), WHERE__);
+      ex << "Log '" << getParameters().getLogName() << "' is not opened.";
+      throw ex;
+   }
+
+   uintmax_t maxsize = getParameters().getMaxsize();
+
+   // Need for divide quota to 90% and 10% for Non-CPUB SEL
+   if (m_seldivider)
+   {
+      if (m_issetap2)
+      {
+         maxsize = maxsize * 10 / 100;
+      }
+      else
+      {
+         maxsize = maxsize * 90 / 100;
+      }
+   }
+
+   const fs::path& logdir = getLogDir();
+   vector<t_header> headers;
+   vector<const char*> datav;
+   headers.reserve(batch.size());
+   datav.reserve(batch.size());
+
+   try
+   {
+      for (BATCHCITER iter = batch.begin(); iter != batch.end(); ++iter)
+      {
+         uintmax_t eventsize = sizeof(t_header) + iter->m_size;
+         if (m_logsize + eventsize > maxsize)
+         {
+            writeRecords(headers, datav);    // Commit pending records
+            if (getParameters().hasCompression())
+            {
+               // Subfiles are compressed in the background, get the size on disk
+               m_logsize = calculateLogSize() - m_segment.avail();
+            }
+            if (m_logsize + eventsize > maxsize)
+            {
+               maintainLogSize();            // Maintain size of the log
+            }
+         }
+
+         Time aptime = Time::now();
+         if (m_filelist.empty())
+         {
+            // No file exists - create file
+            const string& file = createFileName(aptime);
+            const fs::path& path = logdir / file;
+            createFile(path);
+            m_filelist.push_back(make_pair(aptime, aptime));
+
+            // Log event
+            Logger logger(LOG_LEVEL_INFO);
+            if (logger)
+            {
+               ostringstream s;
+               s << *this << endl;
+               s << "Log file " << path << " is created.";
+               logger.event(WHERE__, s.str());
+            }
+         }
+         else if (m_segment.isOpen() == false)
+         {
+            // File(s) exist - open last file
+            const Time& last = m_filelist.back().first;
+            const string& file = createFileName(last);
+            const fs::path& path = logdir / file;
+            if (openFile(path) == false)
+            {
+               // Last file can not be appended to - create new file
+               const fs::path& newpath = logdir / createFileName(aptime);
+               createFile(newpath);
+               m_filelist.push_back(make_pair(aptime, aptime));
+
+               // Log event
+               Logger logger(LOG_LEVEL_INFO);
+               if (logger)
+               {
+                  ostringstream s;
+                  s << *this << endl;
+                  s << "Log file " << path << " can not be appended to, new file " << newpath
+                    << " is created.";
+                  logger.event(WHERE__, s.str());
+               }
+            }
+         }
+
+         if ((m_filesize > m_firstrec) &&
+             (m_filesize + eventsize > BaseParameters::s_maxfilesize))
+         {
+            // File reached max size
+            writeRecords(headers, datav);    // Commit pending records
+            const fs::path sealed(m_segment.getPath());
+            closeFile();                     // Close current file
+            if (getParameters().hasCompression())
+            {
+               Compressor::add(sealed);      // Compress in the background
+            }
+
+            // The new file must have a later name than the current one
+            if (aptime <= m_filelist.back().first)
+            {
+               aptime = Time(static_cast<int64_t>(m_filelist.back().first) + 1);
+            }
+
+            // Create new file
+            const string& file = createFileName(aptime);
+            const fs::path& path = logdir / file;
+            createFile(path);
+            m_filelist.push_back(make_pair(aptime, aptime));
+
+            // Log event
+            Logger logger(LOG_LEVEL_INFO);
+            if (logger)
+            {
+               ostringstream s;
+               s << *this << endl;
+               s << "Log file reached max size, new file " << path << " is created.";
+               logger.event(WHERE__, s.str());
+            }
+         }
+         else
+         {
+            m_filelist.back().second = aptime;
+         }
+
+         // Append message to the pending records
+         t_header header;
+         header.m_prev = (m_filesize == m_firstrec)? 0: m_lastrec;
+         header.m_cptime = iter->m_cptime;
+         header.m_aptime = aptime;
+
+         // In case of SEL events in sel.tmp file
+         if (iter->m_issel)
+         {
+            // In sel.tmp the timestamp is AP time, not CP time.
+            header.m_cptime = Time();
+            header.m_aptime = iter->m_cptime;
+         }
+         header.m_size = iter->m_size;
+         header.m_crc = 0;
+
+         headers.push_back(header);
+         datav.push_back(data + iter->m_offset);
+         m_lastrec = m_filesize;
+         m_filesize += eventsize;
+         m_logsize += eventsize;
+      }
+
+      writeRecords(headers, datav);          // Commit pending records
+   }
+   catch (...)
+   {
+      // Records not yet written are lost, reread state of the active subfile
+      closeFile();
+      m_logsize = calculateLogSize();
+      batch.clear();
+      throw;
+   }
+
+   batch.clear();
 }
 
 //----------------------------------------------------------------------------------------
-//   Insert message in log
+//   Write records to the end of the active log subfile
 //----------------------------------------------------------------------------------------
-void AppendTask::insert(const Time& cptime, const char* data, uintmax_t size, bool issel)
+void AppendTask::writeRecords(
+      vector<t_header>& headers,
+      vector<const char*>& datav
+      )
 {
-   if (m_isopen == false)
-   {
-      // Log is not opened
-      Exception ex(Exception::internal(), WHERE__);
-      ex << "Log '" << getParameters().getLogName() << "' is not opened.";
-      throw ex;
-   }
-
-   // Check size
-   uintmax_t eventsize = sizeof(t_header) + size;
-   if (eventsize > BaseParameters::s_maxfilesize)
+   if (headers.empty())
    {
-      // Event message too big
-      Exception ex(Exception::internal(), WHERE__);
-      ex << *this << endl;
-      ex << "Message size exceeds max allowed size.";
-      throw ex;
+      return;
    }
 
-   uintmax_t maxsize = getParameters().getMaxsize();
+   const size_t start = m_segment.size();
 
-   // Need for divide quota to 90% and 10% for Non-CPUB SEL
-   if (m_seldivider)
+   // Copy all records to the mapped file
+   for (size_t i = 0; i < headers.size(); i++)
    {
-      if (m_issetap2)
-      {
-         maxsize = maxsize * 10 / 100;
-      }
-      else
+      size_t recoffset = m_segment.size();
+      headers[i].m_crc = getRecordCrc(headers[i], datav[i]);
+      m_segment.append(&headers[i], sizeof(t_header));
+      m_segment.append(datav[i], headers[i].m_size);
+
+      // Add a sparse time index entry
+      if (recoffset >= m_indexnext)
       {
-         maxsize = maxsize * 90 / 100;
+         t_indexentry entry = {headers[i].m_aptime, recoffset};
+         m_index.push_back(entry);
+         m_indexnext = recoffset + s_indexstep;
       }
    }
 
-   if (m_logsize + eventsize > maxsize)
-   {
-      maintainLogSize();               // Maintain size of the log
-   }
+   // Write new last pointer
+   uint64_t last = m_lastrec;
+   m_segment.write(offsetof(t_fileheader, m_last), &last, sizeof(uint64_t));
 
-   const Time& aptime = Time::now();
-   const fs::path& logdir = getLogDir();
-   if (m_filelist.empty())
-   {
-      // No file exists - create file
-      const string& file = createFileName(aptime);
-      const fs::path& path = logdir / file;
-      createFile(path);
-      m_filelist.push_back(make_pair(aptime, aptime));
+   headers.clear();
+   datav.clear();
 
-      // Log event
-      Logger logger(LOG_LEVEL_INFO);
-      if (logger)
-      {
-         ostringstream s;
-         s << *this << endl;
-         s << "Log file " << path << " is created.";
-         logger.event(WHERE__, s.str());
-      }
-   }
-   else
-   {
-      // File(s) exist
-      if (m_fs.is_open() == false)
-      {
-         // Open last file
-         const Time& last = m_filelist.back().first;
-         const string& file = createFileName(last);
-         const fs::path& path = logdir / file;
-         openFile(path);
-      }
-   }
+   syncFile(m_segment.size() - start);
+}
+
+//----------------------------------------------------------------------------------------
+// Account for a write according to the durability policy
+//----------------------------------------------------------------------------------------
+bool AppendTask::needSync(t_syncstate& state, size_t written) const
+{
+   state.m_unsynced += written;
 
-   m_fs.seekg(0, ios_base::end);         // Move get pointer to end of file
-   streamoff filesize = m_fs.tellg();   // File size
-   if (filesize + eventsize > BaseParameters::s_maxfilesize)
+   const t_durability& durability = getParameters().getDurability();
+   if ((durability.m_mode == e_syncNone) || (state.m_unsynced == 0))
    {
-      // File reached max size
-      m_fs.close();                     // Close current file
+      return false;
+   }
 
-      // Create new file
-      const string& file = createFileName(aptime);
-      const fs::path& path = logdir / file;
-      createFile(path);
-      m_filelist.push_back(make_pair(aptime, aptime));
-      filesize = 0;
+   timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   const uint64_t now = ts.tv_sec * 1000ULL + ts.tv_nsec / 1000000;
 
-      // Log event
-      Logger logger(LOG_LEVEL_INFO);
-      if (logger)
-      {
-         ostringstream s;
-         s << *this << endl;
-         s << "Log file reached max size, new file " << path << " is created.";
-         logger.event(WHERE__, s.str());
-      }
-   }
-   else
+   if ((durability.m_mode == e_syncInterval) &&
+       (state.m_unsynced < durability.m_size) &&
+       (now - state.m_lastsync < durability.m_interval))
    {
-      m_filelist.back().second = aptime;
+      return false;
    }
 
-   // Append message to the log file
-   t_header header;
-   header.m_prev = 0; 
-   header.m_cptime = cptime;
-   header.m_aptime = aptime;
+   state.m_unsynced = 0;
+   state.m_lastsync = now;
+   return true;
+}
 
-   // In case of SEL events in sel.tmp file
-   if (issel)
+//----------------------------------------------------------------------------------------
+// Sync the active log subfile according to the durability policy.
+// A failed sync is logged, the records are still in the file.
+//----------------------------------------------------------------------------------------
+void AppendTask::syncFile(size_t written, bool force)
+{
+   bool sync = needSync(m_syncstate, written);
+   if (force && (m_syncstate.m_unsynced > 0) &&
+       (getParameters().getDurability().m_mode != e_syncNone))
    {
-      // In sel.tmp the timestamp is AP time, not CP time.
-      header.m_cptime = Time();
-      header.m_aptime = cptime;
+      // Sync the data that is left, e.g. before the file is closed
+      m_syncstate.m_unsynced = 0;
+      sync = true;
    }
-   header.m_size = size;
 
-   if (filesize == 0)
+   if (sync)
    {
-      writeData(m_fs, header);         // Write header
-      m_fs.write(data, size);            // Write message
+      try
+      {
+         m_segment.sync();
+      }
+      catch (Exception& ex)
+      {
+         Logger::event(ex);
+      }
    }
-   else
-   {
-      m_fs.seekg(ios_base::beg);         // Move get pointer to beginning of file
-      size_t curlast;
-      readData(m_fs, curlast);         // Get pointer to the last record in file
-      m_fs.seekp(0, ios_base::end);      // Move put pointer to end of file
-      streamoff newlast;
-      newlast = m_fs.tellp();            // Get new last pointer 
-      header.m_prev = curlast;         // Move pointer to previous record
-      writeData(m_fs, header);         // Write header
-      m_fs.write(data, size);            // Write message
-      m_fs.seekp(0, ios_base::beg);      // Move put pointer to beginning of file
-      writeData(m_fs, newlast);         // Write new last pointer
-      m_fs.seekp(0, ios_base::end);      // Move put pointer to end of file
-   }
-   m_fs.flush();
-
-   m_logsize += eventsize;
 }
 
 //----------------------------------------------------------------------------------------
@@ -414,30 +1334,32 @@ void AppendTask::createFile(const fs::path& path)
       throw ex;
    }
 
-   // Create file
-   m_fs.open(path, ios_base::out | ios_base::binary);
-   if ((m_fs.is_open() == false) || (m_fs.fail() == true))
-   {
-      Exception ex(Exception::system(), WHERE__);
-      ex << *this << endl;
-      ex << "Failed to create file " << path << ".";
-      ex.sysError();
-      throw ex;
-   }
+   // Create preallocated file
+   m_segment.create(path.string(), BaseParameters::s_maxfilesize);
 
-   // Close file
-   m_fs.close();
+   // Format v2 file header, no records yet
+   t_fileheader fheader = {s_filemagic, s_fileversion, 0};
+   m_segment.append(&fheader, sizeof(t_fileheader));
 
-   openFile(path);
+   m_filesize = sizeof(t_fileheader);
+   m_firstrec = sizeof(t_fileheader);
+   m_lastrec = 0;
+   m_logsize += sizeof(t_fileheader);
+   m_index.clear();
+   m_indexnext = s_indexstep;
 }
 
 //----------------------------------------------------------------------------------------
 // Open file
 //----------------------------------------------------------------------------------------
-void AppendTask::openFile(const fs::path& path)
+bool AppendTask::openFile(const fs::path& path)
 {
-   m_fs.open(path, ios_base::in | ios_base::out | ios_base::binary);
-   if ((m_fs.is_open() == false) || (m_fs.fail() == true))
+   // The file must not be replaced by a compressed copy while appended to
+   Compressor::cancel(path);
+
+   // Real length of the file
+   fs::ifstream fs(path, ios_base::binary);
+   if (fs.is_open() == false)
    {
       Exception ex(Exception::system(), WHERE__);
       ex << *this << endl;
@@ -445,6 +1367,72 @@ void AppendTask::openFile(const fs::path& path)
       ex.sysError();
       throw ex;
    }
+   size_t first;
+   size_t last;
+   if (readFileHeader(fs, first, last) != s_fileversion)
+   {
+      // Older format or compressed, records are only appended to plain format v2 files
+      return false;
+   }
+   size_t size = getRealSize(fs, fs::file_size(path));
+
+   // Time index for the file
+   if (readIndex(path, size, m_index) == false)
+   {
+      buildIndex(fs, size, m_index);
+   }
+   m_indexnext = m_index.empty()? s_indexstep: m_index.back().m_offset + s_indexstep;
+   fs.close();
+
+   // The file is no longer sealed
+   if (m_summary.erase(path.filename().string()))
+   {
+      writeSummary();
+   }
+
+   m_segment.open(path.string(), BaseParameters::s_maxfilesize, size);
+
+   m_filesize = size;
+   m_firstrec = first;
+   m_lastrec = last;
+   return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Close file, the file is truncated to its real length
+//----------------------------------------------------------------------------------------
+void AppendTask::closeFile()
+{
+   if (m_segment.isOpen() && m_segment.size() > m_firstrec)
+   {
+      // Seal the file, save its time index and insert it in the summary
+      const fs::path path(m_segment.getPath());
+      writeIndex(path, m_segment.size(), m_index);
+
+      try
+      {
+         t_header first;
+         t_header last;
+         m_segment.read(m_firstrec, &first, sizeof(t_header));
+         m_segment.read(m_lastrec, &last, sizeof(t_header));
+
+         const t_summaryentry& entry = createSummaryEntry(path, first, last, m_segment.size());
+         m_summary[entry.m_name] = entry;
+         writeSummary();
+      }
+      catch (Exception& ex)
+      {
+         Logger::event(LOG_LEVEL_WARN, ex);
+      }
+   }
+
+   syncFile(0, true);
+   m_segment.close();
+   m_filesize = 0;
+   m_firstrec = 0;
+   m_lastrec = 0;
+   m_index.clear();
+   m_indexnext = s_indexstep;
 }
 
 //----------------------------------------------------------------------------------------
@@ -525,16 +1513,19 @@ void AppendTask::readMsgs(const fs::path& path)
       }
    }
 
-   fs::fstream ifs;
-   ifs.open(tpath, ios_base::in);
-   if (ifs.is_open() == false)
+   // The messages are parsed in place from the mapped file
+   MessageParser parser(getParameters().getHeaderType());
+   try
    {
-      Exception ex(Exception::system(), WHERE__);
-      ex << *this << endl;
-      ex << "Failed to open file " << tpath << ".";
-      ex.sysError();
-      Logger::event(LOG_LEVEL_ERROR, WHERE__, ex.getMessage());
-      
+      parser.open(tpath.string());
+   }
+   catch (Exception& ex)
+   {
+      ostringstream s;
+      s << *this << endl;
+      s << ex.getMessage();
+      Logger::event(LOG_LEVEL_ERROR, WHERE__, s.str());
+
       // If file is corrupted, remove it.
       if (fs::exists(tpath))
       {
@@ -546,10 +1537,13 @@ void AppendTask::readMsgs(const fs::path& path)
       return;
    }
 
-   uintmax_t size = fs::file_size(tpath); // Get file size
+   uintmax_t size = parser.size();        // Get file size
+   const char* base = parser.data();      // Batch offsets are relative to the mapping
    ios::streamoff pos(0);
    int counter(0);
    bool isselheader = false;
+   BATCH batch;                           // Events are inserted in batches
+   MessageParser::t_message message;
 
    switch (getParameters().getHeaderType())
    {
@@ -557,21 +1551,18 @@ void AppendTask::readMsgs(const fs::path& path)
       isselheader = true;
    case e_clhHeader:
    {
-      istream_iterator<CLHMessage> end_iter;
-      for (istream_iterator<CLHMessage> iter(ifs); iter != end_iter; ++iter)
+      while (parser.next(message))
       {
-         pos = ifs.tellg();
-
          try
          {
-            const char* data = iter->getData(m_data);
+            const char* data = message.m_data;
 
             // Analyze data message
             if (getParameters().hasXmNo())
             {
                // XM number expected
                uint16_t xmno;
-               if (parseXmNo(data, xmno) == false)
+               if (parseXmNo(data, message.m_size, xmno) == false)
                {
                   ostringstream s;
                   s << *this << endl;
@@ -582,7 +1573,7 @@ void AppendTask::readMsgs(const fs::path& path)
             if (getParameters().hasMsgNo())
             {
                // Message number expected
-               size_t pos = regex_match(data, s_msgnopattern);
+               size_t pos = regex_match(data, data + message.m_size, s_msgnopattern);
                if (pos != 0)
                {
                   ostringstream s;
@@ -592,10 +1583,27 @@ void AppendTask::readMsgs(const fs::path& path)
                }
             }
             counter++;
-            
-            // Insert message in log file
+
+            // Add message to batch
             // Local time received from CP, convert it to UTC time
-            insert(Time(iter->getTime(), true), data, iter->getSize(), isselheader);
+            if (message.m_missing)
+            {
+               // Data is not in the mapping - insert it after the pending messages
+               insertBatch(batch, base);
+               insert(Time(message.m_time, true), data, message.m_size, isselheader);
+            }
+            else
+            {
+               if (batch.empty() == false &&
+                   getBatchSize(batch) - batch.front().m_offset + message.m_size >=
+                   BaseParameters::s_maxfilesize)
+               {
+                  // Batch is full - insert messages in log file
+                  insertBatch(batch, base);
+               }
+               addEvent(batch, Time(message.m_time, true), data - base, message.m_size,
+                     isselheader);
+            }
          }
          catch (Exception& ex)
          {
@@ -603,60 +1611,76 @@ void AppendTask::readMsgs(const fs::path& path)
             Logger::event(LOG_LEVEL_WARN, ex);
          }
       }
+
+      try
+      {
+         // Insert remaining messages in log file
+         insertBatch(batch, base);
+      }
+      catch (Exception& ex)
+      {
+         ex << " Event ignored.";
+         Logger::event(LOG_LEVEL_WARN, ex);
+      }
+      pos = parser.tell();
    }
    break;
 
    case e_tesrvHeader:
    {
-      istream_iterator<TESRVMessage> end_iter;
-      for (istream_iterator<TESRVMessage> iter(ifs); iter != end_iter; ++iter)
+      while (parser.next(message))
       {
-         pos = ifs.tellg();
-         const char* data = iter->getData(m_data);
+         if (message.m_missing == false && batch.empty() == false &&
+             getBatchSize(batch) - batch.front().m_offset + message.m_size >=
+             BaseParameters::s_maxfilesize)
+         {
+            // Batch is full - insert messages in log file
+            insertBatch(batch, base);
+         }
          counter++;
 
-         // Insert message in log file
+         // Add message to batch
          // Local time received from CP, convert it to UTC time
-         insert(Time(iter->getTime(), true), data, iter->getSize());
+         try
+         {
+            if (message.m_missing)
+            {
+               // Data is not in the mapping - insert it after the pending messages
+               insertBatch(batch, base);
+               insert(Time(message.m_time, true), message.m_data, message.m_size);
+            }
+            else
+            {
+               addEvent(batch, Time(message.m_time, true), message.m_data - base,
+                     message.m_size);
+            }
+         }
+         catch (Exception&)
+         {
+            insertBatch(batch, base);
+            throw;
+         }
       }
+
+      // Insert remaining messages in log file
+      insertBatch(batch, base);
+      pos = parser.tell();
    }
    break;
 
    case e_noHeader:
    {
-      char* data = m_data;
-
-      try 
-      {
-         filebuf* pbuf = ifs.rdbuf();
-         pbuf->sgetn(data, size);
-         pos = ifs.tellg();
-         counter = 1;
-      }
-      catch (...)
-      {
-         // Close file hanlder
-         ifs.close();
-         // Delete file
-         fs::remove(tpath);
-         
-         // Write to log
-         Exception ex(Exception::system(), WHERE__);
-         ex << "Error while handling no header tmp files." << endl;
-         Logger::event(ex);
-         
-         return;
-      }
-
-      // Insert message in log file
-      insert(Time::now(), data, size);
+      // Insert the whole file as one message in log file
+      pos = size;
+      counter = 1;
+      insert(Time::now(), base, size);
    }
    break;
 
    default:
       assert(!"Illegal header type.");
    }
-   ifs.close();
+   parser.close();
 
    ios::streampos rem = size - pos;
    if (rem)
@@ -666,11 +1690,18 @@ void AppendTask::readMsgs(const fs::path& path)
       if (fs.is_open())
       {
          try {
-            char* data = m_data;
-            fs.seekg(-rem, ios::end);
-            fs.read(data, rem);
-            fs.seekp(0, ios::beg);
-            fs.write(data, rem);
+            // Move the tail in chunks, the destination is always before the source
+            BufferPool::Buffer buffer;
+            char* data = buffer.get();
+            for (ios::streamoff moved = 0; moved < rem; )
+            {
+               ios::streamoff chunk = min<ios::streamoff>(rem - moved, buffer.size());
+               fs.seekg(pos + moved);
+               fs.read(data, chunk);
+               fs.seekp(moved);
+               fs.write(data, chunk);
+               moved += chunk;
+            }
             fs.close();
 
             // Truncate the file
@@ -711,9 +1742,11 @@ void AppendTask::readMsgs(const fs::path& path)
    Logger integrity(LOG_LEVEL_DEBUG);
    if (integrity)
    {
-      // Integrity check
-      size_t logsize = calculateLogSize();
-      if (logsize != m_logsize)
+      // Integrity check, preallocated space in the active file is excluded
+      // Compression in the background can only make the real size smaller
+      size_t logsize = calculateLogSize() - m_segment.avail();
+      if ((logsize != m_logsize) &&
+          ((getParameters().hasCompression() == false) || (logsize > m_logsize)))
       {
          Exception ex(Exception::internal(), WHERE__);
          ex << *this << endl;
@@ -737,9 +1770,9 @@ void AppendTask::readMsgs(const fs::path& path)
 //----------------------------------------------------------------------------------------
 // Parse XM number
 //----------------------------------------------------------------------------------------
-bool AppendTask::parseXmNo(const char* data, uint16_t& xmno) const
+bool AppendTask::parseXmNo(const char* data, size_t size, uint16_t& xmno) const
 {
-   const string str(data, 8);
+   const string str(data, min<size_t>(size, 8));
    if (str.substr(0, 3) == "XM ")
    {
       size_t pos = str.find(':');
@@ -831,10 +1864,7 @@ void AppendTask::maintainLogSize()
       if (iter_next == m_filelist.end())
       {
          // This is the last file, make sure it gets closed
-         if (m_fs.is_open())
-         {
-            m_fs.close();
-         }
+         closeFile();
       }
 
       const string& file = createFileName(time);
@@ -844,7 +1874,7 @@ void AppendTask::maintainLogSize()
 
       try
       {
-         fs::remove(path);
+         Compressor::remove(path);
          is_deleted = true;
       }
       catch (fs::filesystem_error e)
@@ -862,6 +1892,12 @@ void AppendTask::maintainLogSize()
 
       if (is_deleted)
       {
+         // Remove time index and summary entry
+         boost::system::error_code ec;
+         fs::remove(getIndexPath(path), ec);
+         m_summary.erase(file);
+         writeSummary();
+
          // Remove file out of the list
          m_filelist.erase(iter);
          // Subtract the file size
@@ -904,99 +1940,96 @@ Period AppendTask::readEvents(
             ostream& os
             ) const
 {
-   set<fs::path> list;
+   string checkpoint;
+   return readEventsSince(period, filter, eventcb, os, checkpoint);
+}
 
-   // Create a list with the log subfiles
-   const fs::path& logdir = getLogDir();
+//----------------------------------------------------------------------------------------
+// Read event log after a checkpoint
+//----------------------------------------------------------------------------------------
+Period AppendTask::readEventsSince(
+            const Period& period,
+            const Filter& filter,
+            t_eventcb eventcb,
+            ostream& os,
+            string& checkpoint
+            ) const
+{
+   TimeStamp start;
+   TimeStamp stop;
 
-   // Check log dir exist
-   if (fs::exists(logdir) == false)
-   {
-      return Period(Time(), Time());
-   }
+   LogCursor cursor(*this);
 
-   fs::directory_iterator end;
-   for (fs::directory_iterator iter(logdir); iter != end; ++iter)
+   // Oldest event to read, the first one after the checkpoint
+   bool bounded = false;
+   LogCursor::t_position bound;
+   if (checkpoint.empty() == false)
    {
-      const fs::path& path = *iter;
-      if (regex_match(path.filename().c_str(), getParameters().getLogFile()))
+      try
+      {
+         if (cursor.seekAfter(checkpoint) == false)
+         {
+            // No events after the checkpoint
+            return Period(Time(), Time());
+         }
+         bound = cursor.getPosition();
+         bounded = true;
+      }
+      catch (Exception& ex)
       {
-         list.insert(path);
+         // The whole period is read
+         Logger::event(LOG_LEVEL_WARN, ex);
       }
    }
 
-   Time start;
-   Time stop;
-
-   // Print events in reverse order from the log files
-   for (set<fs::path>::const_reverse_iterator riter = list.rbegin();
-        riter != list.rend();
-        ++riter)
+   // Print events in reverse order, start at the last event in the period.
+   // The record times are compared as time stamps, Time is only built for the printout.
+   const TimeStamp first(period.first());
+   string newest;
+   for (bool valid = cursor.seekBefore(period.last()); valid; valid = cursor.prev())
    {
-      const fs::path& path = *riter;
-      fs::ifstream fs(path, ios_base::binary);
-      if (fs.is_open() == false)
+      const TimeStamp aptime = cursor.getAPStamp();
+      if (first > aptime) break;                      // Stop time reached
+
+      const LogCursor::t_position& position = cursor.getPosition();
+      if (bounded &&
+          ((position.m_file < bound.m_file) ||
+           ((position.m_file == bound.m_file) && (position.m_offset < bound.m_offset))))
       {
-         // Oops, file was deleted maybe due to maintenance purpose
-         // Continue with the next file then
-         continue;
+         break;                                       // Checkpoint reached
       }
-
-      t_header header;
-      readData(fs, header);
-      const Time& first(header.m_aptime);
-      size_t offset = header.m_prev;
-      fs.seekg(offset);
-      readData(fs, header);
-      const Time& last(header.m_aptime);
-
-      if (period.first() > last) break;                  // Stop time reached
-      if (period.last() >= first)
+      if (newest.empty())
       {
-         // Print events
-         fs.seekg(offset);
-         size_t next;
+         newest = cursor.getToken(position);
+      }
 
-         do
+      bool found = true;
+      if (eventcb)
+      {
+         // Filter the printout, the data is only parsed if the filter reads it
+         const size_t size = cursor.getSize();
+         const char* const buf = cursor.getData();
+         found = (filter.needsData() == false) || filter.test(buf, size);
+         if (found)
          {
-            next = offset;
-            readData(fs, header);
-            const Time& cptime(header.m_cptime);
-            const Time& aptime(header.m_aptime);
-            if (period.first() > aptime) break;       // Stop time reached
-            if (period.last() >= aptime)
-            {
-               bool found = true;
-               if (eventcb)
-               {
-                  size_t size = header.m_size;
-                  boost::scoped_array<char> sarray(new char[size]);
-                  char* const buf = sarray.get();
-                  fs.read(buf, size);
-
-                  // Filter the printout
-                  found = filter.test(buf);
-                  if (found)
-                  {
-                     eventcb(cptime, aptime, size, buf, os);
-                  }
-               }
-               if (found)
-               {
-                  if (stop.empty())
-                  {
-                     stop = aptime;
-                  }
-                  start = aptime;
-               }
-            }
-            offset = header.m_prev;
-            fs.seekg(offset);
+            eventcb(cursor.getCPTime(), aptime.getTime(), size, buf, os);
          }
-         while (next);
+      }
+      if (found)
+      {
+         if (stop.empty())
+         {
+            stop = aptime;
+         }
+         start = aptime;
       }
    }
 
+   if (newest.empty() == false)
+   {
+      checkpoint = newest;
+   }
+
    // Start & stop time not found
    if (start.empty() || stop.empty())
    {
@@ -1006,10 +2039,10 @@ Period AppendTask::readEvents(
    // Start greater than stop time
    if  (start > stop)
    {
-      throw StartGreatStopTimeException(start, stop, WHERE__);
+      throw StartGreatStopTimeException(start.getTime(), stop.getTime(), WHERE__);
    }
 
-   return Period(start, stop);
+   return Period(start.getTime(), stop.getTime());
 }
 
 //----------------------------------------------------------------------------------------
@@ -1017,7 +2050,19 @@ Period AppendTask::readEvents(
 //----------------------------------------------------------------------------------------
 Period AppendTask::listEvents(const Period& period) const
 {
-   return readEvents(period, NoFilter());
+   // Only the boundary records of the subfiles are read
+   LogCursor cursor(*this);
+   Time stop;
+   if (cursor.findTimeBefore(period.last(), stop) == false)
+   {
+      return Period(Time(), Time());
+   }
+   Time start;
+   if ((period.first() > stop) || (cursor.findTime(period.first(), start) == false))
+   {
+      return Period(Time(), Time());
+   }
+   return Period(start, stop);
 }
 
 //----------------------------------------------------------------------------------------
@@ -1025,16 +2070,14 @@ Period AppendTask::listEvents(const Period& period) const
 //----------------------------------------------------------------------------------------
 void AppendTask::transferLogs(const Period& period, const Filter& filter) const
 {
-   const fs::path& tempfile = "temp";
-   fs::ofstream fs(tempfile, ios_base::binary);
-   if (fs.is_open() == false)
-   {
-      Exception ex(Exception::system(), WHERE__);
-      ex << *this << endl;
-      ex << "Failed to create file " << tempfile << ".";
-      ex.sysError();
-      throw ex;
-   }
+   // The events are compressed while they are read, the entry is named when the
+   // first and last event times are known
+   const ZipWriter* const writerp = Common::getArchive();
+   const ZIPENTRYPTR entryp(writerp? writerp->createEntry(): ZIPENTRYPTR(new ZipEntry()));
+
+   // In an incremental transfer only the events after the checkpoint are transferred
+   const string& checkpoint = TransferCheckpoint::get(*this);
+   string newcheckpoint = checkpoint;
 
    Time start;
    Time stop;
@@ -1042,11 +2085,12 @@ void AppendTask::transferLogs(const Period& period, const Filter& filter) const
    try
    {
       // Transfer append logs
-      const Period& tperiod = readEvents(
+      const Period& tperiod = readEventsSince(
                                       period,
                                       filter,
                                       printLogEvent,
-                                      fs
+                                      *entryp,
+                                      newcheckpoint
                                       );
 
       if (tperiod.empty() == false)
@@ -1061,34 +2105,38 @@ void AppendTask::transferLogs(const Period& period, const Filter& filter) const
       stop = ex.getStopTime();
    }
 
-   fs.close();
+   if (newcheckpoint != checkpoint)
+   {
+      TransferCheckpoint::set(*this, newcheckpoint);
+   }
 
    if (start.empty() || stop.empty())
    {
       // Nothing to transfer
-      fs::remove(tempfile);
+      return;
    }
-   else
-   {
-      // Insert file in archive
-      const fs::path& dir = getParentDir();
-      fs::create_directories(dir);
 
-      ostringstream s;
-      s << getParameters().getFilePrefix() << "_" << start << "__" << stop << ".log";
-      const fs::path& destfile = dir / s.str();
-      fs::rename(tempfile, destfile);
-
-      Common::archive(destfile, "archive");
+   // Insert entry in archive, the name does not depend on the stream format
+   ostringstream s;
+   s << getParameters().getFilePrefix() << "_" << start.get(Time::e_plain) << "__"
+     << stop.get(Time::e_plain) << ".log";
+   Common::archive((getParentDir() / s.str()).string(), entryp);
 
-      // Start time greater than stop time
-      if (start > stop)
-      {
-         throw StartGreatStopTimeException(start, stop, WHERE__);
-      }
+   // Start time greater than stop time
+   if (start > stop)
+   {
+      throw StartGreatStopTimeException(start, stop, WHERE__);
    }
 }
 
+//----------------------------------------------------------------------------------------
+// Check for white space, same as isspace() in the C locale
+//----------------------------------------------------------------------------------------
+static inline bool isSpace(char ch)
+{
+   return (ch == ' ') || ((ch >= '\t') && (ch <= '\r'));
+}
+
 //----------------------------------------------------------------------------------------
 // Print a log event to the stream
 //----------------------------------------------------------------------------------------
@@ -1100,20 +2148,36 @@ void printLogEvent(
          ostream& os
          )
 {
+   // Header, "<CP time>  AP time: <AP time>"
+   char header[2 * Time::s_maxformat + 16];
+   char* p = header;
    if (cptime.empty() == false)
    {
-      os << Time::e_long << cptime << "  ";
+      p += cptime.format(p, Time::e_long);
+      *p++ = ' ';
+      *p++ = ' ';
+   }
+   memcpy(p, "AP time: ", 9);
+   p += 9;
+   if (aptime.empty() == false)
+   {
+      p += aptime.format(p, Time::e_plain);
+   }
+   else
+   {
+      memcpy(p, "(empty)", 7);
+      p += 7;
    }
-   os << "AP time: " << aptime << endl;
+   *p++ = '\n';
+   os.write(header, p - header);
 
    // Trim output so it always ends with two new lines
-   int i;
-   for (i = size - 1; i >= 0; i--)
+   while ((size > 0) && isSpace(buf[size - 1]))
    {
-      if (!isspace(buf[i])) break;
+      size--;
    }
-   os.write(buf, i + 1);
-   os << endl << endl;
+   os.write(buf, size);
+   os.write("\n\n", 2);
 }
 
 //----------------------------------------------------------------------------------------
@@ -1125,6 +2189,7 @@ void AppendTask::dumpHeader(t_header header) const
    cout << "CP Time:   " << Time::e_pretty << Time(header.m_cptime) << endl;
    cout << "AP Time:   " << Time::e_pretty << Time(header.m_aptime) << endl;
    cout << "Size:      " << header.m_size << endl;
+   cout << "CRC:       " << hex << header.m_crc << dec << endl;
    cout << endl;
 }
 
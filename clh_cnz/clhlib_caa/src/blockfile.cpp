@@ -0,0 +1,524 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      blockfile.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Classes for compressed log subfiles.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "blockfile.h"
+#include "exception.h"
+#include <zlib.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace PES_CLH {
+
+//========================================================================================
+// Class BlockFile
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Write a compressed copy of a subfile
+//----------------------------------------------------------------------------------------
+uintmax_t BlockFile::compress(const fs::path& path, const fs::path& tmppath)
+{
+   fs::ifstream ifs(path, ios_base::binary);
+   if (ifs.is_open() == false)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to open file " << path << ".";
+      ex.sysError();
+      throw ex;
+   }
+
+   uintmax_t size = fs::file_size(path);
+   vector<char> data(size + 1);
+   ifs.read(&data[0], size);
+   if (ifs.fail())
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to read file " << path << ".";
+      ex.sysError();
+      throw ex;
+   }
+   ifs.close();
+
+   fs::ofstream ofs(tmppath, ios_base::binary | ios_base::trunc);
+   if (ofs.is_open() == false)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to create file " << tmppath << ".";
+      ex.sysError();
+      throw ex;
+   }
+
+   t_blockheader header;
+   header.m_magic = s_magic;
+   header.m_version = s_version;
+   header.m_size = size;
+   header.m_framesize = s_framesize;
+   header.m_frames = (size + s_framesize - 1) / s_framesize;
+
+   // The frame offsets are written when all frames are compressed
+   vector<uint64_t> offsets(header.m_frames + 1);
+   uint64_t offset = sizeof(t_blockheader) + offsets.size() * sizeof(uint64_t);
+   ofs.seekp(offset);
+
+   vector<Bytef> cbuffer(compressBound(s_framesize));
+   for (uint32_t frame = 0; frame < header.m_frames; frame++)
+   {
+      uintmax_t pos = static_cast<uintmax_t>(frame) * s_framesize;
+      uLong len = min<uintmax_t>(s_framesize, size - pos);
+      uLongf clen = cbuffer.size();
+      if (compress2(&cbuffer[0], &clen, reinterpret_cast<const Bytef*>(&data[pos]), len,
+                    Z_BEST_SPEED) != Z_OK)
+      {
+         Exception ex(Exception::internal(), WHERE__);
+         ex << "Failed to compress file " << path << ".";
+         throw ex;
+      }
+      ofs.write(reinterpret_cast<const char*>(&cbuffer[0]), clen);
+      offsets[frame] = offset;
+      offset += clen;
+   }
+   offsets[header.m_frames] = offset;
+
+   ofs.seekp(0, ios_base::beg);
+   ofs.write(reinterpret_cast<const char*>(&header), sizeof(t_blockheader));
+   ofs.write(reinterpret_cast<const char*>(&offsets[0]), offsets.size() * sizeof(uint64_t));
+   ofs.close();
+   if (ofs.fail() || (sync(tmppath) == false))
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to write file " << tmppath << ".";
+      ex.sysError();
+      throw ex;
+   }
+   return offset;
+}
+
+//----------------------------------------------------------------------------------------
+// Replace a compressed subfile with its uncompressed contents
+//----------------------------------------------------------------------------------------
+void BlockFile::decompress(const fs::path& path, uintmax_t size)
+{
+   BlockIfstream ifs(path);
+   vector<char> data(size + 1);
+   ifs.read(&data[0], size);
+   if (ifs.fail())
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to read file " << path << ".";
+      throw ex;
+   }
+   ifs.close();
+
+   const fs::path tmppath(path.string() + ".z_");
+   fs::ofstream ofs(tmppath, ios_base::binary | ios_base::trunc);
+   ofs.write(&data[0], size);
+   ofs.close();
+   if (ofs.fail() || (sync(tmppath) == false))
+   {
+      boost::system::error_code ec;
+      fs::remove(tmppath, ec);
+
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to write file " << tmppath << ".";
+      ex.sysError();
+      throw ex;
+   }
+   fs::rename(tmppath, path);
+}
+
+//----------------------------------------------------------------------------------------
+// Flush a written file to disk
+//----------------------------------------------------------------------------------------
+bool BlockFile::sync(const fs::path& path)
+{
+   // The file is renamed over a subfile, a crash must not leave the subfile empty
+   int fd = ::open(path.c_str(), O_RDONLY);
+   bool ok = (fd != -1) && (fdatasync(fd) == 0);
+   if (fd != -1)
+   {
+      ok = (::close(fd) == 0) && ok;
+   }
+   return ok;
+}
+
+//----------------------------------------------------------------------------------------
+// Check if a subfile is compressed
+//----------------------------------------------------------------------------------------
+bool BlockFile::isCompressed(const fs::path& path)
+{
+   fs::ifstream ifs(path, ios_base::binary);
+   t_blockheader header;
+   ifs.read(reinterpret_cast<char*>(&header), sizeof(t_blockheader));
+   return ifs.good() && (header.m_magic == s_magic) && (header.m_version == s_version);
+}
+
+//----------------------------------------------------------------------------------------
+// Get the uncompressed size of a subfile
+//----------------------------------------------------------------------------------------
+uintmax_t BlockFile::getSize(const fs::path& path, boost::system::error_code& ec)
+{
+   uintmax_t size = fs::file_size(path, ec);
+   if (ec || (size < sizeof(t_blockheader)))
+   {
+      return size;
+   }
+
+   fs::ifstream ifs(path, ios_base::binary);
+   t_blockheader header;
+   ifs.read(reinterpret_cast<char*>(&header), sizeof(t_blockheader));
+   if (ifs.good() && (header.m_magic == s_magic) && (header.m_version == s_version))
+   {
+      return header.m_size;
+   }
+   return size;
+}
+
+//========================================================================================
+// Class BlockStreamBuf
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+BlockStreamBuf::BlockStreamBuf():
+std::streambuf(),
+m_file(),
+m_header(),
+m_offsets(),
+m_buffer(),
+m_cbuffer(),
+m_base(0),
+m_frame(0)
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+BlockStreamBuf::~BlockStreamBuf()
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Open a compressed subfile
+//----------------------------------------------------------------------------------------
+bool BlockStreamBuf::open(const fs::path& path)
+{
+   close();
+
+   m_file.open(path, ios_base::binary);
+   m_file.read(reinterpret_cast<char*>(&m_header), sizeof(BlockFile::t_blockheader));
+   if (m_file.fail() ||
+       (m_header.m_magic != BlockFile::s_magic) ||
+       (m_header.m_version != BlockFile::s_version) ||
+       (m_header.m_framesize == 0) ||
+       (m_header.m_frames != (m_header.m_size + m_header.m_framesize - 1) / m_header.m_framesize))
+   {
+      close();
+      return false;
+   }
+
+   m_offsets.resize(m_header.m_frames + 1);
+   m_file.read(reinterpret_cast<char*>(&m_offsets[0]), m_offsets.size() * sizeof(uint64_t));
+   if (m_file.fail())
+   {
+      close();
+      return false;
+   }
+
+   m_buffer.resize(m_header.m_framesize);
+   m_frame = m_header.m_frames;           // No frame read
+   m_base = 0;
+   setg(0, 0, 0);
+   return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Close subfile
+//----------------------------------------------------------------------------------------
+void BlockStreamBuf::close()
+{
+   if (m_file.is_open())
+   {
+      m_file.close();
+   }
+   m_file.clear();
+   m_header = BlockFile::t_blockheader();
+   m_offsets.clear();
+   m_base = 0;
+   m_frame = 0;
+   setg(0, 0, 0);
+}
+
+//----------------------------------------------------------------------------------------
+// Get the uncompressed size
+//----------------------------------------------------------------------------------------
+uintmax_t BlockStreamBuf::size() const
+{
+   return m_header.m_size;
+}
+
+//----------------------------------------------------------------------------------------
+// Read the next frame
+//----------------------------------------------------------------------------------------
+BlockStreamBuf::int_type BlockStreamBuf::underflow()
+{
+   if (gptr() < egptr())
+   {
+      return traits_type::to_int_type(*gptr());
+   }
+
+   uint64_t pos = m_base + (egptr() - eback());
+   if ((pos >= m_header.m_size) || (loadFrame(pos / m_header.m_framesize) == false))
+   {
+      return traits_type::eof();
+   }
+
+   char* const begin = &m_buffer[0];
+   size_t len = min<uint64_t>(m_header.m_framesize, m_header.m_size - m_base);
+   setg(begin, begin + (pos - m_base), begin + len);
+   return traits_type::to_int_type(*gptr());
+}
+
+//----------------------------------------------------------------------------------------
+// Seek to a relative position
+//----------------------------------------------------------------------------------------
+BlockStreamBuf::pos_type BlockStreamBuf::seekoff(
+      off_type off,
+      ios_base::seekdir dir,
+      ios_base::openmode which
+      )
+{
+   off_type base;
+   switch (dir)
+   {
+   case ios_base::beg: base = 0; break;
+   case ios_base::cur: base = m_base + (gptr() - eback()); break;
+   default:            base = m_header.m_size; break;
+   }
+
+   if (base + off < 0)
+   {
+      return pos_type(off_type(-1));
+   }
+   return seekpos(pos_type(base + off), which);
+}
+
+//----------------------------------------------------------------------------------------
+// Seek to an absolute position
+//----------------------------------------------------------------------------------------
+BlockStreamBuf::pos_type BlockStreamBuf::seekpos(pos_type pos, ios_base::openmode which)
+{
+   uint64_t offset = static_cast<off_type>(pos);
+   if (((which & ios_base::in) == 0) || (m_file.is_open() == false) ||
+       (offset > m_header.m_size))
+   {
+      return pos_type(off_type(-1));
+   }
+
+   char* const begin = &m_buffer[0];
+   if (offset == m_header.m_size)
+   {
+      // End of file, the next read returns eof
+      m_frame = m_header.m_frames;
+      m_base = offset;
+      setg(begin, begin, begin);
+      return pos;
+   }
+
+   if (loadFrame(offset / m_header.m_framesize) == false)
+   {
+      return pos_type(off_type(-1));
+   }
+   size_t len = min<uint64_t>(m_header.m_framesize, m_header.m_size - m_base);
+   setg(begin, begin + (offset - m_base), begin + len);
+   return pos;
+}
+
+//----------------------------------------------------------------------------------------
+// Decompress a frame into the read buffer
+//----------------------------------------------------------------------------------------
+bool BlockStreamBuf::loadFrame(uint32_t frame)
+{
+   if (frame == m_frame)
+   {
+      return true;
+   }
+
+   m_frame = m_header.m_frames;           // No valid frame if the read fails
+   if ((frame >= m_header.m_frames) || (m_offsets[frame + 1] < m_offsets[frame]))
+   {
+      return false;
+   }
+
+   uLong clen = m_offsets[frame + 1] - m_offsets[frame];
+   m_cbuffer.resize(clen + 1);
+   m_file.clear();
+   m_file.seekg(m_offsets[frame]);
+   m_file.read(&m_cbuffer[0], clen);
+   if (m_file.fail())
+   {
+      return false;
+   }
+
+   uint64_t base = static_cast<uint64_t>(frame) * m_header.m_framesize;
+   uLongf len = min<uint64_t>(m_header.m_framesize, m_header.m_size - base);
+   uLongf size = len;
+   if ((uncompress(reinterpret_cast<Bytef*>(&m_buffer[0]), &size,
+                   reinterpret_cast<const Bytef*>(&m_cbuffer[0]), clen) != Z_OK) ||
+       (size != len))
+   {
+      return false;
+   }
+
+   m_base = base;
+   m_frame = frame;
+   return true;
+}
+
+//========================================================================================
+// Class BlockIfstream
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+BlockIfstream::BlockIfstream():
+std::istream(0),
+m_filebuf(),
+m_blockbuf(),
+m_isopen(false),
+m_compressed(false),
+m_size(0)
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+BlockIfstream::BlockIfstream(const fs::path& path):
+std::istream(0),
+m_filebuf(),
+m_blockbuf(),
+m_isopen(false),
+m_compressed(false),
+m_size(0)
+{
+   open(path);
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+BlockIfstream::~BlockIfstream()
+{
+   close();
+}
+
+//----------------------------------------------------------------------------------------
+// Open a compressed or plain subfile
+//----------------------------------------------------------------------------------------
+void BlockIfstream::open(const fs::path& path)
+{
+   close();
+
+   if (m_blockbuf.open(path))
+   {
+      m_compressed = true;
+      m_size = m_blockbuf.size();
+      rdbuf(&m_blockbuf);
+   }
+   else if (m_filebuf.open(path.c_str(), ios_base::in | ios_base::binary))
+   {
+      boost::system::error_code ec;
+      m_compressed = false;
+      m_size = fs::file_size(path, ec);
+      rdbuf(&m_filebuf);
+   }
+   else
+   {
+      // Failed to open
+      setstate(ios_base::failbit);
+      return;
+   }
+   m_isopen = true;
+}
+
+//----------------------------------------------------------------------------------------
+// Check if subfile is open
+//----------------------------------------------------------------------------------------
+bool BlockIfstream::is_open() const
+{
+   return m_isopen;
+}
+
+//----------------------------------------------------------------------------------------
+// Close subfile
+//----------------------------------------------------------------------------------------
+void BlockIfstream::close()
+{
+   rdbuf(0);
+   m_blockbuf.close();
+   if (m_filebuf.is_open())
+   {
+      m_filebuf.close();
+   }
+   m_isopen = false;
+   m_compressed = false;
+   m_size = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Check if subfile is compressed
+//----------------------------------------------------------------------------------------
+bool BlockIfstream::isCompressed() const
+{
+   return m_compressed;
+}
+
+//----------------------------------------------------------------------------------------
+// Get the uncompressed size
+//----------------------------------------------------------------------------------------
+uintmax_t BlockIfstream::size() const
+{
+   return m_size;
+}
+
+}
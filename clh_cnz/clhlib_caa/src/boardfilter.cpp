@@ -38,12 +38,16 @@
 
 #include "boardfilter.h"
 #include "exception.h"
-#include <boost/lexical_cast.hpp>
+#include <string.h>
 
 using namespace std;
 
 namespace PES_CLH {
 
+const char BoardFilter::s_traplabel[] = "Trap OID: ";
+const char BoardFilter::s_subracklabel[] = "Subrack id: ";
+const char BoardFilter::s_slotlabel[] = "Slot number: ";
+
 //----------------------------------------------------------------------------------------
 // Constructors  
 //----------------------------------------------------------------------------------------
@@ -76,57 +80,129 @@ bool BoardFilter::empty() const
    return m_magazine == ~uint32_t();
 }
 
+//----------------------------------------------------------------------------------------
+// Check if the filter reads the event data
+//----------------------------------------------------------------------------------------
+bool BoardFilter::needsData() const
+{
+   return empty() == false;
+}
+
 //----------------------------------------------------------------------------------------
 // Test based on subrack id and slot number     
 //----------------------------------------------------------------------------------------
-bool BoardFilter::test(const string& str) const
+bool BoardFilter::test(const char* data, size_t size) const
 {
    if (m_magazine == ~uint32_t()) return true;
 
-   const string s_trap("Trap OID: ");
-   const string s_subrack("Subrack id: ");   
-   const string s_slot("Slot number: ");
+   const char* pos = data;
+   const char* end = data + size;
+   const char* item;
+   const char* itemend;
 
-   string value;
-   size_t pos(0);
-   try
+   if (getItem(s_traplabel, pos, end, item, itemend) == false)
    {
-      value = getItem(s_trap, str, pos);
-      //boost::lexical_cast<uint16_t>(value);
-
-      // Parse subrack id
-      value = getItem(s_subrack, str, pos);
-      Magazine magazine(value);
+      return false;
+   }
 
-      // Parse slot number
-      value = getItem(s_slot, str, pos);
-      Slot slot(value);
+   // Parse subrack id, four address plugs separated by dots
+   if (getItem(s_subracklabel, pos, end, item, itemend) == false)
+   {
+      return false;
+   }
+   for (uint32_t i = 0; i < 4; i++)
+   {
+      const char* plugend = static_cast<const char*>(memchr(item, '.', itemend - item));
+      if ((plugend == 0) != (i == 3))
+      {
+         return false;
+      }
+      if (plugend == 0)
+      {
+         plugend = itemend;
+      }
+      uint32_t plug;
+      if ((parseNumber(item, plugend, 15, plug) == false) ||
+          (static_cast<int>(plug) != m_magazine[i]))
+      {
+         return false;
+      }
+      item = plugend + 1;
+   }
 
-      return (magazine == m_magazine) && (slot == m_slot);
+   // Parse slot number
+   if (getItem(s_slotlabel, pos, end, item, itemend) == false)
+   {
+      return false;
    }
-   catch (exception&)
+   uint32_t slot;
+   if ((parseNumber(item, itemend, 28, slot) == false) || (slot == 27))
    {
       return false;
    }
+
+   return slot == m_slot;
 }
 
 //----------------------------------------------------------------------------------------
 // Get item from stream    
 //----------------------------------------------------------------------------------------
-string BoardFilter::getItem(
-                        const string& label, 
-                        const string& str, 
-                        size_t& pos
+bool BoardFilter::getItem(
+                        const char* label,
+                        const char*& pos,
+                        const char* end,
+                        const char*& item,
+                        const char*& itemend
                         ) const
 {
-   if (str.find(label, pos) != pos)
-   {   
-      throw exception();
+   size_t size = strlen(label);
+   if ((static_cast<size_t>(end - pos) < size) || (memcmp(pos, label, size) != 0))
+   {
+      return false;
+   }
+   item = pos + size;
+   itemend = static_cast<const char*>(memchr(item, '\n', end - item));
+   if (itemend == 0)
+   {
+      // Last line
+      itemend = end;
+      pos = end;
+   }
+   else
+   {
+      pos = itemend + 1;
+   }
+   return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Parse a decimal number
+//----------------------------------------------------------------------------------------
+bool BoardFilter::parseNumber(
+                        const char* pos,
+                        const char* end,
+                        uint32_t max,
+                        uint32_t& value
+                        )
+{
+   if (pos == end)
+   {
+      return false;
+   }
+   value = 0;
+   for (; pos != end; ++pos)
+   {
+      if ((*pos < '0') || (*pos > '9'))
+      {
+         return false;
+      }
+      value = value * 10 + (*pos - '0');
+      if (value > max)
+      {
+         return false;
+      }
    }
-   size_t size = label.size();   
-   size_t pos1 = pos + size;
-   pos = str.find_first_of('\n', pos1);   
-   return str.substr(pos1, pos++ - pos1);
+   return true;
 }
 
 }
@@ -0,0 +1,206 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      bufferpool.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Process wide pool of message buffers.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "bufferpool.h"
+#include "parameters.h"
+#include "logger.h"
+#include <sstream>
+
+using namespace std;
+
+namespace PES_CLH {
+
+BufferPool* BufferPool::s_instance = 0;
+boost::once_flag BufferPool::s_once = BOOST_ONCE_INIT;
+
+//========================================================================================
+// Class BufferPool::Buffer
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor, a buffer is borrowed from the pool
+//----------------------------------------------------------------------------------------
+BufferPool::Buffer::Buffer():
+m_data(instance().acquire())
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor, the buffer is returned to the pool
+//----------------------------------------------------------------------------------------
+BufferPool::Buffer::~Buffer()
+{
+   instance().release(m_data);
+}
+
+//----------------------------------------------------------------------------------------
+// Get the buffer
+//----------------------------------------------------------------------------------------
+char* BufferPool::Buffer::get() const
+{
+   return m_data;
+}
+
+//----------------------------------------------------------------------------------------
+// Get the buffer size, a buffer holds one log event of maximum size
+//----------------------------------------------------------------------------------------
+size_t BufferPool::Buffer::size()
+{
+   return BaseParameters::s_maxfilesize;
+}
+
+//========================================================================================
+// Class BufferPool
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+BufferPool::BufferPool():
+m_free(),
+m_inuse(0),
+m_highwater(0),
+m_mutex()
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Get number of buffers in use
+//----------------------------------------------------------------------------------------
+size_t BufferPool::getInUse()
+{
+   BufferPool& pool = instance();
+   boost::mutex::scoped_lock lock(pool.m_mutex);
+   return pool.m_inuse;
+}
+
+//----------------------------------------------------------------------------------------
+// Get the high-water mark for buffers in use
+//----------------------------------------------------------------------------------------
+size_t BufferPool::getHighWater()
+{
+   BufferPool& pool = instance();
+   boost::mutex::scoped_lock lock(pool.m_mutex);
+   return pool.m_highwater;
+}
+
+//----------------------------------------------------------------------------------------
+// Get the pool
+//----------------------------------------------------------------------------------------
+BufferPool& BufferPool::instance()
+{
+   boost::call_once(s_once, &BufferPool::create);
+   return *s_instance;
+}
+
+//----------------------------------------------------------------------------------------
+// Create the pool
+//----------------------------------------------------------------------------------------
+void BufferPool::create()
+{
+   s_instance = new BufferPool();
+}
+
+//----------------------------------------------------------------------------------------
+// Borrow a buffer, a new high-water mark is reported to the internal log
+//----------------------------------------------------------------------------------------
+char* BufferPool::acquire()
+{
+   char* data = 0;
+   size_t highwater = 0;
+   {
+      boost::mutex::scoped_lock lock(m_mutex);
+      if (m_free.empty() == false)
+      {
+         data = m_free.back();
+         m_free.pop_back();
+      }
+      if (++m_inuse > m_highwater)
+      {
+         m_highwater = m_inuse;
+         highwater = m_highwater;
+      }
+   }
+
+   if (data == 0)
+   {
+      try
+      {
+         data = new char[Buffer::size()];
+      }
+      catch (...)
+      {
+         boost::mutex::scoped_lock lock(m_mutex);
+         m_inuse--;
+         throw;
+      }
+   }
+
+   if (highwater)
+   {
+      Logger logger(LOG_LEVEL_INFO);
+      if (logger)
+      {
+         ostringstream s;
+         s << "Buffer pool high-water mark is " << highwater << " buffer(s) of "
+           << Buffer::size() << " bytes.";
+         logger.event(WHERE__, s.str());
+      }
+   }
+
+   return data;
+}
+
+//----------------------------------------------------------------------------------------
+// Return a buffer, buffers above the idle limit are freed
+//----------------------------------------------------------------------------------------
+void BufferPool::release(char* data)
+{
+   {
+      boost::mutex::scoped_lock lock(m_mutex);
+      m_inuse--;
+      if (m_free.size() < s_maxfree)
+      {
+         m_free.push_back(data);
+         return;
+      }
+   }
+   delete[] data;
+}
+
+}
@@ -41,18 +41,40 @@
 #include "cpinfo.h"
 #include "exception.h"
 #include "logger.h"
+#include "zipwriter.h"
 #include <acs_apgcc_paramhandling.h>
 #include <ACS_APGCC_CommonLib.h>
 #include <ACS_DSD_Client.h>
 
 #include <boost/filesystem/fstream.hpp>
 #include <boost/algorithm/string.hpp>
+#include <boost/bind.hpp>
+#include <boost/thread/tss.hpp>
 #include <sys/mount.h>
 
 using namespace std;
 
 namespace PES_CLH {
 
+namespace {
+
+// The list is owned by the caller of setArchiveList
+void noCleanup(Common::ARCHIVELIST*)
+{
+}
+
+boost::thread_specific_ptr<Common::ARCHIVELIST> s_archivelist(noCleanup);
+
+// The writer is owned by ArchiveSession
+void noCleanup(ZipWriter*)
+{
+}
+
+// Archive of the current session of each thread
+boost::thread_specific_ptr<ZipWriter> s_writer(noCleanup);
+
+}
+
 //----------------------------------------------------------------------------------------
 // Get software version
 //----------------------------------------------------------------------------------------
@@ -172,6 +194,23 @@ int Common::executeCommand(const string& command, ostream& os)
 //----------------------------------------------------------------------------------------
 void Common::archive(const fs::path& source, const fs::path& dest)
 {
+   ARCHIVELIST* const archivelistp = s_archivelist.get();
+   if (archivelistp)
+   {
+      // Deferred, executed later by the owner of the list
+      void (*func)(const fs::path&, const fs::path&) = &Common::archive;
+      archivelistp->push_back(boost::bind(func, source, dest));
+      return;
+   }
+
+   ZipWriter* const writerp = s_writer.get();
+   if (writerp)
+   {
+      writerp->add(source);
+      fs::remove_all(source);
+      return;
+   }
+
    stringstream command;
 
    command << "zip -mr " << "\"" << dest << "\" \"" << source << "\"";
@@ -188,6 +227,54 @@ void Common::archive(const fs::path& source, const fs::path& dest)
    }
 }
 
+//----------------------------------------------------------------------------------------
+// Insert entry in archive
+//----------------------------------------------------------------------------------------
+void Common::archive(const string& name, const boost::shared_ptr<ZipEntry>& entryp)
+{
+   ARCHIVELIST* const archivelistp = s_archivelist.get();
+   if (archivelistp)
+   {
+      // Deferred, executed later by the owner of the list
+      void (*func)(const string&, const boost::shared_ptr<ZipEntry>&) = &Common::archive;
+      archivelistp->push_back(boost::bind(func, name, entryp));
+      return;
+   }
+
+   ZipWriter* const writerp = s_writer.get();
+   if (writerp == 0)
+   {
+      Exception ex(Exception::internal(), WHERE__);
+      ex << "No archive session for entry " << name << ".";
+      throw ex;
+   }
+   writerp->add(name, *entryp);
+}
+
+//----------------------------------------------------------------------------------------
+//   Get the archive of the current session of the calling thread
+//----------------------------------------------------------------------------------------
+ZipWriter* Common::getArchive()
+{
+   return s_writer.get();
+}
+
+//----------------------------------------------------------------------------------------
+//   Set archive for the insertions made by the calling thread
+//----------------------------------------------------------------------------------------
+void Common::setArchive(ZipWriter* writerp)
+{
+   s_writer.reset(writerp);
+}
+
+//----------------------------------------------------------------------------------------
+//   Defer archive insertions made by the calling thread
+//----------------------------------------------------------------------------------------
+void Common::setArchiveList(ARCHIVELIST* archivelistp)
+{
+   s_archivelist.reset(archivelistp);
+}
+
 //----------------------------------------------------------------------------------------
 //   Get data disk path path
 //----------------------------------------------------------------------------------------
@@ -0,0 +1,214 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      compressor.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Class for background compression of sealed log subfiles.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "compressor.h"
+#include "blockfile.h"
+#include "exception.h"
+#include "logger.h"
+#include <algorithm>
+#include <sstream>
+
+using namespace std;
+
+namespace PES_CLH {
+
+Compressor* Compressor::s_instance = 0;
+boost::once_flag Compressor::s_once = BOOST_ONCE_INIT;
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+Compressor::Compressor():
+m_queue(),
+m_current(),
+m_cancelled(false),
+m_mutex(),
+m_cond(),
+m_thread()
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Queue a sealed subfile for compression
+//----------------------------------------------------------------------------------------
+void Compressor::add(const fs::path& path)
+{
+   Compressor& compressor = instance();
+   {
+      boost::mutex::scoped_lock lock(compressor.m_mutex);
+      if (find(compressor.m_queue.begin(), compressor.m_queue.end(), path) !=
+          compressor.m_queue.end())
+      {
+         // Already queued
+         return;
+      }
+      compressor.m_queue.push_back(path);
+   }
+   compressor.m_cond.notify_one();
+}
+
+//----------------------------------------------------------------------------------------
+// Cancel compression of a subfile that is to be appended to
+//----------------------------------------------------------------------------------------
+void Compressor::cancel(const fs::path& path)
+{
+   Compressor& compressor = instance();
+   boost::mutex::scoped_lock lock(compressor.m_mutex);
+   compressor.dequeue(path);
+}
+
+//----------------------------------------------------------------------------------------
+// Remove a subfile, a compression in progress for the subfile is cancelled
+//----------------------------------------------------------------------------------------
+void Compressor::remove(const fs::path& path)
+{
+   Compressor& compressor = instance();
+   boost::mutex::scoped_lock lock(compressor.m_mutex);
+   compressor.dequeue(path);
+   fs::remove(path);
+}
+
+//----------------------------------------------------------------------------------------
+// Get the compressor, the worker thread is started at first use
+//----------------------------------------------------------------------------------------
+Compressor& Compressor::instance()
+{
+   boost::call_once(s_once, &Compressor::create);
+   return *s_instance;
+}
+
+//----------------------------------------------------------------------------------------
+// Create the compressor
+//----------------------------------------------------------------------------------------
+void Compressor::create()
+{
+   s_instance = new Compressor();
+   s_instance->m_thread = boost::thread(&Compressor::run, s_instance);
+}
+
+//----------------------------------------------------------------------------------------
+// Worker thread, compress subfiles from the queue
+//----------------------------------------------------------------------------------------
+void Compressor::run()
+{
+   while (true)
+   {
+      fs::path path;
+      {
+         boost::mutex::scoped_lock lock(m_mutex);
+         while (m_queue.empty())
+         {
+            m_cond.wait(lock);
+         }
+         path = m_queue.front();
+         m_queue.pop_front();
+         m_current = path;
+         m_cancelled = false;
+      }
+
+      compress(path);
+
+      boost::mutex::scoped_lock lock(m_mutex);
+      m_current.clear();
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Compress a subfile
+//----------------------------------------------------------------------------------------
+void Compressor::compress(const fs::path& path)
+{
+   const fs::path tmppath(path.string() + ".z_");
+   boost::system::error_code ec;
+
+   try
+   {
+      if ((fs::exists(path) == false) || BlockFile::isCompressed(path))
+      {
+         return;
+      }
+
+      uintmax_t size = fs::file_size(path);
+      uintmax_t csize = BlockFile::compress(path, tmppath);
+
+      // Replace the subfile only if it is unchanged, the compressed copy is already
+      // on disk
+      boost::mutex::scoped_lock lock(m_mutex);
+      uintmax_t newsize = fs::file_size(path, ec);
+      if (m_cancelled || ec || (newsize != size) || (csize >= size))
+      {
+         fs::remove(tmppath, ec);
+         return;
+      }
+      fs::rename(tmppath, path);
+
+      // Log event
+      Logger logger(LOG_LEVEL_DEBUG);
+      if (logger)
+      {
+         ostringstream s;
+         s << "Log file " << path << " compressed from " << size << " to "
+           << csize << " bytes.";
+         logger.event(WHERE__, s.str());
+      }
+   }
+   catch (Exception& ex)
+   {
+      fs::remove(tmppath, ec);
+      Logger::event(LOG_LEVEL_WARN, ex);
+   }
+   catch (std::exception& ex)
+   {
+      fs::remove(tmppath, ec);
+      Logger::event(LOG_LEVEL_WARN, WHERE__, ex.what());
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Remove a subfile from the queue, the mutex must be locked
+//----------------------------------------------------------------------------------------
+void Compressor::dequeue(const fs::path& path)
+{
+   m_queue.erase(std::remove(m_queue.begin(), m_queue.end(), path), m_queue.end());
+   if (m_current == path)
+   {
+      m_cancelled = true;
+   }
+}
+
+}
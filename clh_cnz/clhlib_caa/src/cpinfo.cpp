@@ -41,6 +41,7 @@
 #include "exception.h"
 #include "logger.h"
 #include <boost/algorithm/string.hpp>
+#include <boost/thread/mutex.hpp>
 #include <iostream>
 
 using namespace std;
@@ -370,6 +371,13 @@ bool CPTable::const_iterator::operator!=(const const_iterator& iter) const
 
 boost::tribool CPTable::s_multiCPSystem(boost::indeterminate);
 
+namespace {
+
+// Serializes the first check of the system type, the API may be used from several threads
+boost::mutex s_multiCPMutex;
+
+}
+
 //----------------------------------------------------------------------------------------
 //   Constructors
 //----------------------------------------------------------------------------------------
@@ -638,6 +646,7 @@ CPTable::const_iterator CPTable::end() const
 //----------------------------------------------------------------------------------------
 bool CPTable::isMultiCPSystem()
 {
+   boost::mutex::scoped_lock lock(s_multiCPMutex);
    if (boost::indeterminate(s_multiCPSystem))
    {
       bool multiCPSystem;
@@ -0,0 +1,150 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      crc32c.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      CRC32C (Castagnoli) checksum for the log record headers.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "crc32c.h"
+#include <string.h>
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#endif
+
+namespace PES_CLH {
+
+namespace {
+
+// Lookup table for the software implementation
+class CrcTable
+{
+public:
+   CrcTable(uint32_t poly)
+   {
+      for (uint32_t i = 0; i < 256; i++)
+      {
+         uint32_t crc = i;
+         for (int j = 0; j < 8; j++)
+         {
+            crc = (crc & 1)? (crc >> 1) ^ poly: crc >> 1;
+         }
+         m_table[i] = crc;
+      }
+   }
+
+   uint32_t operator[](size_t i) const {return m_table[i];}
+
+private:
+   uint32_t m_table[256];
+};
+
+// Check if the processor supports SSE4.2
+bool checkHardware()
+{
+#if defined(__x86_64__) || defined(__i386__)
+   unsigned int eax, ebx, ecx, edx;
+   if (__get_cpuid(1, &eax, &ebx, &ecx, &edx))
+   {
+      return (ecx & bit_SSE4_2) != 0;
+   }
+#endif
+   return false;
+}
+
+}
+
+const bool Crc32c::s_hardware = checkHardware();
+
+//----------------------------------------------------------------------------------------
+// Update a checksum with a block of data
+//----------------------------------------------------------------------------------------
+uint32_t Crc32c::update(uint32_t crc, const void* data, size_t size)
+{
+   const unsigned char* buf = static_cast<const unsigned char*>(data);
+   crc = ~crc;
+   crc = s_hardware? updateHardware(crc, buf, size): updateSoftware(crc, buf, size);
+   return ~crc;
+}
+
+//----------------------------------------------------------------------------------------
+// Check if the CRC32 instruction is used
+//----------------------------------------------------------------------------------------
+bool Crc32c::isHardware()
+{
+   return s_hardware;
+}
+
+//----------------------------------------------------------------------------------------
+// Calculate checksum with the CRC32 instruction
+//----------------------------------------------------------------------------------------
+#if defined(__x86_64__)
+__attribute__((target("sse4.2")))
+uint32_t Crc32c::updateHardware(uint32_t crc, const unsigned char* data, size_t size)
+{
+   uint64_t crc64 = crc;
+   for (; size >= sizeof(uint64_t); size -= sizeof(uint64_t), data += sizeof(uint64_t))
+   {
+      uint64_t word;
+      memcpy(&word, data, sizeof(uint64_t));
+      crc64 = __builtin_ia32_crc32di(crc64, word);
+   }
+   crc = static_cast<uint32_t>(crc64);
+   for (; size > 0; size--, data++)
+   {
+      crc = __builtin_ia32_crc32qi(crc, *data);
+   }
+   return crc;
+}
+#else
+uint32_t Crc32c::updateHardware(uint32_t crc, const unsigned char* data, size_t size)
+{
+   return updateSoftware(crc, data, size);
+}
+#endif
+
+//----------------------------------------------------------------------------------------
+// Calculate checksum with the lookup table
+//----------------------------------------------------------------------------------------
+uint32_t Crc32c::updateSoftware(uint32_t crc, const unsigned char* data, size_t size)
+{
+   static const CrcTable table(s_poly);
+
+   for (; size > 0; size--, data++)
+   {
+      crc = table[(crc ^ *data) & 0xff] ^ (crc >> 8);
+   }
+   return crc;
+}
+
+}
@@ -41,6 +41,8 @@
 #include "exception.h"
 #include "common.h"
 #include "inotify.h"
+#include "transferscheduler.h"
+#include "transfercheckpoint.h"
 #include "eventhandler.h"
 #include <boost/tokenizer.hpp>
 #include <boost/numeric/conversion/cast.hpp>
@@ -165,6 +167,14 @@ bool DirTask::compareByDate(const string& file1, const string& file2)
    return time1 < time2;
 }
 
+//----------------------------------------------------------------------------------------
+// Check if the date and time part of a subfile name is before a time
+//----------------------------------------------------------------------------------------
+bool DirTask::isKeyBefore(const string& key, const Time& time)
+{
+   return parseFileName(key) < time;
+}
+
 //----------------------------------------------------------------------------------------
 // Insert file in log
 //----------------------------------------------------------------------------------------
@@ -396,7 +406,9 @@ Period DirTask::listEvents(const Period& period) const
    Time start(Time::s_maxtime);
    Time stop(Time::s_mintime);
 
-   // List the log files
+   // Date and time of the log files, the name ends with "YYYYMMDD_HHMMSS" so the
+   // names are sorted without parsing them
+   vector<string> keylist;
    const fs::path& logdir = getLogDir();
    fs::directory_iterator end;
    for (fs::directory_iterator iter(logdir); iter != end; ++iter)
@@ -404,18 +416,25 @@ Period DirTask::listEvents(const Period& period) const
       const string& filename = fs::path(*iter).filename().c_str();
       if (regex_match(filename, getParameters().getLogFile()))
       {
-         const Time& time = parseFileName(filename);
-
-         if (time >= period.first())
-         {
-            if (time < start) start = time;
-         }
-         if (time < period.last())
-         {
-            if (time > stop) stop = time;
-         }
+         keylist.push_back(filename.substr(filename.size() - 15));
       }
    }
+   sort(keylist.begin(), keylist.end());
+
+   // Find the first file at or after the start time and the last file before the
+   // stop time, only the compared names are parsed
+   vector<string>::iterator first =
+         lower_bound(keylist.begin(), keylist.end(), period.first(), isKeyBefore);
+   if (first != keylist.end())
+   {
+      start = parseFileName(*first);
+   }
+   vector<string>::iterator last =
+         lower_bound(keylist.begin(), keylist.end(), period.last(), isKeyBefore);
+   if (last != keylist.begin())
+   {
+      stop = parseFileName(*(last - 1));
+   }
 
    // Start & stop time not found
    if (start == Time::s_maxtime && stop == Time::s_mintime)
@@ -439,6 +458,18 @@ void DirTask::transferLogs(const Period& period, const Filter&) const
 {
    // Iterate the log files
    const fs::path& logdir = getLogDir();
+
+   // In an incremental transfer only the directories newer than the checkpoint are
+   // transferred, the checkpoint is the name of the newest directory transferred
+   string checkpoint = TransferCheckpoint::get(*this);
+   if (regex_match(checkpoint, getParameters().getLogFile()) == false)
+   {
+      checkpoint.clear();
+   }
+   const Time ckpttime = checkpoint.empty()? Time(): parseFileName(checkpoint);
+   string newcheckpoint = checkpoint;
+   Time newckpttime = ckpttime;
+
    fs::directory_iterator end;
    for (fs::directory_iterator iter(logdir); iter != end; ++iter)
    {
@@ -447,6 +478,13 @@ void DirTask::transferLogs(const Period& period, const Filter&) const
       {
          const Time& time = parseFileName(filename);
 
+         if (checkpoint.empty() == false &&
+             (time < ckpttime || (time == ckpttime && filename <= checkpoint)))
+         {
+            // Transferred before
+            continue;
+         }
+
          if (time >= period.first() && time <= period.last())
          {
             // Insert file in archive
@@ -463,13 +501,26 @@ void DirTask::transferLogs(const Period& period, const Filter&) const
                if (fs::is_regular_file(stat))
                {
                   fs::copy_file(*siter, destfile / subfilename);
+                  TransferScheduler::throttle(fs::file_size(subpath));
                }
             }
 
             Common::archive(destfile, "archive");      // Insert in zip-file
+
+            if (newcheckpoint.empty() || time > newckpttime ||
+                (time == newckpttime && filename > newcheckpoint))
+            {
+               newcheckpoint = filename;
+               newckpttime = time;
+            }
          }
       }
    }
+
+   if (newcheckpoint != checkpoint)
+   {
+      TransferCheckpoint::set(*this, newcheckpoint);
+   }
 }
 
 }
@@ -437,6 +437,41 @@ Exception::t_error Exception::illEndpoint(const string& ep)
    return t_error(128, s.str());
 }
 
+Exception::t_error Exception::illSearchPattern(const string& pattern)
+{
+   ostringstream s;
+   s << "Search pattern '" << pattern << "' is not valid.";
+   return t_error(129, s.str());
+}
+
+Exception::t_error Exception::illNoOfThreads(const string& threads)
+{
+   ostringstream s;
+   s << "Number of threads '" << threads << "' is invalid.";
+   return t_error(130, s.str());
+}
+
+Exception::t_error Exception::illCompressionLevel(const string& level)
+{
+   ostringstream s;
+   s << "Compression level '" << level << "' is invalid.";
+   return t_error(131, s.str());
+}
+
+Exception::t_error Exception::illBandwidth(const string& bandwidth)
+{
+   ostringstream s;
+   s << "Read bandwidth '" << bandwidth << "' is invalid.";
+   return t_error(132, s.str());
+}
+
+Exception::t_error Exception::illCpuShare(const string& cpushare)
+{
+   ostringstream s;
+   s << "CPU share '" << cpushare << "' is invalid.";
+   return t_error(133, s.str());
+}
+
 //----------------------------------------------------------------------------------------
 //   Outstream operator
 //----------------------------------------------------------------------------------------
@@ -43,6 +43,8 @@
 #include "message.h"
 #include "common.h"
 #include "xmfilter.h"
+#include "transferscheduler.h"
+#include "transfercheckpoint.h"
 #include "eventhandler.h"
 #include <boost/lexical_cast.hpp>
 #include <fcntl.h>
@@ -167,6 +169,33 @@ bool FileTask::compareByDate(const string& file1, const string& file2)
    return p1.first < p2.first;
 }
 
+//----------------------------------------------------------------------------------------
+// Get the date and time part of a log subfile name
+//----------------------------------------------------------------------------------------
+string FileTask::getTimeKey(const string& file)
+{
+   size_t pos = file.find_last_of('.');
+   return file.substr(pos - 15, 15);
+}
+
+//----------------------------------------------------------------------------------------
+// Get time from the date and time part of a subfile name
+//----------------------------------------------------------------------------------------
+Time FileTask::getKeyTime(const string& key)
+{
+   Time time;
+   time.set(key.substr(0, 8), key.substr(9, 6));
+   return time;
+}
+
+//----------------------------------------------------------------------------------------
+// Check if the date and time part of a subfile name is before a time
+//----------------------------------------------------------------------------------------
+bool FileTask::isKeyBefore(const string& key, const Time& time)
+{
+   return getKeyTime(key) < time;
+}
+
 //----------------------------------------------------------------------------------------
 //   Insert file in log
 //----------------------------------------------------------------------------------------
@@ -474,9 +503,6 @@ Period FileTask::readEvents(
 //----------------------------------------------------------------------------------------
 Period FileTask::listEvents(const Period& period) const
 {
-   Time start(Time::s_maxtime);
-   Time stop(Time::s_mintime);
-
    // List the log files
    const fs::path& logdir = getLogDir();
 
@@ -486,36 +512,32 @@ Period FileTask::listEvents(const Period& period) const
       return Period(Time(), Time());
    }
 
+   // Date and time of the log files, sorted without parsing them
+   vector<string> keylist;
    fs::directory_iterator end;
    for (fs::directory_iterator iter(logdir); iter != end; ++iter)
    {
       const string& filename = fs::path(*iter).filename().c_str();
       if (regex_match(filename, getParameters().getLogFile()))
       {
-         const PAIR& pair = parseFileName(filename);
-         const Time& time = pair.first;
-
-         if (time >= period.first() && time < period.last())
-         {
-            if (time < start) start = time;
-            if (time > stop) stop = time;
-         }
+         keylist.push_back(getTimeKey(filename));
       }
    }
+   sort(keylist.begin(), keylist.end());
+
+   // Find the files in the period, only the compared names are parsed
+   vector<string>::iterator first =
+         lower_bound(keylist.begin(), keylist.end(), period.first(), isKeyBefore);
+   vector<string>::iterator last =
+         lower_bound(first, keylist.end(), period.last(), isKeyBefore);
 
    // Start & stop time not found
-   if (start == Time::s_maxtime && stop == Time::s_mintime)
+   if (first == last)
    {
       return Period(Time(), Time());
    }
 
-   // Start greater than stop time
-   if  (start > stop)
-   {
-      throw StartGreatStopTimeException(start, stop, WHERE__);
-   }
-
-   return Period(start, stop);
+   return Period(getKeyTime(*first), getKeyTime(*(last - 1)));
 }
 
 //----------------------------------------------------------------------------------------
@@ -539,6 +561,17 @@ void FileTask::transferLogs(const Period& period, const Filter& filter) const
       return;
    }
 
+   // In an incremental transfer only the files newer than the checkpoint are transferred,
+   // the checkpoint is the name of the newest file transferred
+   string checkpoint = TransferCheckpoint::get(*this);
+   if (regex_match(checkpoint, getParameters().getLogFile()) == false)
+   {
+      checkpoint.clear();
+   }
+   const Time ckpttime = checkpoint.empty()? Time(): parseFileName(checkpoint).first;
+   string newcheckpoint = checkpoint;
+   Time newckpttime = ckpttime;
+
    fs::directory_iterator end;
    for (fs::directory_iterator iter(logdir); iter != end; ++iter)
    {
@@ -548,14 +581,22 @@ void FileTask::transferLogs(const Period& period, const Filter& filter) const
          const PAIR& pair = parseFileName(filename);
          const Time& time = pair.first;
 
+         if (checkpoint.empty() == false &&
+             (time < ckpttime || (time == ckpttime && filename <= checkpoint)))
+         {
+            // Transferred before
+            continue;
+         }
+
          if (time >= period.first() && time <= period.last())
          {
             bool match(true);
             if (filter.empty() == false)
             {
-               // Filter supplied, match events towards list of XM numbers
-               const XmFilter& xmfilter = dynamic_cast<const XmFilter&>(filter);
-               match = xmfilter.test(pair.second);
+               // Filter supplied, match events towards list of XM numbers.
+               // Other filters search the event text, which a log file does not have.
+               const XmFilter* xmfilterp = dynamic_cast<const XmFilter*>(&filter);
+               match = (xmfilterp != 0) && xmfilterp->test(pair.second);
             }
             if (match)
             {
@@ -567,10 +608,22 @@ void FileTask::transferLogs(const Period& period, const Filter& filter) const
                copyFile(*iter, destfile, offset);
 
                Common::archive(destfile, "archive");     // Insert in zip-file
+
+               if (newcheckpoint.empty() || time > newckpttime ||
+                   (time == newckpttime && filename > newcheckpoint))
+               {
+                  newcheckpoint = filename;
+                  newckpttime = time;
+               }
             }
          }
       }
    }
+
+   if (newcheckpoint != checkpoint)
+   {
+      TransferCheckpoint::set(*this, newcheckpoint);
+   }
 }
 
 //----------------------------------------------------------------------------------------
@@ -620,6 +673,7 @@ void FileTask::copyFile(const fs::path& source, const fs::path& target, ssize_t
       size = read(input, buf, bufsize);
       if (size > 0)
       {
+         TransferScheduler::throttle(size);
          size = write(output, buf, size);
       }
    }
@@ -0,0 +1,190 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      ingeststatus.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Ingest status published by the log server to the transfer commands.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "ingeststatus.h"
+#include "logger.h"
+#include "exception.h"
+#include <sstream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace PES_CLH {
+
+const char* const IngestStatus::s_path = "/var/run/apg/clhadm.ingest";
+const uint32_t IngestStatus::s_version = 1;
+const int64_t IngestStatus::s_maxlag = 2000000;         // 2 s
+const int64_t IngestStatus::s_maxbusy = 2000000;        // 2 s
+const int64_t IngestStatus::s_stale = 10000000;         // 10 s
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+IngestStatus::IngestStatus():
+m_statusp(0)
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+IngestStatus::~IngestStatus()
+{
+   if (m_statusp)
+   {
+      m_statusp->m_busysince = 0;
+      munmap(const_cast<t_status*>(m_statusp), sizeof(t_status));
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Create the status file
+//----------------------------------------------------------------------------------------
+void IngestStatus::create()
+{
+   if (m_statusp)
+   {
+      return;
+   }
+
+   void* addr = MAP_FAILED;
+   const int fd = ::open(s_path, O_RDWR | O_CREAT, 0644);
+   if (fd != -1)
+   {
+      if (ftruncate(fd, sizeof(t_status)) == 0)
+      {
+         addr = mmap(0, sizeof(t_status), PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+      }
+      ::close(fd);
+   }
+   if (addr == MAP_FAILED)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to create ingest status file " << s_path
+         << ", transfers do not back off for the log server.";
+      ex.sysError();
+      Logger::event(LOG_LEVEL_WARN, ex);
+      return;
+   }
+
+   m_statusp = static_cast<t_status*>(addr);
+   m_statusp->m_busysince = 0;
+   m_statusp->m_lag = 0;
+   m_statusp->m_updated = 0;
+   m_statusp->m_version = s_version;
+}
+
+//----------------------------------------------------------------------------------------
+// Handling of a temporary log file is started
+//----------------------------------------------------------------------------------------
+void IngestStatus::startEvent(const fs::path& path)
+{
+   if (m_statusp == 0)
+   {
+      return;
+   }
+
+   const int64_t now = getMonotonic();
+   m_statusp->m_busysince = now;
+   m_statusp->m_updated = now;
+
+   struct stat st;
+   timespec ts;
+   if ((::stat(path.c_str(), &st) == 0) && (clock_gettime(CLOCK_REALTIME, &ts) == 0))
+   {
+      m_statusp->m_lag = (ts.tv_sec - st.st_mtim.tv_sec) * int64_t(1000000) +
+                         (ts.tv_nsec - st.st_mtim.tv_nsec) / 1000;
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Handling of the temporary log file is finished
+//----------------------------------------------------------------------------------------
+void IngestStatus::endEvent()
+{
+   if (m_statusp)
+   {
+      m_statusp->m_busysince = 0;
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Check if the log server is behind
+//----------------------------------------------------------------------------------------
+bool IngestStatus::isBacklogged()
+{
+   const int fd = ::open(s_path, O_RDONLY);
+   if (fd == -1)
+   {
+      // No log server status
+      return false;
+   }
+   t_status status;
+   const ssize_t size = pread(fd, &status, sizeof(status), 0);
+   ::close(fd);
+   if ((size != sizeof(status)) || (status.m_version != s_version))
+   {
+      return false;
+   }
+
+   const int64_t now = getMonotonic();
+   if ((status.m_busysince != 0) && (now - status.m_busysince > s_maxbusy))
+   {
+      // Stuck in a long event, the temporary files are queueing up
+      return true;
+   }
+
+   // An idle log server has no backlog, whatever the latest lag was
+   return (now - status.m_updated < s_stale) && (status.m_lag > s_maxlag);
+}
+
+//----------------------------------------------------------------------------------------
+// Get monotonic time in microseconds
+//----------------------------------------------------------------------------------------
+int64_t IngestStatus::getMonotonic()
+{
+   timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * int64_t(1000000) + ts.tv_nsec / 1000;
+}
+
+}
@@ -0,0 +1,397 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      jobpool.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Pool of worker threads running independent command jobs.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "jobpool.h"
+#include "transfercheckpoint.h"
+#include "transferscheduler.h"
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+
+using namespace std;
+
+namespace PES_CLH {
+
+const size_t JobPool::s_defaultthreads = 4;
+const size_t JobPool::s_maxthreads = 32;
+const size_t JobPool::s_maxbuffer = 1024 * 1024;
+
+namespace {
+
+const size_t s_putsize = 4096;         // Size of the put area of a printout
+
+}
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+JobPool::JobPool(size_t maxthreads):
+m_maxthreads(maxthreads),
+m_session(),
+m_entrylist(),
+m_next(0),
+m_first(0),
+m_maxahead(0),
+m_mutex(),
+m_cond()
+{
+   if (m_maxthreads == 0)
+   {
+      m_maxthreads = boost::thread::hardware_concurrency();
+      if (m_maxthreads > s_defaultthreads)
+      {
+         m_maxthreads = s_defaultthreads;
+      }
+      if (m_maxthreads == 0)
+      {
+         m_maxthreads = 1;
+      }
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+JobPool::~JobPool()
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Add a job
+//----------------------------------------------------------------------------------------
+void JobPool::add(const t_job& job)
+{
+   m_entrylist.push_back(ENTRYPTR(new t_entry(job)));
+}
+
+//----------------------------------------------------------------------------------------
+// Run all jobs, the first error in job order is thrown
+//----------------------------------------------------------------------------------------
+void JobPool::run(ostream& os)
+{
+   if ((m_maxthreads == 1) || (m_entrylist.size() <= 1))
+   {
+      // Run in the calling thread, the printout is not buffered
+      for (ENTRYLIST::iterator iter = m_entrylist.begin(); iter != m_entrylist.end(); ++iter)
+      {
+         (*iter)->m_job(os);
+      }
+      m_entrylist.clear();
+      return;
+   }
+
+   size_t nothreads = m_maxthreads;
+   if (nothreads > m_entrylist.size())
+   {
+      nothreads = m_entrylist.size();
+   }
+
+   // Each worker may have a job running and one finished job waiting to be printed
+   m_next = 0;
+   m_first = 0;
+   m_maxahead = nothreads * 2;
+   m_session.m_writerp = Common::getArchive();
+   m_session.m_checkpointp = TransferCheckpoint::getCurrent();
+   m_session.m_schedulerp = TransferScheduler::getCurrent();
+   boost::thread_group threadgroup;
+   for (size_t i = 0; i < nothreads; i++)
+   {
+      threadgroup.create_thread(boost::bind(&JobPool::worker, this));
+   }
+
+   try
+   {
+      // Print and archive in job order. The first unfinished job prints directly.
+      for (ENTRYLIST::iterator iter = m_entrylist.begin(); iter != m_entrylist.end(); ++iter)
+      {
+         t_entry& entry = **iter;
+         entry.m_output.attach(os);
+         {
+            boost::mutex::scoped_lock lock(m_mutex);
+            while (entry.m_done == false)
+            {
+               m_cond.wait(lock);
+            }
+         }
+         os.flush();
+
+         for (Common::ARCHIVELIST::const_iterator aiter = entry.m_archivelist.begin();
+              aiter != entry.m_archivelist.end();
+              ++aiter)
+         {
+            (*aiter)();
+         }
+
+         if (entry.m_errorp)
+         {
+            throw *entry.m_errorp;
+         }
+
+         // Let the workers start the next job
+         {
+            boost::mutex::scoped_lock lock(m_mutex);
+            m_first++;
+         }
+         m_cond.notify_all();
+      }
+   }
+   catch (...)
+   {
+      // Jobs not yet started are skipped, the printouts of the running jobs are
+      // discarded
+      {
+         boost::mutex::scoped_lock lock(m_mutex);
+         m_next = m_entrylist.size();
+      }
+      m_cond.notify_all();
+      for (ENTRYLIST::iterator iter = m_entrylist.begin(); iter != m_entrylist.end(); ++iter)
+      {
+         (*iter)->m_output.discard();
+      }
+      threadgroup.join_all();
+      m_entrylist.clear();
+      throw;
+   }
+
+   threadgroup.join_all();
+   m_entrylist.clear();
+}
+
+//----------------------------------------------------------------------------------------
+// Parse the max number of worker threads from a command option argument
+//----------------------------------------------------------------------------------------
+size_t JobPool::getMaxThreads(const string& arg)
+{
+   size_t maxthreads;
+   try
+   {
+      maxthreads = boost::lexical_cast<size_t>(arg);
+   }
+   catch (boost::bad_lexical_cast&)
+   {
+      throw Exception(Exception::illNoOfThreads(arg), WHERE__);
+   }
+   if ((maxthreads == 0) || (maxthreads > s_maxthreads))
+   {
+      throw Exception(Exception::illNoOfThreads(arg), WHERE__);
+   }
+   return maxthreads;
+}
+
+//----------------------------------------------------------------------------------------
+// Worker thread, run jobs until there are no more jobs. A job is not started until
+// it is close enough to the first unfinished job.
+//----------------------------------------------------------------------------------------
+void JobPool::worker()
+{
+   while (true)
+   {
+      t_entry* entryp;
+      {
+         boost::mutex::scoped_lock lock(m_mutex);
+         while ((m_next < m_entrylist.size()) && (m_next >= m_first + m_maxahead))
+         {
+            m_cond.wait(lock);
+         }
+         if (m_next >= m_entrylist.size())
+         {
+            return;
+         }
+         entryp = m_entrylist[m_next++].get();
+      }
+
+      execute(*entryp, m_session);
+
+      {
+         boost::mutex::scoped_lock lock(m_mutex);
+         entryp->m_done = true;
+      }
+      m_cond.notify_all();
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Run a job in the calling thread
+//----------------------------------------------------------------------------------------
+void JobPool::execute(t_entry& entry, const t_session& session)
+{
+   Common::setArchive(session.m_writerp);
+   TransferCheckpoint::setCurrent(session.m_checkpointp);
+   TransferScheduler::setCurrent(session.m_schedulerp);
+   Common::setArchiveList(&entry.m_archivelist);
+   ostream os(&entry.m_output);
+   try
+   {
+      entry.m_job(os);
+   }
+   catch (Exception& ex)
+   {
+      entry.m_errorp.reset(new Exception(ex));
+   }
+   catch (std::exception& e)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << e.what() << ".";
+      entry.m_errorp.reset(new Exception(ex));
+   }
+   catch (...)
+   {
+      Exception ex(Exception::internal(), WHERE__);
+      ex << "Unknown exception in job.";
+      entry.m_errorp.reset(new Exception(ex));
+   }
+   os.flush();
+   Common::setArchiveList(0);
+   Common::setArchive(0);
+   TransferCheckpoint::setCurrent(0);
+   TransferScheduler::setCurrent(0);
+}
+
+//========================================================================================
+// Class JobPool::Output
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+JobPool::Output::Output():
+streambuf(),
+m_putarea(s_putsize),
+m_buffer(),
+m_osp(0),
+m_discard(false),
+m_mutex(),
+m_cond()
+{
+   setp(&m_putarea[0], &m_putarea[0] + m_putarea.size());
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+JobPool::Output::~Output()
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Write the buffered printout to the stream, and the rest of the printout directly
+//----------------------------------------------------------------------------------------
+void JobPool::Output::attach(ostream& os)
+{
+   {
+      boost::mutex::scoped_lock lock(m_mutex);
+      if (m_buffer.empty() == false)
+      {
+         os.write(&m_buffer[0], m_buffer.size());
+         vector<char>().swap(m_buffer);
+      }
+      m_osp = &os;
+   }
+   m_cond.notify_all();
+}
+
+//----------------------------------------------------------------------------------------
+// Discard the rest of the printout
+//----------------------------------------------------------------------------------------
+void JobPool::Output::discard()
+{
+   {
+      boost::mutex::scoped_lock lock(m_mutex);
+      m_discard = true;
+      vector<char>().swap(m_buffer);
+   }
+   m_cond.notify_all();
+}
+
+//----------------------------------------------------------------------------------------
+// Put area is full, write it
+//----------------------------------------------------------------------------------------
+JobPool::Output::int_type JobPool::Output::overflow(int_type ch)
+{
+   flush();
+   if (traits_type::eq_int_type(ch, traits_type::eof()) == false)
+   {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+   }
+   return traits_type::not_eof(ch);
+}
+
+//----------------------------------------------------------------------------------------
+// Write the put area, and flush the stream if written directly
+//----------------------------------------------------------------------------------------
+int JobPool::Output::sync()
+{
+   flush();
+   boost::mutex::scoped_lock lock(m_mutex);
+   if (m_osp && (m_discard == false))
+   {
+      m_osp->flush();
+   }
+   return 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Write the put area to the stream or to the buffer, blocks while the buffer is full
+//----------------------------------------------------------------------------------------
+void JobPool::Output::flush()
+{
+   const size_t size = pptr() - pbase();
+   if (size > 0)
+   {
+      boost::mutex::scoped_lock lock(m_mutex);
+      while ((m_osp == 0) && (m_discard == false) && (m_buffer.size() + size > s_maxbuffer))
+      {
+         m_cond.wait(lock);
+      }
+      if (m_discard)
+      {
+         // Nothing more is printed
+      }
+      else if (m_osp)
+      {
+         m_osp->write(pbase(), size);
+      }
+      else
+      {
+         m_buffer.insert(m_buffer.end(), pbase(), pptr());
+      }
+   }
+   setp(&m_putarea[0], &m_putarea[0] + m_putarea.size());
+}
+
+}
@@ -0,0 +1,867 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      logcursor.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Cursor over the events of an append type log.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "logcursor.h"
+#include "blockfile.h"
+#include "logger.h"
+#include "transferscheduler.h"
+#include <boost/lexical_cast.hpp>
+#include <algorithm>
+#include <sstream>
+#include <string.h>
+
+using namespace std;
+using namespace boost;
+
+namespace PES_CLH {
+
+//----------------------------------------------------------------------------------------
+// Constructor, the cursor is not positioned
+//----------------------------------------------------------------------------------------
+LogCursor::LogCursor(const AppendTask& task):
+m_task(task),
+m_filelist(),
+m_summary(),
+m_bounds(),
+m_buffer(),
+m_file(npos),
+m_base(0),
+m_limit(0),
+m_records(),
+m_record(npos),
+m_header()
+{
+   // Create a list with the log subfiles
+   const fs::path& logdir = m_task.getLogDir();
+   if (fs::exists(logdir))
+   {
+      fs::directory_iterator end;
+      for (fs::directory_iterator iter(logdir); iter != end; ++iter)
+      {
+         const fs::path& path = *iter;
+         if (regex_match(path.filename().c_str(), m_task.getParameters().getLogFile()))
+         {
+            m_filelist.push_back(path);
+         }
+      }
+      sort(m_filelist.begin(), m_filelist.end());
+
+      m_task.readSummary(m_summary);       // Times for sealed subfiles
+      m_bounds.resize(m_filelist.size());
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+LogCursor::~LogCursor()
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Position at the first event in the log
+//----------------------------------------------------------------------------------------
+bool LogCursor::seekFirst()
+{
+   for (size_t file = 0; file < m_filelist.size(); file++)
+   {
+      if (loadFile(file))
+      {
+         setRecord(0);
+         return true;
+      }
+   }
+   m_record = npos;
+   return false;
+}
+
+//----------------------------------------------------------------------------------------
+// Position at the last event in the log
+//----------------------------------------------------------------------------------------
+bool LogCursor::seekLast()
+{
+   for (size_t file = m_filelist.size(); file > 0; file--)
+   {
+      if (loadFile(file - 1))
+      {
+         setRecord(m_records.size() - 1);
+         return true;
+      }
+   }
+   m_record = npos;
+   return false;
+}
+
+//----------------------------------------------------------------------------------------
+// Position at the first event at or after a time
+//----------------------------------------------------------------------------------------
+bool LogCursor::seek(const Time& time)
+{
+   for (size_t file = findFile(time); file < m_filelist.size(); file++)
+   {
+      // Skip subfiles ending before the time without loading them
+      int64_t sfirst;
+      int64_t slast;
+      if (getBounds(file, sfirst, slast) && (slast < int64_t(time)))
+      {
+         continue;
+      }
+
+      size_t from;
+      size_t to;
+      findRange(file, time, true, from, to);
+      if (loadFile(file, from, to))
+      {
+         size_t record = findRecord(time);
+         if (record < m_records.size())
+         {
+            setRecord(record);
+            return true;
+         }
+      }
+   }
+   m_record = npos;
+   return false;
+}
+
+//----------------------------------------------------------------------------------------
+// Position at the last event at or before a time
+//----------------------------------------------------------------------------------------
+bool LogCursor::seekBefore(const Time& time)
+{
+   for (size_t file = findFileBefore(time); file > 0; file--)
+   {
+      // Skip subfiles starting after the time without loading them
+      int64_t sfirst;
+      int64_t slast;
+      if (getBounds(file - 1, sfirst, slast) && (sfirst > int64_t(time)))
+      {
+         continue;
+      }
+
+      size_t from;
+      size_t to;
+      findRange(file - 1, time, false, from, to);
+      if (loadFile(file - 1, from, to))
+      {
+         size_t record = findRecordAfter(time);
+         if (record > 0)
+         {
+            setRecord(record - 1);
+            return true;
+         }
+      }
+   }
+   m_record = npos;
+   return false;
+}
+
+//----------------------------------------------------------------------------------------
+// Position at the first event after the event named by a resume token
+//----------------------------------------------------------------------------------------
+bool LogCursor::seekAfter(const string& token)
+{
+   // The token is "<subfile>:<offset>:<AP time>"
+   string name;
+   size_t offset;
+   int64_t aptime;
+   try
+   {
+      const size_t tpos = token.rfind(':');
+      const size_t opos = (tpos == string::npos || tpos == 0)? string::npos:
+                                                                token.rfind(':', tpos - 1);
+      if ((opos == string::npos) || (opos == 0))
+      {
+         throw bad_lexical_cast();
+      }
+      name = token.substr(0, opos);
+      offset = lexical_cast<size_t>(token.substr(opos + 1, tpos - opos - 1));
+      aptime = lexical_cast<int64_t>(token.substr(tpos + 1));
+   }
+   catch (bad_lexical_cast&)
+   {
+      Exception ex(Exception::parameter(), WHERE__);
+      ex << "Illegal resume token \"" << token << "\".";
+      throw ex;
+   }
+
+   const fs::path& path = m_task.getLogDir() / name;
+   FILELIST::const_iterator iter = lower_bound(m_filelist.begin(), m_filelist.end(), path);
+   if ((iter != m_filelist.end()) && (*iter == path))
+   {
+      // Only the records from the event onwards are loaded
+      const size_t file = iter - m_filelist.begin();
+      if (loadFile(file, offset))
+      {
+         RECORDLIST::const_iterator riter = lower_bound(m_records.begin(), m_records.end(), offset);
+         if ((riter != m_records.end()) && (*riter == offset))
+         {
+            const size_t record = riter - m_records.begin();
+            if (getHeader(record).m_aptime == aptime)
+            {
+               setRecord(record);
+               return next();
+            }
+         }
+      }
+   }
+
+   // The subfile is gone or changed, continue after the AP time
+   return seek(Time(aptime + 1));
+}
+
+//----------------------------------------------------------------------------------------
+// Find the AP time for the first event at or after a time
+//----------------------------------------------------------------------------------------
+bool LogCursor::findTime(const Time& time, Time& found)
+{
+   for (size_t file = findFile(time); file < m_filelist.size(); file++)
+   {
+      int64_t sfirst;
+      int64_t slast;
+      if (getBounds(file, sfirst, slast))
+      {
+         if (slast < int64_t(time))
+         {
+            continue;
+         }
+         if (sfirst >= int64_t(time))
+         {
+            found = Time(sfirst);
+            return true;
+         }
+      }
+
+      // The time is inside the subfile, or the subfile is damaged
+      size_t from;
+      size_t to;
+      findRange(file, time, true, from, to);
+      if (loadFile(file, from, to))
+      {
+         size_t record = findRecord(time);
+         if (record < m_records.size())
+         {
+            found = Time(getHeader(record).m_aptime);
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+//----------------------------------------------------------------------------------------
+// Find the AP time for the last event at or before a time
+//----------------------------------------------------------------------------------------
+bool LogCursor::findTimeBefore(const Time& time, Time& found)
+{
+   for (size_t file = findFileBefore(time); file > 0; file--)
+   {
+      int64_t sfirst;
+      int64_t slast;
+      if (getBounds(file - 1, sfirst, slast))
+      {
+         if (sfirst > int64_t(time))
+         {
+            continue;
+         }
+         if (slast <= int64_t(time))
+         {
+            found = Time(slast);
+            return true;
+         }
+      }
+
+      // The time is inside the subfile, or the subfile is damaged
+      size_t from;
+      size_t to;
+      findRange(file - 1, time, false, from, to);
+      if (loadFile(file - 1, from, to))
+      {
+         size_t record = findRecordAfter(time);
+         if (record > 0)
+         {
+            found = Time(getHeader(record - 1).m_aptime);
+            return true;
+         }
+      }
+   }
+   return false;
+}
+
+//----------------------------------------------------------------------------------------
+// Step to the next event
+//----------------------------------------------------------------------------------------
+bool LogCursor::next()
+{
+   if (isValid() == false)
+   {
+      return false;
+   }
+
+   if (m_record + 1 < m_records.size())
+   {
+      setRecord(m_record + 1);
+      return true;
+   }
+   if (m_limit > 0)
+   {
+      // Only the older records of the subfile are loaded, load the newer records
+      const size_t offset = m_records[m_record];
+      if (loadFile(m_file, offset))
+      {
+         const size_t record = upper_bound(m_records.begin(), m_records.end(), offset) -
+                               m_records.begin();
+         if (record < m_records.size())
+         {
+            setRecord(record);
+            return true;
+         }
+      }
+   }
+   for (size_t file = m_file + 1; file < m_filelist.size(); file++)
+   {
+      if (loadFile(file))
+      {
+         setRecord(0);
+         return true;
+      }
+   }
+   m_record = npos;
+   return false;
+}
+
+//----------------------------------------------------------------------------------------
+// Step to the previous event
+//----------------------------------------------------------------------------------------
+bool LogCursor::prev()
+{
+   if (isValid() == false)
+   {
+      return false;
+   }
+
+   if (m_record > 0)
+   {
+      setRecord(m_record - 1);
+      return true;
+   }
+   if (m_base > 0)
+   {
+      // Only the newer records of the subfile are loaded, load the older records
+      const size_t offset = m_records[m_record];
+      if (loadFile(m_file, 0, offset))
+      {
+         const size_t record = lower_bound(m_records.begin(), m_records.end(), offset) -
+                               m_records.begin();
+         if (record > 0)
+         {
+            setRecord(record - 1);
+            return true;
+         }
+      }
+   }
+   for (size_t file = m_file; file > 0; file--)
+   {
+      if (loadFile(file - 1))
+      {
+         setRecord(m_records.size() - 1);
+         return true;
+      }
+   }
+   m_record = npos;
+   return false;
+}
+
+//----------------------------------------------------------------------------------------
+// Check if the cursor is positioned at an event
+//----------------------------------------------------------------------------------------
+bool LogCursor::isValid() const
+{
+   return m_record != npos;
+}
+
+//----------------------------------------------------------------------------------------
+// Get CP time for the event
+//----------------------------------------------------------------------------------------
+Time LogCursor::getCPTime() const
+{
+   return Time(m_header.m_cptime);
+}
+
+//----------------------------------------------------------------------------------------
+// Get AP time for the event
+//----------------------------------------------------------------------------------------
+Time LogCursor::getAPTime() const
+{
+   return Time(m_header.m_aptime);
+}
+
+//----------------------------------------------------------------------------------------
+// Get CP time stamp for the event
+//----------------------------------------------------------------------------------------
+TimeStamp LogCursor::getCPStamp() const
+{
+   return TimeStamp(m_header.m_cptime);
+}
+
+//----------------------------------------------------------------------------------------
+// Get AP time stamp for the event
+//----------------------------------------------------------------------------------------
+TimeStamp LogCursor::getAPStamp() const
+{
+   return TimeStamp(m_header.m_aptime);
+}
+
+//----------------------------------------------------------------------------------------
+// Get size of the event data
+//----------------------------------------------------------------------------------------
+size_t LogCursor::getSize() const
+{
+   return m_header.m_size;
+}
+
+//----------------------------------------------------------------------------------------
+// Get the event data, valid until the cursor is moved
+//----------------------------------------------------------------------------------------
+const char* LogCursor::getData() const
+{
+   return m_buffer.get() + m_records[m_record] - m_base + sizeof(AppendTask::t_header);
+}
+
+//----------------------------------------------------------------------------------------
+// Get path to the subfile holding the event
+//----------------------------------------------------------------------------------------
+const fs::path& LogCursor::getPath() const
+{
+   return m_filelist[m_file];
+}
+
+//----------------------------------------------------------------------------------------
+// Get position of the event
+//----------------------------------------------------------------------------------------
+LogCursor::t_position LogCursor::getPosition() const
+{
+   const t_position position = {m_file, m_records[m_record], m_header.m_aptime};
+   return position;
+}
+
+//----------------------------------------------------------------------------------------
+// Get resume token for an event
+//----------------------------------------------------------------------------------------
+string LogCursor::getToken(const t_position& position) const
+{
+   ostringstream s;
+   s << m_filelist[position.m_file].filename().string() << ':'
+     << position.m_offset << ':' << position.m_aptime;
+   return s.str();
+}
+
+//----------------------------------------------------------------------------------------
+// Find the part of a sealed subfile that holds the event at a time. The event is
+// between the last index entry before it and the index entry after it.
+//----------------------------------------------------------------------------------------
+void LogCursor::findRange(size_t file, int64_t time, bool after, size_t& from, size_t& to)
+{
+   from = 0;
+   to = 0;
+
+   // Only sealed subfiles have a valid index
+   int64_t sfirst;
+   int64_t slast;
+   if ((getBounds(file, sfirst, slast) == false) || (m_bounds[file].m_size == 0))
+   {
+      return;
+   }
+   AppendTask::INDEX index;
+   if (m_task.readIndex(m_filelist[file], m_bounds[file].m_size, index) == false)
+   {
+      return;
+   }
+
+   // Number of index entries before the event
+   size_t low = 0;
+   size_t high = index.size();
+   while (low < high)
+   {
+      size_t mid = low + (high - low) / 2;
+      if (after? (index[mid].m_aptime < time): (index[mid].m_aptime <= time))
+      {
+         low = mid + 1;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+
+   if (low > 0)
+   {
+      from = index[low - 1].m_offset;
+   }
+
+   // The first event at or after the time may be the entry after the last one before
+   const size_t next = after? low + 1: low;
+   if (next < index.size())
+   {
+      to = index[next].m_offset;
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Load a subfile and build its list of records.
+// The records are found by following the chain backwards from the last record. The
+// chain is broken at the first corrupt record, the older records are skipped.
+// If only the newer records are loaded, the subfile is read from the oldest of them.
+// If only the older records are loaded, the subfile is read up to the first record not
+// loaded and the chain is followed from the record before it.
+//----------------------------------------------------------------------------------------
+bool LogCursor::loadFile(size_t file, size_t from, size_t to)
+{
+   m_record = npos;
+   if ((file == m_file) && (from >= m_base) &&
+       ((m_limit == 0) || ((to > 0) && (to <= m_limit))))
+   {
+      // Already loaded
+      return m_records.empty() == false;
+   }
+
+   m_file = file;
+   m_base = 0;
+   m_limit = 0;
+   m_records.clear();
+
+   const fs::path& path = m_filelist[file];
+   BlockIfstream fs(path);
+   if (fs.is_open() == false)
+   {
+      // Oops, file was deleted maybe due to maintenance purpose
+      return false;
+   }
+
+   uintmax_t size = m_task.getRealSize(fs, fs.size());
+   if (size < sizeof(AppendTask::t_header))
+   {
+      // No records
+      return false;
+   }
+
+   fs.clear();
+   size_t first;
+   size_t last;
+   const uint32_t version = AppendTask::readFileHeader(fs, first, last);
+   if ((to > first) && (to <= last))
+   {
+      // Only the older records are loaded, the chain is followed from the record
+      // before the first record not loaded
+      AppendTask::t_header header;
+      fs.clear();
+      fs.seekg(to, ios_base::beg);
+      fs.read(reinterpret_cast<char*>(&header), sizeof(AppendTask::t_header));
+      if ((fs.fail() == false) && (header.m_prev >= first) && (header.m_prev < to))
+      {
+         m_limit = to;
+         size = to;
+         last = header.m_prev;
+      }
+   }
+   if (from > first)
+   {
+      // Only the newer records are loaded
+      m_base = from;
+      if (m_base >= size)
+      {
+         return false;
+      }
+   }
+
+   if (size - m_base > BufferPool::Buffer::size())
+   {
+      ostringstream s;
+      s << m_task << endl;
+      s << "Log file " << path << " exceeds max size, the end of the file is skipped.";
+      Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
+      size = m_base + BufferPool::Buffer::size();
+   }
+
+   fs.clear();
+   fs.seekg(m_base, ios_base::beg);
+   char* const buf = m_buffer.get();
+   fs.read(buf, size - m_base);
+   size = m_base + fs.gcount();
+   TransferScheduler::throttle(fs.gcount());
+
+   // Follow the chain from the last record
+   size_t offset = last;
+   size_t limit = size;
+   for (;;)
+   {
+      if (offset < m_base)
+      {
+         // The older records are not loaded
+         break;
+      }
+
+      AppendTask::t_header header;
+      bool good = (offset >= first) && (offset < limit) &&
+                  (size - offset >= sizeof(AppendTask::t_header));
+      if (good)
+      {
+         memcpy(&header, buf + offset - m_base, sizeof(AppendTask::t_header));
+         good = (header.m_size <= size - offset - sizeof(AppendTask::t_header)) &&
+                AppendTask::checkRecord(version, header,
+                      buf + offset - m_base + sizeof(AppendTask::t_header));
+      }
+      if (good == false)
+      {
+         // Corrupt record - the rest of the subfile can not be trusted
+         ostringstream s;
+         s << m_task << endl;
+         s << "Corrupt record at offset " << offset << " in log file " << path
+           << ", the older records in the file are skipped.";
+         Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
+         break;
+      }
+
+      m_records.push_back(offset);
+      if (offset == first)
+      {
+         break;
+      }
+      limit = offset;
+      offset = header.m_prev;
+   }
+   reverse(m_records.begin(), m_records.end());
+
+   return m_records.empty() == false;
+}
+
+//----------------------------------------------------------------------------------------
+// Get times for the first and last event in a subfile
+//----------------------------------------------------------------------------------------
+bool LogCursor::getBounds(size_t file, int64_t& first, int64_t& last)
+{
+   t_bounds& bounds = m_bounds[file];
+   if (bounds.m_state == t_bounds::e_unknown)
+   {
+      bounds.m_state = t_bounds::e_invalid;
+
+      // Sealed subfiles are found in the summary
+      const fs::path& path = m_filelist[file];
+      Time sfirst;
+      Time slast;
+      if (m_task.findSummary(m_summary, path, sfirst, slast))
+      {
+         bounds.m_first = sfirst;
+         bounds.m_last = slast;
+         bounds.m_size = m_summary[path.filename().string()].m_size;
+         bounds.m_state = t_bounds::e_valid;
+      }
+      else
+      {
+         BlockIfstream fs(path);
+         if (fs.is_open())
+         {
+            const uintmax_t size = m_task.getRealSize(fs, fs.size());
+            fs.clear();
+            size_t firstoffset;
+            size_t lastoffset;
+            const uint32_t version = AppendTask::readFileHeader(fs, firstoffset, lastoffset);
+            AppendTask::t_header fheader;
+            AppendTask::t_header lheader;
+            if (readRecordHeader(fs, version, firstoffset, size, fheader) &&
+                readRecordHeader(fs, version, lastoffset, size, lheader) &&
+                (fheader.m_aptime <= lheader.m_aptime))
+            {
+               bounds.m_first = fheader.m_aptime;
+               bounds.m_last = lheader.m_aptime;
+               bounds.m_state = t_bounds::e_valid;
+            }
+         }
+      }
+   }
+
+   first = bounds.m_first;
+   last = bounds.m_last;
+   return bounds.m_state == t_bounds::e_valid;
+}
+
+//----------------------------------------------------------------------------------------
+// Read the header of a record without loading the subfile
+//----------------------------------------------------------------------------------------
+bool LogCursor::readRecordHeader(
+      istream& fs,
+      uint32_t version,
+      size_t offset,
+      uintmax_t size,
+      AppendTask::t_header& header
+      )
+{
+   if ((offset >= size) || (size - offset < sizeof(AppendTask::t_header)))
+   {
+      return false;
+   }
+
+   fs.clear();
+   fs.seekg(offset, ios_base::beg);
+   fs.read(reinterpret_cast<char*>(&header), sizeof(AppendTask::t_header));
+   if (fs.fail() || (header.m_size > size - offset - sizeof(AppendTask::t_header)))
+   {
+      return false;
+   }
+
+   vector<char> data(header.m_size + 1);
+   fs.read(&data[0], header.m_size);
+   return (fs.fail() == false) && AppendTask::checkRecord(version, header, &data[0]);
+}
+
+//----------------------------------------------------------------------------------------
+// Find the first subfile that may hold an event at or after a time.
+// A subfile that is empty or damaged is treated as ending after the time, so the search
+// may end too early but never too late.
+//----------------------------------------------------------------------------------------
+size_t LogCursor::findFile(int64_t time)
+{
+   size_t low = 0;
+   size_t high = m_filelist.size();
+   while (low < high)
+   {
+      size_t mid = low + (high - low) / 2;
+      int64_t sfirst;
+      int64_t slast;
+      if (getBounds(mid, sfirst, slast) && (slast < time))
+      {
+         low = mid + 1;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+   return low;
+}
+
+//----------------------------------------------------------------------------------------
+// Find the subfile after the last subfile that may hold an event at or before a time.
+// A subfile that is empty or damaged is treated as starting before the time, so the
+// search may end too late but never too early.
+//----------------------------------------------------------------------------------------
+size_t LogCursor::findFileBefore(int64_t time)
+{
+   size_t low = 0;
+   size_t high = m_filelist.size();
+   while (low < high)
+   {
+      size_t mid = low + (high - low) / 2;
+      int64_t sfirst;
+      int64_t slast;
+      if (getBounds(mid, sfirst, slast) && (sfirst > time))
+      {
+         high = mid;
+      }
+      else
+      {
+         low = mid + 1;
+      }
+   }
+   return low;
+}
+
+//----------------------------------------------------------------------------------------
+// Position at a record in the loaded subfile
+//----------------------------------------------------------------------------------------
+void LogCursor::setRecord(size_t record)
+{
+   m_record = record;
+   m_header = getHeader(record);
+}
+
+//----------------------------------------------------------------------------------------
+// Get the header of a record in the loaded subfile
+//----------------------------------------------------------------------------------------
+AppendTask::t_header LogCursor::getHeader(size_t record) const
+{
+   AppendTask::t_header header;
+   memcpy(&header, m_buffer.get() + m_records[record] - m_base, sizeof(AppendTask::t_header));
+   return header;
+}
+
+//----------------------------------------------------------------------------------------
+// Find the first record in the loaded subfile at or after a time
+//----------------------------------------------------------------------------------------
+size_t LogCursor::findRecord(int64_t time) const
+{
+   size_t low = 0;
+   size_t high = m_records.size();
+   while (low < high)
+   {
+      size_t mid = low + (high - low) / 2;
+      if (getHeader(mid).m_aptime < time)
+      {
+         low = mid + 1;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+   return low;
+}
+
+//----------------------------------------------------------------------------------------
+// Find the first record in the loaded subfile after a time
+//----------------------------------------------------------------------------------------
+size_t LogCursor::findRecordAfter(int64_t time) const
+{
+   size_t low = 0;
+   size_t high = m_records.size();
+   while (low < high)
+   {
+      size_t mid = low + (high - low) / 2;
+      if (getHeader(mid).m_aptime <= time)
+      {
+         low = mid + 1;
+      }
+      else
+      {
+         high = mid;
+      }
+   }
+   return low;
+}
+
+}
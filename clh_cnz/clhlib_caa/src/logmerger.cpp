@@ -0,0 +1,225 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      logmerger.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Merged time ordered view over the events of several append type logs.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "logmerger.h"
+#include <algorithm>
+#include <assert.h>
+
+using namespace std;
+
+namespace PES_CLH {
+
+//----------------------------------------------------------------------------------------
+// Print a merged log event to the stream
+//----------------------------------------------------------------------------------------
+void printMergedEvent(
+         const string& tag,
+         const Time& cptime,
+         const Time& aptime,
+         size_t size,
+         const char* buf,
+         ostream& os
+         )
+{
+   os << tag << "  ";
+   printLogEvent(cptime, aptime, size, buf, os);
+}
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+LogMerger::LogMerger(t_key key):
+m_key(key),
+m_sourcelist(),
+m_heap(),
+m_last()
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+LogMerger::~LogMerger()
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Add a log
+//----------------------------------------------------------------------------------------
+void LogMerger::add(const AppendTask& task, const string& tag)
+{
+   t_source source;
+   source.m_tag = tag;
+   source.m_cursorp.reset(new LogCursor(task));
+   m_sourcelist.push_back(source);
+   m_heap.clear();
+}
+
+//----------------------------------------------------------------------------------------
+// Position at the oldest event in the period
+//----------------------------------------------------------------------------------------
+bool LogMerger::seek(const Period& period)
+{
+   m_last = TimeStamp(period.last());
+   m_heap.clear();
+   for (size_t i = 0; i < m_sourcelist.size(); i++)
+   {
+      t_source& source = m_sourcelist[i];
+      if (source.m_cursorp->seek(period.first()) && update(source))
+      {
+         m_heap.push_back(i);
+      }
+   }
+   make_heap(m_heap.begin(), m_heap.end(), Later(m_sourcelist));
+   return m_heap.empty() == false;
+}
+
+//----------------------------------------------------------------------------------------
+// Step to the next event in the period
+//----------------------------------------------------------------------------------------
+bool LogMerger::next()
+{
+   if (m_heap.empty())
+   {
+      return false;
+   }
+
+   pop_heap(m_heap.begin(), m_heap.end(), Later(m_sourcelist));
+   t_source& source = m_sourcelist[m_heap.back()];
+   if (source.m_cursorp->next() && update(source))
+   {
+      push_heap(m_heap.begin(), m_heap.end(), Later(m_sourcelist));
+   }
+   else
+   {
+      // No more events in this log
+      m_heap.pop_back();
+   }
+   return m_heap.empty() == false;
+}
+
+//----------------------------------------------------------------------------------------
+// Get index of the log holding the event
+//----------------------------------------------------------------------------------------
+size_t LogMerger::getSource() const
+{
+   assert(m_heap.empty() == false);
+   return m_heap.front();
+}
+
+//----------------------------------------------------------------------------------------
+// Get tag for the log holding the event
+//----------------------------------------------------------------------------------------
+const string& LogMerger::getTag() const
+{
+   return m_sourcelist[getSource()].m_tag;
+}
+
+//----------------------------------------------------------------------------------------
+// Get CP time for the event
+//----------------------------------------------------------------------------------------
+Time LogMerger::getCPTime() const
+{
+   return current().getCPTime();
+}
+
+//----------------------------------------------------------------------------------------
+// Get CP time for the event in long format
+//----------------------------------------------------------------------------------------
+string LogMerger::getCPTimeText() const
+{
+   const Time& cptime = current().getCPTime();
+   return cptime.empty()? string(): cptime.get(Time::e_long);
+}
+
+//----------------------------------------------------------------------------------------
+// Get AP time for the event
+//----------------------------------------------------------------------------------------
+Time LogMerger::getAPTime() const
+{
+   return current().getAPTime();
+}
+
+//----------------------------------------------------------------------------------------
+// Get size of the event data
+//----------------------------------------------------------------------------------------
+size_t LogMerger::getSize() const
+{
+   return current().getSize();
+}
+
+//----------------------------------------------------------------------------------------
+// Get the event data
+//----------------------------------------------------------------------------------------
+const char* LogMerger::getData() const
+{
+   return current().getData();
+}
+
+//----------------------------------------------------------------------------------------
+// Check that the cursor of a source is in the period and set its merge key
+//----------------------------------------------------------------------------------------
+bool LogMerger::update(t_source& source)
+{
+   const TimeStamp aptime = source.m_cursorp->getAPStamp();
+   if (aptime > m_last)
+   {
+      return false;
+   }
+   source.m_time = aptime;
+   if (m_key == e_cptime)
+   {
+      // Logs without CP time are merged on AP time
+      const TimeStamp cptime = source.m_cursorp->getCPStamp();
+      if (cptime.empty() == false)
+      {
+         source.m_time = cptime;
+      }
+   }
+   return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Get cursor at the current event
+//----------------------------------------------------------------------------------------
+const LogCursor& LogMerger::current() const
+{
+   return *m_sourcelist[getSource()].m_cursorp;
+}
+
+}
@@ -40,6 +40,7 @@
 #include "ltime.h"
 #include "exception.h"
 #include <boost/lexical_cast.hpp>
+#include <boost/thread/tss.hpp>
 #include <string>
 #include <iostream>
 #include <iomanip>
@@ -59,11 +60,99 @@ const time_t Time::s_minute = 60;               // Minute
 const time_t Time::s_hour = 3600;               // Hour
 const time_t Time::s_day = 86400;               // Day
 
-const int64_t Time::s_empty = int64_t(1) << 62;
+const int64_t Time::s_empty = TimeStamp::s_empty;
                                                 // Empty time
 
-Time::t_zone Time::s_zone(e_local);
-Time::t_format Time::s_format(e_plain);
+const int64_t TimeStamp::s_empty;               // Empty time stamp
+
+namespace {
+
+// Formatting cache, one per thread.
+// The broken-down time is cached for the last formatted second. The UTC offset is
+// cached for one hour at a time, if it is the same at the start and at the end of the
+// hour and no local time in the hour is ambiguous. A change of offset (DST) within the
+// hour is then excluded, since offsets do not change twice within an hour.
+struct t_tmcache
+{
+   t_tmcache():
+   m_haswindow(false),
+   m_window(0),
+   m_gmtoff(0),
+   m_isdst(0),
+   m_zone(0)
+   {
+      m_hastm[0] = false;
+      m_hastm[1] = false;
+   }
+
+   bool m_hastm[2];                    // Broken-down time is cached, per time zone
+   time_t m_sec[2];                    // Second for the cached broken-down time
+   tm m_tm[2];                         // Cached broken-down time
+   bool m_haswindow;                   // UTC offset is cached
+   time_t m_window;                    // Start of the hour for the cached offset
+   long m_gmtoff;                      // UTC offset
+   int m_isdst;                        // DST flag
+   const char* m_zone;                 // Time zone abbreviation
+};
+
+// Get the formatting cache for the calling thread
+t_tmcache& getTmCache()
+{
+   static boost::thread_specific_ptr<t_tmcache> s_tmcache;
+   if (s_tmcache.get() == 0)
+   {
+      s_tmcache.reset(new t_tmcache);
+   }
+   return *s_tmcache;
+}
+
+// Division rounded towards minus infinity
+inline int64_t floorDiv(int64_t value, int64_t divisor)
+{
+   int64_t quot = value / divisor;
+   return (value % divisor < 0)? quot - 1: quot;
+}
+
+// Local time with the HY85159 correction, see Time::get()
+bool getCorrectedLocalTm(time_t sec, tm& tmtime, bool& changed)
+{
+   tmtime.tm_isdst = -1;
+   if (localtime_r(&sec, &tmtime) == 0)
+   {
+      return false;
+   }
+   tm local = tmtime;
+   tmtime.tm_isdst = -1;
+   mktime(&tmtime);
+   changed = (tmtime.tm_isdst != local.tm_isdst) ||
+             (tmtime.tm_gmtoff != local.tm_gmtoff) ||
+             (tmtime.tm_mday != local.tm_mday) ||
+             (tmtime.tm_hour != local.tm_hour) ||
+             (tmtime.tm_min != local.tm_min);
+   return true;
+}
+
+// Format set by the stream manipulators, for the next time written by the thread
+struct t_manip
+{
+   t_manip(): m_zone(Time::e_local), m_format(Time::e_plain) {}
+
+   Time::t_zone m_zone;                // Time zone
+   Time::t_format m_format;            // Format
+};
+
+// Get the manipulator state for the calling thread
+t_manip& getManip()
+{
+   static boost::thread_specific_ptr<t_manip> s_manip;
+   if (s_manip.get() == 0)
+   {
+      s_manip.reset(new t_manip);
+   }
+   return *s_manip;
+}
+
+}
 
 //========================================================================================
 // Class Time
@@ -563,8 +652,9 @@ void Time::get(std::string& date, std::string& time) const
 {
    validate();
 
-   tm* tmtime = localtime(&m_time.tv_sec);
-   if (tmtime == 0)
+   tm tmtime;
+   if ((getCachedLocalTm(m_time.tv_sec, tmtime) == false) &&
+       (localtime_r(&m_time.tv_sec, &tmtime) == 0))
    {
       Exception ex(Exception::internal(), WHERE__);
       ex << "Failed to convert file time to system time.";
@@ -572,11 +662,17 @@ void Time::get(std::string& date, std::string& time) const
       throw ex;
    }
 
-   char buf[32];
-   strftime(buf, 31, "%Y%m%d", tmtime);
-   date = buf;
-   strftime(buf, 31, "%H%M%S", tmtime);
-   time = buf;
+   char buf[16];
+   char* p = buf;
+   p = putNumber(p, tmtime.tm_year + 1900, 4);
+   p = putNumber(p, tmtime.tm_mon + 1, 2);
+   p = putNumber(p, tmtime.tm_mday, 2);
+   date.assign(buf, p);
+   p = buf;
+   p = putNumber(p, tmtime.tm_hour, 2);
+   p = putNumber(p, tmtime.tm_min, 2);
+   p = putNumber(p, tmtime.tm_sec, 2);
+   time.assign(buf, p);
 }
 
 //----------------------------------------------------------------------------------------
@@ -586,59 +682,219 @@ void Time::get(std::string& date, std::string& time) const
 // Pretty format: "YYYY-MM-DD HH:MM:SS.mmm  Zone"
 //----------------------------------------------------------------------------------------
 string Time::get(t_format format, t_zone zone) const
+{
+   char buf[s_maxformat];
+   const size_t size = Time::format(buf, format, zone);
+   return string(buf, size);
+}
+
+//----------------------------------------------------------------------------------------
+//   Format date and time into a buffer, the formats are the same as for get()
+//----------------------------------------------------------------------------------------
+size_t Time::format(char* buf, t_format format, t_zone zone) const
 {
    validate();
 
-   tm tmtime;
-   tmtime.tm_isdst = -1;
-   tm* ptr;
-   if (zone == e_local)
+   if (format == e_tvsec)
    {
-      ptr = localtime_r(&m_time.tv_sec, &tmtime);
-
-      //HY85159: It was found that sometimes wrong localtime are generated during DST change.
-      //Hence making use of mktime() by setting the tm_idst flag to -1 so that it will correct
-      //the tmtime if any wrong local time generated by localtime_r.
-      tmtime.tm_isdst = -1;
-      time_t mktime_tv_sec = mktime(&tmtime);
-   }
-   else
-   {
-      ptr = gmtime_r(&m_time.tv_sec, &tmtime);
-   }
-   if (!ptr)
-   {
-      Exception ex(Exception::internal(), WHERE__);
-      ex << "Failed to get time.";
-      ex.sysError();
-      throw ex;
+      return putNumber(buf, m_time.tv_sec, 1) - buf;
    }
 
-   char buf[32];
-   ostringstream s;
+   tm tmtime;
+   getTm(tmtime, zone);
+
+   char* p = buf;
    switch (format)
    {
    case e_plain:
-      s << "%Y%m%d_%H%M%S";
-      break;
-
    case e_long:
-      s << "%Y%m%d_%H%M%S_" << setw(6) << setfill('0') << m_time.tv_usec;
+      // "YYYYMMDD_HHMMSS" or "YYYYMMDD_HHMMSS_uuuuuu"
+      p = putNumber(p, tmtime.tm_year + 1900, 4);
+      p = putNumber(p, tmtime.tm_mon + 1, 2);
+      p = putNumber(p, tmtime.tm_mday, 2);
+      *p++ = '_';
+      p = putNumber(p, tmtime.tm_hour, 2);
+      p = putNumber(p, tmtime.tm_min, 2);
+      p = putNumber(p, tmtime.tm_sec, 2);
+      if (format == e_long)
+      {
+         *p++ = '_';
+         p = putNumber(p, m_time.tv_usec, 6);
+      }
       break;
 
    case e_pretty:
-      s << "%F  %T." << setw(3) << setfill('0') << m_time.tv_usec/1000 << "  %Z";
-      break;
-
-   case e_tvsec:
-      s << m_time.tv_sec;
+      // "YYYY-MM-DD  HH:MM:SS.mmm  Zone"
+      p = putNumber(p, tmtime.tm_year + 1900, 4);
+      *p++ = '-';
+      p = putNumber(p, tmtime.tm_mon + 1, 2);
+      *p++ = '-';
+      p = putNumber(p, tmtime.tm_mday, 2);
+      *p++ = ' ';
+      *p++ = ' ';
+      p = putNumber(p, tmtime.tm_hour, 2);
+      *p++ = ':';
+      p = putNumber(p, tmtime.tm_min, 2);
+      *p++ = ':';
+      p = putNumber(p, tmtime.tm_sec, 2);
+      *p++ = '.';
+      p = putNumber(p, m_time.tv_usec / 1000, 3);
+      *p++ = ' ';
+      *p++ = ' ';
+      p += strftime(p, s_maxformat - (p - buf), "%Z", &tmtime);
       break;
 
    default:
       assert(!"Illegal time format");
    }
 
-   strftime(buf, 31, s.str().c_str(), &tmtime);
+   *p = 0;
+   return p - buf;
+}
+
+//----------------------------------------------------------------------------------------
+//   Get broken-down time, the result of the last call is cached
+//----------------------------------------------------------------------------------------
+void Time::getTm(tm& tmtime, t_zone zone) const
+{
+   t_tmcache& cache = getTmCache();
+   const int idx = (zone == e_local)? 0: 1;
+   if (cache.m_hastm[idx] && (cache.m_sec[idx] == m_time.tv_sec))
+   {
+      tmtime = cache.m_tm[idx];
+      return;
+   }
+
+   if (zone == e_local)
+   {
+      if (getCachedLocalTm(m_time.tv_sec, tmtime) == false)
+      {
+         //HY85159: It was found that sometimes wrong localtime are generated during DST change.
+         //Hence making use of mktime() by setting the tm_idst flag to -1 so that it will correct
+         //the tmtime if any wrong local time generated by localtime_r.
+         bool changed;
+         if (getCorrectedLocalTm(m_time.tv_sec, tmtime, changed) == false)
+         {
+            Exception ex(Exception::internal(), WHERE__);
+            ex << "Failed to get time.";
+            ex.sysError();
+            throw ex;
+         }
+      }
+   }
+   else
+   {
+      convertTm(m_time.tv_sec, 0, 0, "GMT", tmtime);
+   }
+
+   cache.m_hastm[idx] = true;
+   cache.m_sec[idx] = m_time.tv_sec;
+   cache.m_tm[idx] = tmtime;
+}
+
+//----------------------------------------------------------------------------------------
+//   Get broken-down local time from the cached time zone offset. The offset for the
+//   hour is looked up when the hour changes.
+//----------------------------------------------------------------------------------------
+bool Time::getCachedLocalTm(time_t sec, tm& tmtime)
+{
+   t_tmcache& cache = getTmCache();
+   const time_t window = floorDiv(sec, s_hour) * s_hour;
+   if ((cache.m_haswindow == false) || (cache.m_window != window))
+   {
+      cache.m_haswindow = false;
+
+      tm first;
+      tm last;
+      bool fchanged;
+      bool lchanged;
+      if ((getCorrectedLocalTm(window, first, fchanged) == false) ||
+          (getCorrectedLocalTm(window + s_hour - 1, last, lchanged) == false) ||
+          fchanged ||
+          lchanged ||
+          (first.tm_gmtoff != last.tm_gmtoff) ||
+          (first.tm_isdst != last.tm_isdst))
+      {
+         // The offset changes within the hour, or a local time is ambiguous
+         return false;
+      }
+
+      cache.m_haswindow = true;
+      cache.m_window = window;
+      cache.m_gmtoff = first.tm_gmtoff;
+      cache.m_isdst = first.tm_isdst;
+      cache.m_zone = first.tm_zone;
+   }
+
+   convertTm(sec, cache.m_gmtoff, cache.m_isdst, cache.m_zone, tmtime);
+   return true;
+}
+
+//----------------------------------------------------------------------------------------
+//   Convert seconds since the epoch to broken-down time with a known UTC offset
+//----------------------------------------------------------------------------------------
+void Time::convertTm(time_t sec, long gmtoff, int isdst, const char* zone, tm& tmtime)
+{
+   const int64_t local = int64_t(sec) + gmtoff;
+   const int64_t days = floorDiv(local, s_day);
+   const int64_t secs = local - days * s_day;
+
+   // Civil date from days since 1970-01-01
+   const int64_t z = days + 719468;
+   const int64_t era = floorDiv(z, 146097);
+   const int64_t doe = z - era * 146097;
+   const int64_t yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+   const int64_t doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+   const int64_t mp = (5 * doy + 2) / 153;
+   const int mday = static_cast<int>(doy - (153 * mp + 2) / 5 + 1);
+   const int mon = static_cast<int>((mp < 10)? mp + 2: mp - 10);
+   const int64_t year = yoe + era * 400 + ((mon <= 1)? 1: 0);
+
+   // Day of year, doy is counted from March 1
+   const bool leap = ((year % 4 == 0) && (year % 100 != 0)) || (year % 400 == 0);
+   const int yday = static_cast<int>((mon >= 2)? doy + 59 + (leap? 1: 0): doy - 306);
+
+   tmtime.tm_sec = static_cast<int>(secs % 60);
+   tmtime.tm_min = static_cast<int>((secs / 60) % 60);
+   tmtime.tm_hour = static_cast<int>(secs / 3600);
+   tmtime.tm_mday = mday;
+   tmtime.tm_mon = mon;
+   tmtime.tm_year = static_cast<int>(year - 1900);
+   tmtime.tm_wday = static_cast<int>(days - floorDiv(days + 4, 7) * 7 + 4);
+   tmtime.tm_yday = yday;
+   tmtime.tm_isdst = isdst;
+   tmtime.tm_gmtoff = gmtoff;
+   tmtime.tm_zone = zone;
+}
+
+//----------------------------------------------------------------------------------------
+//   Write a decimal number with at least width digits, padded with zeroes
+//----------------------------------------------------------------------------------------
+char* Time::putNumber(char* buf, long value, int width)
+{
+   char digits[24];
+   int n = 0;
+   const bool negative = (value < 0);
+   unsigned long uvalue = negative? -static_cast<unsigned long>(value): value;
+   do
+   {
+      digits[n++] = '0' + uvalue % 10;
+      uvalue /= 10;
+   }
+   while (uvalue != 0);
+
+   if (negative)
+   {
+      *buf++ = '-';
+   }
+   for (int i = n; i < width; i++)
+   {
+      *buf++ = '0';
+   }
+   while (n > 0)
+   {
+      *buf++ = digits[--n];
+   }
    return buf;
 }
 
@@ -791,6 +1047,11 @@ int64_t Time::getZoneOffset() const
    time.tv_sec = m_time.tv_sec;
 
    tm tmtime;
+   if (getCachedLocalTm(time.tv_sec, tmtime))
+   {
+      return tmtime.tm_gmtoff;
+   }
+
    tmtime.tm_isdst = -1;
    tm* ptr = localtime_r(&time.tv_sec, &tmtime);
    if (!ptr)
@@ -847,16 +1108,17 @@ bool Time::isDstTime() const
 //----------------------------------------------------------------------------------------
 ostream& operator<<(ostream& s, const Time& time)
 {
+   t_manip& manip = getManip();
    if (time.empty() == false)
    {
-      s << time.get(Time::s_format, Time::s_zone);
+      s << time.get(manip.m_format, manip.m_zone);
    }
    else
    {
       s << "(empty)";
    }
-   Time::s_zone = Time::e_local;
-   Time::s_format = Time::e_plain;
+   manip.m_zone = Time::e_local;
+   manip.m_format = Time::e_plain;
    return s;
 }
 
@@ -865,7 +1127,7 @@ ostream& operator<<(ostream& s, const Time& time)
 //----------------------------------------------------------------------------------------
 ostream& operator<<(ostream& s, Time::t_zone zone)
 {
-   Time::s_zone = zone;
+   getManip().m_zone = zone;
    return s;
 }
 
@@ -874,7 +1136,7 @@ ostream& operator<<(ostream& s, Time::t_zone zone)
 //----------------------------------------------------------------------------------------
 ostream& operator<<(ostream& s, Time::t_format format)
 {
-   Time::s_format = format;
+   getManip().m_format = format;
    return s;
 }
 
@@ -37,11 +37,18 @@
 //#</heading>
 
 #include <iterator>
+#include <limits>
 #include <boost/lexical_cast.hpp>
+#include <ctype.h>
+#include <fcntl.h>
 #include <string.h>
 #include <stdint.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 
 #include "message.h"
+#include "exception.h"
 #include "logger.h"
 #include "ltime.h"
 #include "parameters.h"
@@ -315,5 +322,348 @@ istream& operator>>(istream& is, TESRVMessage& message)
    return is;
 }
 
+//========================================================================================
+//   Class MessageParser
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+MessageParser::MessageParser(t_headertype type) :
+m_type(type),
+m_tag((type == e_tesrvHeader)? TESRVMessage::s_headerTag: CLHMessage::s_headerTag),
+m_path(),
+m_addr(0),
+m_size(0),
+m_pos(0)
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+MessageParser::~MessageParser()
+{
+   close();
+}
+
+//----------------------------------------------------------------------------------------
+// Map a temporary file
+//----------------------------------------------------------------------------------------
+void MessageParser::open(const string& path)
+{
+   close();
+
+   int fd = ::open(path.c_str(), O_RDONLY);
+   if (fd == -1)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to open file '" << path << "'.";
+      ex.sysError();
+      throw ex;
+   }
+
+   struct stat st;
+   if (fstat(fd, &st) == -1)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to get status for file '" << path << "'.";
+      ex.sysError();
+      ::close(fd);
+      throw ex;
+   }
+
+   if (st.st_size > 0)
+   {
+      void* addr = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+      if (addr == MAP_FAILED)
+      {
+         Exception ex(Exception::system(), WHERE__);
+         ex << "Failed to map file '" << path << "'.";
+         ex.sysError();
+         ::close(fd);
+         throw ex;
+      }
+      madvise(addr, st.st_size, MADV_SEQUENTIAL);
+      m_addr = static_cast<char*>(addr);
+      m_size = st.st_size;
+   }
+
+   // The mapping is kept when the file is closed
+   ::close(fd);
+   m_path = path;
+}
+
+//----------------------------------------------------------------------------------------
+// Unmap the file
+//----------------------------------------------------------------------------------------
+void MessageParser::close()
+{
+   if (m_addr)
+   {
+      munmap(m_addr, m_size);
+      m_addr = 0;
+   }
+   m_path.clear();
+   m_size = 0;
+   m_pos = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Get next complete message.
+// Skipped bytes before a header are returned as a data missing message, the parsing
+// is resumed at the header. A corrupt header is skipped. An incomplete message at the
+// end of the file is left as the partial tail.
+//----------------------------------------------------------------------------------------
+bool MessageParser::next(t_message& message)
+{
+   const char* end = m_addr + m_size;
+   const char* pos = m_addr + m_pos;
+
+   for (const char* tag = findHeader(pos); tag != 0; tag = findHeader(pos))
+   {
+      size_t skipped = tag - pos;
+      if (skipped > 0)
+      {
+         ostringstream s;
+         s << "Skipped " << skipped
+           << " bytes in log message before header was found.";
+         Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
+
+         message.m_time = Time::now();
+         message.m_data = Message::s_datamissing;
+         message.m_size = strlen(Message::s_datamissing);
+         message.m_missing = true;
+         m_pos = tag - m_addr;
+         return true;
+      }
+
+      // Skip the tag and the white space following it
+      const char* fields = tag + m_tag.size() + 1;
+      int64_t time;
+      uintmax_t size;
+      const char* data;
+      int ret = (m_type == e_tesrvHeader)?
+            parseTESRVFields(fields, time, size, data):
+            parseCLHFields(fields, time, size, data);
+
+      if (ret < 0)
+      {
+         ostringstream s;
+         s << "CLH header corrupt.";
+         Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
+
+         // Resume the search after the tag
+         pos = fields;
+         continue;
+      }
+
+      if ((ret == 0) || (size > static_cast<uintmax_t>(end - data)))
+      {
+         // Incomplete message
+         return false;
+      }
+
+      message.m_time = time;
+      message.m_missing = false;
+      if (size <= BaseParameters::s_maxfilesize)
+      {
+         message.m_data = data;
+         message.m_size = size;
+      }
+      else
+      {
+         // Message size exceeded, the end of the message is kept
+         message.m_data = data + size - BaseParameters::s_maxfilesize;
+         message.m_size = BaseParameters::s_maxfilesize;
+
+         ostringstream s;
+         s << "Message size exceeds max allowed size - truncated.";
+         Logger::event(LOG_LEVEL_WARN, WHERE__, s.str());
+      }
+      m_pos = data + size - m_addr;
+      return true;
+   }
+   return false;
+}
+
+//----------------------------------------------------------------------------------------
+// Get the mapped file data
+//----------------------------------------------------------------------------------------
+const char* MessageParser::data() const
+{
+   return m_addr;
+}
+
+//----------------------------------------------------------------------------------------
+// Get the mapped file size
+//----------------------------------------------------------------------------------------
+size_t MessageParser::size() const
+{
+   return m_size;
+}
+
+//----------------------------------------------------------------------------------------
+// Get offset to the end of the last complete message
+//----------------------------------------------------------------------------------------
+size_t MessageParser::tell() const
+{
+   return m_pos;
+}
+
+//----------------------------------------------------------------------------------------
+// Find the next header tag, the tag must be followed by white space
+//----------------------------------------------------------------------------------------
+const char* MessageParser::findHeader(const char* pos) const
+{
+   const char* end = m_addr + m_size;
+   const size_t len = m_tag.size();
+
+   while (static_cast<size_t>(end - pos) > len)
+   {
+      const char* tag = static_cast<const char*>(memchr(pos, m_tag[0], end - pos - len));
+      if (tag == 0)
+      {
+         return 0;
+      }
+      if ((memcmp(tag, m_tag.data(), len) == 0) &&
+          isspace(static_cast<unsigned char>(tag[len])))
+      {
+         return tag;
+      }
+      pos = tag + 1;
+   }
+   return 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Parse the fields after a CLH header tag.
+// Time and size are decimal numbers in fields of 18 and 14 bytes.
+//----------------------------------------------------------------------------------------
+int MessageParser::parseCLHFields(
+      const char* pos,
+      int64_t& time,
+      uintmax_t& size,
+      const char*& data
+      ) const
+{
+   const char* end = m_addr + m_size;
+   uintmax_t value;
+   bool valid;
+
+   // Get time
+   if (parseNumber(pos, true, value, valid) == 0)
+   {
+      return 0;
+   }
+   if (valid == false)
+   {
+      return -1;
+   }
+   time = static_cast<int64_t>(value);
+
+   // Get size
+   if (end - pos < 32)
+   {
+      return 0;
+   }
+   if (parseNumber(pos + 18, false, value, valid) == 0)
+   {
+      return 0;
+   }
+   if (valid == false)
+   {
+      return -1;
+   }
+   size = value;
+
+   data = pos + 32;
+   return 1;
+}
+
+//----------------------------------------------------------------------------------------
+// Parse the fields after a TESRV header tag.
+// Time and size are binary numbers, the size is followed by a new line.
+//----------------------------------------------------------------------------------------
+int MessageParser::parseTESRVFields(
+      const char* pos,
+      int64_t& time,
+      uintmax_t& size,
+      const char*& data
+      ) const
+{
+   const char* end = m_addr + m_size;
+   if (end - pos < 17)
+   {
+      return 0;
+   }
+
+   memcpy(&time, pos, sizeof(int64_t));
+   memcpy(&size, pos + 8, sizeof(uintmax_t));
+   data = pos + 17;
+   return 1;
+}
+
+//----------------------------------------------------------------------------------------
+// Parse a decimal number token, a negative number is returned in two's complement
+//----------------------------------------------------------------------------------------
+const char* MessageParser::parseNumber(
+      const char* pos,
+      bool issigned,
+      uintmax_t& value,
+      bool& valid
+      ) const
+{
+   const char* end = m_addr + m_size;
+   while ((pos != end) && isspace(static_cast<unsigned char>(*pos)))
+   {
+      pos++;
+   }
+
+   const char* iter = pos;
+   while ((pos != end) && (isspace(static_cast<unsigned char>(*pos)) == 0))
+   {
+      pos++;
+   }
+   if (pos == end)
+   {
+      // Token is not terminated
+      return 0;
+   }
+
+   bool negative = false;
+   if ((iter != pos) && ((*iter == '+') || (issigned && (*iter == '-'))))
+   {
+      negative = (*iter == '-');
+      iter++;
+   }
+
+   const uintmax_t max = issigned?
+         static_cast<uintmax_t>(numeric_limits<int64_t>::max()) + negative:
+         numeric_limits<uintmax_t>::max();
+
+   value = 0;
+   valid = (iter != pos);
+   for (; valid && (iter != pos); ++iter)
+   {
+      if ((*iter < '0') || (*iter > '9'))
+      {
+         valid = false;
+      }
+      else
+      {
+         const uintmax_t digit = *iter - '0';
+         valid = (value <= (max - digit) / 10);
+         value = value * 10 + digit;
+      }
+   }
+
+   if (negative)
+   {
+      value = -value;
+   }
+   return pos;
+}
+
 }
 
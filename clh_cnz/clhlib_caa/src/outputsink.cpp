@@ -0,0 +1,153 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      outputsink.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Output stream with a large user-space buffer in front of another stream.
+//
+//  ERROR HANDLING
+//      Write errors set badbit on the sink.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "outputsink.h"
+#include <string.h>
+
+using namespace std;
+
+namespace PES_CLH {
+
+//========================================================================================
+// Class OutputSink
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+OutputSink::OutputSink(ostream& os, size_t size):
+ostream(0),
+m_buffer(os, size)
+{
+   rdbuf(&m_buffer);
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+OutputSink::~OutputSink()
+{
+   m_buffer.drain();
+}
+
+//========================================================================================
+// Class OutputSink::Buffer
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+OutputSink::Buffer::Buffer(ostream& os, size_t size):
+streambuf(),
+m_os(os),
+m_buffer(size > 0? size: 1)
+{
+   setp(&m_buffer[0], &m_buffer[0] + m_buffer.size());
+}
+
+//----------------------------------------------------------------------------------------
+// Write the buffer to the target stream
+//----------------------------------------------------------------------------------------
+bool OutputSink::Buffer::drain()
+{
+   const streamsize size = pptr() - pbase();
+   if (size > 0)
+   {
+      m_os.write(pbase(), size);
+      setp(&m_buffer[0], &m_buffer[0] + m_buffer.size());
+   }
+   return m_os.good();
+}
+
+//----------------------------------------------------------------------------------------
+// Buffer is full, write it to the target stream
+//----------------------------------------------------------------------------------------
+OutputSink::Buffer::int_type OutputSink::Buffer::overflow(int_type ch)
+{
+   if (drain() == false)
+   {
+      return traits_type::eof();
+   }
+   if (traits_type::eq_int_type(ch, traits_type::eof()) == false)
+   {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+   }
+   return traits_type::not_eof(ch);
+}
+
+//----------------------------------------------------------------------------------------
+// Write a block of data, data larger than the buffer is written directly
+//----------------------------------------------------------------------------------------
+streamsize OutputSink::Buffer::xsputn(const char* data, streamsize size)
+{
+   if (size <= epptr() - pptr())
+   {
+      memcpy(pptr(), data, size);
+      pbump(static_cast<int>(size));
+      return size;
+   }
+
+   if (drain() == false)
+   {
+      return 0;
+   }
+   if (size < epptr() - pptr())
+   {
+      memcpy(pptr(), data, size);
+      pbump(static_cast<int>(size));
+      return size;
+   }
+   m_os.write(data, size);
+   return m_os.good()? size: 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Flush the buffer and the target stream
+//----------------------------------------------------------------------------------------
+int OutputSink::Buffer::sync()
+{
+   if (drain() == false)
+   {
+      return -1;
+   }
+   m_os.flush();
+   return m_os.good()? 0: -1;
+}
+
+}
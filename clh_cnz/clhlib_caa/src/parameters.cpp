@@ -112,10 +112,12 @@ template<> const uint16_t Parameters<e_error>::s_apzset = s_apzAll;
 template<> const t_headertype Parameters<e_error>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_error>::s_hasmsgno = true;
 template<> const bool Parameters<e_error>::s_hasxmno = false;
+template<> const bool Parameters<e_error>::s_hascompression = false;
 template<> uintmax_t Parameters<e_error>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_error>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_error>::s_divider = 50;
 template<> int Parameters<e_error>::s_noEP = 0;
+template<> t_durability Parameters<e_error>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_event>
@@ -139,10 +141,12 @@ template<> const uint16_t Parameters<e_event>::s_apzset = s_apzAll;
 template<> const t_headertype Parameters<e_event>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_event>::s_hasmsgno = true;
 template<> const bool Parameters<e_event>::s_hasxmno = false;
+template<> const bool Parameters<e_event>::s_hascompression = false;
 template<> uintmax_t Parameters<e_event>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_event>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_event>::s_divider = 50;
 template<> int Parameters<e_event>::s_noEP = 0;
+template<> t_durability Parameters<e_event>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_syslog>
@@ -166,10 +170,12 @@ template<> const uint16_t Parameters<e_syslog>::s_apzset = 1<<e_apz21240 | s_apz
 template<> const t_headertype Parameters<e_syslog>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_syslog>::s_hasmsgno = false;
 template<> const bool Parameters<e_syslog>::s_hasxmno = false;
+template<> const bool Parameters<e_syslog>::s_hascompression = true;
 template<> uintmax_t Parameters<e_syslog>::s_maxsize = 200000000;
 template<> uint64_t Parameters<e_syslog>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_syslog>::s_divider = 50;
 template<> int Parameters<e_syslog>::s_noEP = 0;
+template<> t_durability Parameters<e_syslog>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_binlog>
@@ -193,10 +199,12 @@ template<> const uint16_t Parameters<e_binlog>::s_apzset = 1<<e_apz21240;
 template<> const t_headertype Parameters<e_binlog>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_binlog>::s_hasmsgno = false;
 template<> const bool Parameters<e_binlog>::s_hasxmno = false;
+template<> const bool Parameters<e_binlog>::s_hascompression = false;
 template<> uintmax_t Parameters<e_binlog>::s_maxsize = 200000000;
 template<> uint64_t Parameters<e_binlog>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_binlog>::s_divider = 50;
 template<> int Parameters<e_binlog>::s_noEP = 0;
+template<> t_durability Parameters<e_binlog>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_corecpbb>
@@ -220,10 +228,12 @@ template<> const uint16_t Parameters<e_corecpbb>::s_apzset = 1<<e_apz21240;
 template<> const t_headertype Parameters<e_corecpbb>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_corecpbb>::s_hasmsgno = false;
 template<> const bool Parameters<e_corecpbb>::s_hasxmno = false;
+template<> const bool Parameters<e_corecpbb>::s_hascompression = false;
 template<> uintmax_t Parameters<e_corecpbb>::s_maxsize = 500000000;
 template<> uint64_t Parameters<e_corecpbb>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_corecpbb>::s_divider = 50;
 template<> int Parameters<e_corecpbb>::s_noEP = 0;
+template<> t_durability Parameters<e_corecpbb>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_corecpsb>
@@ -247,10 +257,12 @@ template<> const uint16_t Parameters<e_corecpsb>::s_apzset = 1<<e_apz21250;
 template<> const t_headertype Parameters<e_corecpsb>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_corecpsb>::s_hasmsgno = false;
 template<> const bool Parameters<e_corecpsb>::s_hasxmno = false;
+template<> const bool Parameters<e_corecpsb>::s_hascompression = false;
 template<> uintmax_t Parameters<e_corecpsb>::s_maxsize = 500000000;
 template<> uint64_t Parameters<e_corecpsb>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_corecpsb>::s_divider = 50;
 template<> int Parameters<e_corecpsb>::s_noEP = 0;
+template<> t_durability Parameters<e_corecpsb>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_corepcih>
@@ -275,10 +287,12 @@ template<> const uint16_t Parameters<e_corepcih>::s_apzset = 1<<e_apz21250;
 template<> const t_headertype Parameters<e_corepcih>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_corepcih>::s_hasmsgno = false;
 template<> const bool Parameters<e_corepcih>::s_hasxmno = false;
+template<> const bool Parameters<e_corepcih>::s_hascompression = false;
 template<> uintmax_t Parameters<e_corepcih>::s_maxsize = 500000000;
 template<> uint64_t Parameters<e_corepcih>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_corepcih>::s_divider = 50;
 template<> int Parameters<e_corepcih>::s_noEP = 0;
+template<> t_durability Parameters<e_corepcih>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_corecpub>
@@ -302,10 +316,12 @@ template<> const uint16_t Parameters<e_corecpub>::s_apzset = s_apzCpub | 1<<e_ap
 template<> const t_headertype Parameters<e_corecpub>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_corecpub>::s_hasmsgno = false;
 template<> const bool Parameters<e_corecpub>::s_hasxmno = false;
+template<> const bool Parameters<e_corecpub>::s_hascompression = false;
 template<> uintmax_t Parameters<e_corecpub>::s_maxsize = 500000000;
 template<> uint64_t Parameters<e_corecpub>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_corecpub>::s_divider = 50;
 template<> int Parameters<e_corecpub>::s_noEP = 0;
+template<> t_durability Parameters<e_corecpub>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 //	Class Parameters<e_crashcpbb>
@@ -327,10 +343,12 @@ template<> const uint16_t Parameters<e_crashcpbb>::s_apzset = 1<<e_apz21240;
 template<> const t_headertype Parameters<e_crashcpbb>::s_headertype = e_noHeader;
 template<> const bool Parameters<e_crashcpbb>::s_hasmsgno = false;
 template<> const bool Parameters<e_crashcpbb>::s_hasxmno = false;
+template<> const bool Parameters<e_crashcpbb>::s_hascompression = false;
 template<> uintmax_t Parameters<e_crashcpbb>::s_maxsize = 1000000000;
 template<> uint64_t Parameters<e_crashcpbb>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_crashcpbb>::s_divider = 50;
 template<> int Parameters<e_crashcpbb>::s_noEP = 0;
+template<> t_durability Parameters<e_crashcpbb>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_crashcpsb>
@@ -350,10 +368,12 @@ template<> const uint16_t Parameters<e_crashcpsb>::s_apzset = 1<<e_apz21250;
 template<> const t_headertype Parameters<e_crashcpsb>::s_headertype = e_noHeader;
 template<> const bool Parameters<e_crashcpsb>::s_hasmsgno = false;
 template<> const bool Parameters<e_crashcpsb>::s_hasxmno = false;
+template<> const bool Parameters<e_crashcpsb>::s_hascompression = false;
 template<> uintmax_t Parameters<e_crashcpsb>::s_maxsize = 1000000000;
 template<> uint64_t Parameters<e_crashcpsb>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_crashcpsb>::s_divider = 50;
 template<> int Parameters<e_crashcpsb>::s_noEP = 0;
+template<> t_durability Parameters<e_crashcpsb>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_crashpcih>
@@ -373,10 +393,12 @@ template<> const uint16_t Parameters<e_crashpcih>::s_apzset = 1<<e_apz21250;
 template<> const t_headertype Parameters<e_crashpcih>::s_headertype = e_noHeader;
 template<> const bool Parameters<e_crashpcih>::s_hasmsgno = false;
 template<> const bool Parameters<e_crashpcih>::s_hasxmno = false;
+template<> const bool Parameters<e_crashpcih>::s_hascompression = false;
 template<> uintmax_t Parameters<e_crashpcih>::s_maxsize = 1000000000;
 template<> uint64_t Parameters<e_crashpcih>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_crashpcih>::s_divider = 50;
 template<> int Parameters<e_crashpcih>::s_noEP = 0;
+template<> t_durability Parameters<e_crashpcih>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_crashcpub>
@@ -400,10 +422,12 @@ template<> const uint16_t Parameters<e_crashcpub>::s_apzset = s_apzCpub | 1<<e_a
 template<> const t_headertype Parameters<e_crashcpub>::s_headertype = e_noHeader;
 template<> const bool Parameters<e_crashcpub>::s_hasmsgno = false;
 template<> const bool Parameters<e_crashcpub>::s_hasxmno = false;
+template<> const bool Parameters<e_crashcpub>::s_hascompression = false;
 template<> uintmax_t Parameters<e_crashcpub>::s_maxsize = 1000000000;
 template<> uint64_t Parameters<e_crashcpub>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_crashcpub>::s_divider = 50;
 template<> int Parameters<e_crashcpub>::s_noEP = 0;
+template<> t_durability Parameters<e_crashcpub>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_evlogcpsb>
@@ -427,10 +451,12 @@ template<> const uint16_t Parameters<e_evlogcpsb>::s_apzset = 1<<e_apz21250;
 template<> const t_headertype Parameters<e_evlogcpsb>::s_headertype = e_noHeader;
 template<> const bool Parameters<e_evlogcpsb>::s_hasmsgno = false;
 template<> const bool Parameters<e_evlogcpsb>::s_hasxmno = false;
+template<> const bool Parameters<e_evlogcpsb>::s_hascompression = false;
 template<> uintmax_t Parameters<e_evlogcpsb>::s_maxsize = 200000000;
 template<> uint64_t Parameters<e_evlogcpsb>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_evlogcpsb>::s_divider = 50;
 template<> int Parameters<e_evlogcpsb>::s_noEP = 0;
+template<> t_durability Parameters<e_evlogcpsb>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_evlogpcih>
@@ -454,10 +480,12 @@ template<> const uint16_t Parameters<e_evlogpcih>::s_apzset = 1<<e_apz21250;
 template<> const t_headertype Parameters<e_evlogpcih>::s_headertype = e_noHeader;
 template<> const bool Parameters<e_evlogpcih>::s_hasmsgno = false;
 template<> const bool Parameters<e_evlogpcih>::s_hasxmno = false;
+template<> const bool Parameters<e_evlogpcih>::s_hascompression = false;
 template<> uintmax_t Parameters<e_evlogpcih>::s_maxsize = 200000000;
 template<> uint64_t Parameters<e_evlogpcih>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_evlogpcih>::s_divider = 50;
 template<> int Parameters<e_evlogpcih>::s_noEP = 0;
+template<> t_durability Parameters<e_evlogpcih>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_salinfocpsb>
@@ -477,10 +505,12 @@ template<> const uint16_t Parameters<e_salinfocpsb>::s_apzset = 1<<e_apz21250;
 template<> const t_headertype Parameters<e_salinfocpsb>::s_headertype = e_noHeader;
 template<> const bool Parameters<e_salinfocpsb>::s_hasmsgno = false;
 template<> const bool Parameters<e_salinfocpsb>::s_hasxmno = false;
+template<> const bool Parameters<e_salinfocpsb>::s_hascompression = false;
 template<> uintmax_t Parameters<e_salinfocpsb>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_salinfocpsb>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_salinfocpsb>::s_divider = 50;
 template<> int Parameters<e_salinfocpsb>::s_noEP = 0;
+template<> t_durability Parameters<e_salinfocpsb>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 //	Class Parameters<e_sel>
@@ -504,10 +534,12 @@ template<> const uint16_t Parameters<e_sel>::s_apzset = 1<<e_apz21255 | 1<<e_apz
 template<> const t_headertype Parameters<e_sel>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_sel>::s_hasmsgno = false;
 template<> const bool Parameters<e_sel>::s_hasxmno = false;
+template<> const bool Parameters<e_sel>::s_hascompression = false;
 template<> uintmax_t Parameters<e_sel>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_sel>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_sel>::s_divider = 50;
 template<> int Parameters<e_sel>::s_noEP = 0;
+template<> t_durability Parameters<e_sel>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_ruf>
@@ -527,10 +559,12 @@ template<> const uint16_t Parameters<e_ruf>::s_apzset = s_apzCpub;
 template<> const t_headertype Parameters<e_ruf>::s_headertype = e_noHeader;
 template<> const bool Parameters<e_ruf>::s_hasmsgno = false;
 template<> const bool Parameters<e_ruf>::s_hasxmno = false;
+template<> const bool Parameters<e_ruf>::s_hascompression = false;
 template<> uintmax_t Parameters<e_ruf>::s_maxsize = 0;
 template<> uint64_t Parameters<e_ruf>::s_maxtime = 0;
 template<> uint16_t Parameters<e_ruf>::s_divider = 0;
 template<> int Parameters<e_ruf>::s_noEP = 0;
+template<> t_durability Parameters<e_ruf>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_consolsrm>
@@ -554,10 +588,12 @@ template<> const uint16_t Parameters<e_consolsrm>::s_apzset = 1<<e_apz21240;
 template<> const t_headertype Parameters<e_consolsrm>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_consolsrm>::s_hasmsgno = false;
 template<> const bool Parameters<e_consolsrm>::s_hasxmno = false;
+template<> const bool Parameters<e_consolsrm>::s_hascompression = true;
 template<> uintmax_t Parameters<e_consolsrm>::s_maxsize = 200000000;
 template<> uint64_t Parameters<e_consolsrm>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_consolsrm>::s_divider = 50;
 template<> int Parameters<e_consolsrm>::s_noEP = 0;
+template<> t_durability Parameters<e_consolsrm>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_consolbmc>
@@ -581,10 +617,12 @@ template<> const uint16_t Parameters<e_consolbmc>::s_apzset = 1<<e_apz21240 | 1<
 template<> const t_headertype Parameters<e_consolbmc>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_consolbmc>::s_hasmsgno = false;
 template<> const bool Parameters<e_consolbmc>::s_hasxmno = false;
+template<> const bool Parameters<e_consolbmc>::s_hascompression = true;
 template<> uintmax_t Parameters<e_consolbmc>::s_maxsize = 200000000;
 template<> uint64_t Parameters<e_consolbmc>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_consolbmc>::s_divider = 50;
 template<> int Parameters<e_consolbmc>::s_noEP = 0;
+template<> t_durability Parameters<e_consolbmc>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_consolmp>
@@ -608,10 +646,12 @@ template<> const uint16_t Parameters<e_consolmp>::s_apzset = 1<<e_apz21250;
 template<> const t_headertype Parameters<e_consolmp>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_consolmp>::s_hasmsgno = false;
 template<> const bool Parameters<e_consolmp>::s_hasxmno = false;
+template<> const bool Parameters<e_consolmp>::s_hascompression = true;
 template<> uintmax_t Parameters<e_consolmp>::s_maxsize = 200000000;
 template<> uint64_t Parameters<e_consolmp>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_consolmp>::s_divider = 50;
 template<> int Parameters<e_consolmp>::s_noEP = 0;
+template<> t_durability Parameters<e_consolmp>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_consolpcih>
@@ -635,10 +675,12 @@ template<> const uint16_t Parameters<e_consolpcih>::s_apzset = 1<<e_apz21250;
 template<> const t_headertype Parameters<e_consolpcih>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_consolpcih>::s_hasmsgno = false;
 template<> const bool Parameters<e_consolpcih>::s_hasxmno = false;
+template<> const bool Parameters<e_consolpcih>::s_hascompression = true;
 template<> uintmax_t Parameters<e_consolpcih>::s_maxsize = 200000000;
 template<> uint64_t Parameters<e_consolpcih>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_consolpcih>::s_divider = 50;
 template<> int Parameters<e_consolpcih>::s_noEP = 0;
+template<> t_durability Parameters<e_consolpcih>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_consolsyscon>
@@ -662,10 +704,12 @@ template<> const uint16_t Parameters<e_consolsyscon>::s_apzset = s_apzCpub | 1<<
 template<> const t_headertype Parameters<e_consolsyscon>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_consolsyscon>::s_hasmsgno = false;
 template<> const bool Parameters<e_consolsyscon>::s_hasxmno = false;
+template<> const bool Parameters<e_consolsyscon>::s_hascompression = true;
 template<> uintmax_t Parameters<e_consolsyscon>::s_maxsize = 200000000;
 template<> uint64_t Parameters<e_consolsyscon>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_consolsyscon>::s_divider = 50;
 template<> int Parameters<e_consolsyscon>::s_noEP = 0;
+template<> t_durability Parameters<e_consolsyscon>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_xpulog>
@@ -689,10 +733,12 @@ template<> const uint16_t Parameters<e_xpulog>::s_apzset = 1<<e_apz21403 | 1<<e_
 template<> const t_headertype Parameters<e_xpulog>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_xpulog>::s_hasmsgno = false;
 template<> const bool Parameters<e_xpulog>::s_hasxmno = true;
+template<> const bool Parameters<e_xpulog>::s_hascompression = false;
 template<> uintmax_t Parameters<e_xpulog>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_xpulog>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_xpulog>::s_divider = 50;
 template<> int Parameters<e_xpulog>::s_noEP = 0;
+template<> t_durability Parameters<e_xpulog>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_xpucore>
@@ -716,10 +762,12 @@ template<> const uint16_t Parameters<e_xpucore>::s_apzset = 1<<e_apz21403 | 1<<e
 template<> const t_headertype Parameters<e_xpucore>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_xpucore>::s_hasmsgno = false;
 template<> const bool Parameters<e_xpucore>::s_hasxmno = true;
+template<> const bool Parameters<e_xpucore>::s_hascompression = false;
 template<> uintmax_t Parameters<e_xpucore>::s_maxsize = 500000000;
 template<> uint64_t Parameters<e_xpucore>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_xpucore>::s_divider = 50;
 template<> int Parameters<e_xpucore>::s_noEP = 0;
+template<> t_durability Parameters<e_xpucore>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_trace>
@@ -743,10 +791,12 @@ template<> const uint16_t Parameters<e_trace>::s_apzset = s_apzAll;
 template<> const t_headertype Parameters<e_trace>::s_headertype = e_tesrvHeader;
 template<> const bool Parameters<e_trace>::s_hasmsgno = false;
 template<> const bool Parameters<e_trace>::s_hasxmno = false;
+template<> const bool Parameters<e_trace>::s_hascompression = true;
 template<> uintmax_t Parameters<e_trace>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_trace>::s_maxtime = 0;
 template<> uint16_t Parameters<e_trace>::s_divider = 0;
 template<> int Parameters<e_trace>::s_noEP = 0;
+template<> t_durability Parameters<e_trace>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_rp>
@@ -770,10 +820,12 @@ template<> const uint16_t Parameters<e_rp>::s_apzset = s_apzForRP;
 template<> const t_headertype Parameters<e_rp>::s_headertype = e_noHeader;
 template<> const bool Parameters<e_rp>::s_hasmsgno = false;
 template<> const bool Parameters<e_rp>::s_hasxmno = false;
+template<> const bool Parameters<e_rp>::s_hascompression = false;
 template<> uintmax_t Parameters<e_rp>::s_maxsize = 1000000000;
 template<> uint64_t Parameters<e_rp>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_rp>::s_divider = 50;
 template<> int Parameters<e_rp>::s_noEP = 0;
+template<> t_durability Parameters<e_rp>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_mphca>
@@ -797,10 +849,12 @@ template<> const uint16_t Parameters<e_mphca>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_mphca>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_mphca>::s_hasmsgno = false;
 template<> const bool Parameters<e_mphca>::s_hasxmno = false;
+template<> const bool Parameters<e_mphca>::s_hascompression = false;
 template<> uintmax_t Parameters<e_mphca>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_mphca>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_mphca>::s_divider = 50;
 template<> int Parameters<e_mphca>::s_noEP = 1;
+template<> t_durability Parameters<e_mphca>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_mphcb>
@@ -824,10 +878,12 @@ template<> const uint16_t Parameters<e_mphcb>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_mphcb>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_mphcb>::s_hasmsgno = false;
 template<> const bool Parameters<e_mphcb>::s_hasxmno = false;
+template<> const bool Parameters<e_mphcb>::s_hascompression = false;
 template<> uintmax_t Parameters<e_mphcb>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_mphcb>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_mphcb>::s_divider = 50;
 template<> int Parameters<e_mphcb>::s_noEP = 1;
+template<> t_durability Parameters<e_mphcb>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_mwsr>
@@ -851,10 +907,12 @@ template<> const uint16_t Parameters<e_mwsr>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_mwsr>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_mwsr>::s_hasmsgno = false;
 template<> const bool Parameters<e_mwsr>::s_hasxmno = false;
+template<> const bool Parameters<e_mwsr>::s_hascompression = false;
 template<> uintmax_t Parameters<e_mwsr>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_mwsr>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_mwsr>::s_divider = 50;
 template<> int Parameters<e_mwsr>::s_noEP = 1;
+template<> t_durability Parameters<e_mwsr>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_mehl>
@@ -878,10 +936,12 @@ template<> const uint16_t Parameters<e_mehl>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_mehl>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_mehl>::s_hasmsgno = false;
 template<> const bool Parameters<e_mehl>::s_hasxmno = false;
+template<> const bool Parameters<e_mehl>::s_hascompression = false;
 template<> uintmax_t Parameters<e_mehl>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_mehl>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_mehl>::s_divider = 50;
 template<> int Parameters<e_mehl>::s_noEP = 1;
+template<> t_durability Parameters<e_mehl>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_mcpflagsa>
@@ -905,10 +965,12 @@ template<> const uint16_t Parameters<e_mcpflagsa>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_mcpflagsa>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_mcpflagsa>::s_hasmsgno = false;
 template<> const bool Parameters<e_mcpflagsa>::s_hasxmno = false;
+template<> const bool Parameters<e_mcpflagsa>::s_hascompression = false;
 template<> uintmax_t Parameters<e_mcpflagsa>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_mcpflagsa>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_mcpflagsa>::s_divider = 50;
 template<> int Parameters<e_mcpflagsa>::s_noEP = 1;
+template<> t_durability Parameters<e_mcpflagsa>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_mcpflagsb>
@@ -932,10 +994,12 @@ template<> const uint16_t Parameters<e_mcpflagsb>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_mcpflagsb>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_mcpflagsb>::s_hasmsgno = false;
 template<> const bool Parameters<e_mcpflagsb>::s_hasxmno = false;
+template<> const bool Parameters<e_mcpflagsb>::s_hascompression = false;
 template<> uintmax_t Parameters<e_mcpflagsb>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_mcpflagsb>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_mcpflagsb>::s_divider = 50;
 template<> int Parameters<e_mcpflagsb>::s_noEP = 1;
+template<> t_durability Parameters<e_mcpflagsb>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_minfr>
@@ -959,10 +1023,12 @@ template<> const uint16_t Parameters<e_minfr>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_minfr>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_minfr>::s_hasmsgno = false;
 template<> const bool Parameters<e_minfr>::s_hasxmno = false;
+template<> const bool Parameters<e_minfr>::s_hascompression = false;
 template<> uintmax_t Parameters<e_minfr>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_minfr>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_minfr>::s_divider = 50;
 template<> int Parameters<e_minfr>::s_noEP = 1;
+template<> t_durability Parameters<e_minfr>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_mintfstsa>
@@ -986,10 +1052,12 @@ template<> const uint16_t Parameters<e_mintfstsa>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_mintfstsa>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_mintfstsa>::s_hasmsgno = false;
 template<> const bool Parameters<e_mintfstsa>::s_hasxmno = false;
+template<> const bool Parameters<e_mintfstsa>::s_hascompression = false;
 template<> uintmax_t Parameters<e_mintfstsa>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_mintfstsa>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_mintfstsa>::s_divider = 50;
 template<> int Parameters<e_mintfstsa>::s_noEP = 1;
+template<> t_durability Parameters<e_mintfstsa>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_mintfstsb>
@@ -1013,10 +1081,12 @@ template<> const uint16_t Parameters<e_mintfstsb>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_mintfstsb>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_mintfstsb>::s_hasmsgno = false;
 template<> const bool Parameters<e_mintfstsb>::s_hasxmno = false;
+template<> const bool Parameters<e_mintfstsb>::s_hascompression = false;
 template<> uintmax_t Parameters<e_mintfstsb>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_mintfstsb>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_mintfstsb>::s_divider = 50;
 template<> int Parameters<e_mintfstsb>::s_noEP = 1;
+template<> t_durability Parameters<e_mintfstsb>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_msyscon>
@@ -1040,10 +1110,12 @@ template<> const uint16_t Parameters<e_msyscon>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_msyscon>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_msyscon>::s_hasmsgno = false;
 template<> const bool Parameters<e_msyscon>::s_hasxmno = false;
+template<> const bool Parameters<e_msyscon>::s_hascompression = false;
 template<> uintmax_t Parameters<e_msyscon>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_msyscon>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_msyscon>::s_divider = 50;
 template<> int Parameters<e_msyscon>::s_noEP = 2;
+template<> t_durability Parameters<e_msyscon>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_mcore>
@@ -1067,10 +1139,12 @@ template<> const uint16_t Parameters<e_mcore>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_mcore>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_mcore>::s_hasmsgno = false;
 template<> const bool Parameters<e_mcore>::s_hasxmno = false;
+template<> const bool Parameters<e_mcore>::s_hascompression = false;
 template<> uintmax_t Parameters<e_mcore>::s_maxsize = 100000000;
 template<> uint64_t Parameters<e_mcore>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_mcore>::s_divider = 50;
 template<> int Parameters<e_mcore>::s_noEP = 2;
+template<> t_durability Parameters<e_mcore>::s_durability = {e_syncNone, 0, 0};
 
 //========================================================================================
 // Class Parameters<e_mevent>
@@ -1094,10 +1168,12 @@ template<> const uint16_t Parameters<e_mevent>::s_apzset = s_apzMaus;
 template<> const t_headertype Parameters<e_mevent>::s_headertype = e_clhHeader;
 template<> const bool Parameters<e_mevent>::s_hasmsgno = false;
 template<> const bool Parameters<e_mevent>::s_hasxmno = false;
+template<> const bool Parameters<e_mevent>::s_hascompression = false;
 template<> uintmax_t Parameters<e_mevent>::s_maxsize = 10000000;
 template<> uint64_t Parameters<e_mevent>::s_maxtime = 336 * Time::s_hour;
 template<> uint16_t Parameters<e_mevent>::s_divider = 50;
 template<> int Parameters<e_mevent>::s_noEP = 4;
+template<> t_durability Parameters<e_mevent>::s_durability = {e_syncNone, 0, 0};
 
 }
 
@@ -0,0 +1,332 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      searchfilter.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Class for filtering logs based on the event text.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "searchfilter.h"
+#include "exception.h"
+#include <ctype.h>
+#include <string.h>
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+namespace PES_CLH {
+
+//----------------------------------------------------------------------------------------
+// Constructors
+//----------------------------------------------------------------------------------------
+SearchFilter::SearchFilter(const string& pattern, bool regex, bool icase):
+Filter(),
+m_pattern(pattern),
+m_regex(regex),
+m_icase(icase),
+m_literal(),
+m_expression()
+{
+   if (m_pattern.empty())
+   {
+      throw Exception(Exception::illSearchPattern(m_pattern), WHERE__);
+   }
+
+   if (m_regex)
+   {
+      try
+      {
+         boost::regex::flag_type flags = boost::regex::perl;
+         if (m_icase)
+         {
+            flags |= boost::regex::icase;
+         }
+         m_expression.assign(m_pattern, flags);
+      }
+      catch (boost::regex_error&)
+      {
+         throw Exception(Exception::illSearchPattern(m_pattern), WHERE__);
+      }
+      m_literal = getLiteral(m_pattern);
+   }
+   else
+   {
+      m_literal = m_pattern;
+   }
+
+   if (m_icase)
+   {
+      for (string::iterator iter = m_literal.begin(); iter != m_literal.end(); ++iter)
+      {
+         *iter = static_cast<char>(tolower(static_cast<unsigned char>(*iter)));
+      }
+   }
+}
+
+SearchFilter::SearchFilter():
+Filter(),
+m_pattern(),
+m_regex(false),
+m_icase(false),
+m_literal(),
+m_expression()
+{
+}
+
+//----------------------------------------------------------------------------------------
+//   Destructor
+//----------------------------------------------------------------------------------------
+SearchFilter::~SearchFilter()
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Check if filter is empty
+//----------------------------------------------------------------------------------------
+bool SearchFilter::empty() const
+{
+   return m_pattern.empty();
+}
+
+//----------------------------------------------------------------------------------------
+// Check if the filter reads the event data
+//----------------------------------------------------------------------------------------
+bool SearchFilter::needsData() const
+{
+   return m_pattern.empty() == false;
+}
+
+//----------------------------------------------------------------------------------------
+// Test filter match
+//----------------------------------------------------------------------------------------
+bool SearchFilter::test(const char* data, size_t size) const
+{
+   if (m_pattern.empty()) return true;
+
+   // Events not holding the literal string can not match
+   if ((m_literal.empty() == false) && (findLiteral(data, size) == 0))
+   {
+      return false;
+   }
+
+   if (m_regex)
+   {
+      return boost::regex_search(data, data + size, m_expression);
+   }
+   return true;
+}
+
+//----------------------------------------------------------------------------------------
+// Get a literal string that every match of a regular expression contains.
+// Only the top level of the expression is analyzed, any construct that is not
+// understood makes the function give up and return an empty string.
+//----------------------------------------------------------------------------------------
+string SearchFilter::getLiteral(const string& pattern)
+{
+   // Alternatives and inline modifiers
+   if ((pattern.find('|') != string::npos) || (pattern.find("(?") != string::npos))
+   {
+      return string();
+   }
+
+   string literal;
+   string run;
+   int depth(0);
+   size_t i(0);
+   while (i < pattern.size())
+   {
+      char c = pattern[i];
+      bool isliteral(false);
+      size_t next(i + 1);
+
+      if (c == '\\')
+      {
+         if (next == pattern.size()) return string();
+         char e = pattern[next];
+         next++;
+         if (ispunct(static_cast<unsigned char>(e)))
+         {
+            // Escaped metacharacter
+            c = e;
+            isliteral = true;
+         }
+         else if (strchr("dDwWsSbB", e) == 0)
+         {
+            // Numeric escapes, back references etc.
+            return string();
+         }
+      }
+      else if (c == '[')
+      {
+         // Skip bracket expression
+         if ((next < pattern.size()) && (pattern[next] == '^')) next++;
+         if ((next < pattern.size()) && (pattern[next] == ']')) next++;
+         while ((next < pattern.size()) && (pattern[next] != ']'))
+         {
+            if ((pattern[next] == '[') && (next + 1 < pattern.size()) &&
+                (strchr(":.=", pattern[next + 1]) != 0))
+            {
+               // Character class, e.g. [:alpha:]
+               size_t end = pattern.find(pattern.substr(next + 1, 1) + "]", next + 2);
+               if (end == string::npos) return string();
+               next = end + 1;
+            }
+            else if (pattern[next] == '\\') next++;
+            next++;
+         }
+         next++;
+      }
+      else if (c == '{')
+      {
+         // Skip repetition count
+         next = pattern.find('}', next);
+         if (next == string::npos) return string();
+         next++;
+      }
+      else if (c == '(')
+      {
+         depth++;
+      }
+      else if (c == ')')
+      {
+         depth--;
+      }
+      else if (strchr(".^$*+?{}", c) == 0)
+      {
+         isliteral = true;
+      }
+
+      if (isliteral && (depth == 0))
+      {
+         char q = (next < pattern.size())? pattern[next]: '\0';
+         if ((q == '?') || (q == '*') || (q == '{'))
+         {
+            // Optional character ends the run
+            isliteral = false;
+         }
+         else
+         {
+            run += c;
+            if (q == '+') isliteral = false;
+         }
+      }
+      else
+      {
+         isliteral = false;
+      }
+
+      if (isliteral == false)
+      {
+         if (run.size() > literal.size()) literal = run;
+         run.clear();
+      }
+      i = next;
+   }
+   if (run.size() > literal.size()) literal = run;
+
+   return literal;
+}
+
+//----------------------------------------------------------------------------------------
+// Search data for the literal string.
+// Candidate positions are found by comparing the first and last character of the
+// literal with 16 positions at a time, only the candidates are compared in full.
+//----------------------------------------------------------------------------------------
+const char* SearchFilter::findLiteral(const char* data, size_t size) const
+{
+   const size_t len = m_literal.size();
+   if (size < len) return 0;
+
+   const char* pos = data;
+   const char* const last = data + size - len;      // Last possible start position
+
+#ifdef __SSE2__
+   const unsigned char first = m_literal[0];
+   const unsigned char final = m_literal[len - 1];
+   const __m128i first1 = _mm_set1_epi8(static_cast<char>(first));
+   const __m128i final1 = _mm_set1_epi8(static_cast<char>(final));
+   const __m128i first2 = _mm_set1_epi8(static_cast<char>(m_icase? toupper(first): first));
+   const __m128i final2 = _mm_set1_epi8(static_cast<char>(m_icase? toupper(final): final));
+
+   for (; last - pos >= 16; pos += 16)
+   {
+      const __m128i block1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos));
+      const __m128i block2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(pos + len - 1));
+      const __m128i eq1 = _mm_or_si128(_mm_cmpeq_epi8(block1, first1), _mm_cmpeq_epi8(block1, first2));
+      const __m128i eq2 = _mm_or_si128(_mm_cmpeq_epi8(block2, final1), _mm_cmpeq_epi8(block2, final2));
+      unsigned int mask = _mm_movemask_epi8(_mm_and_si128(eq1, eq2));
+      while (mask != 0)
+      {
+         const int bit = __builtin_ctz(mask);
+         if (matchLiteral(pos + bit))
+         {
+            return pos + bit;
+         }
+         mask &= mask - 1;
+      }
+   }
+#endif
+
+   for (; pos <= last; ++pos)
+   {
+      if (matchLiteral(pos))
+      {
+         return pos;
+      }
+   }
+   return 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Compare data with the literal string
+//----------------------------------------------------------------------------------------
+bool SearchFilter::matchLiteral(const char* pos) const
+{
+   if (m_icase == false)
+   {
+      return memcmp(pos, m_literal.data(), m_literal.size()) == 0;
+   }
+
+   for (string::const_iterator iter = m_literal.begin(); iter != m_literal.end(); ++iter)
+   {
+      if (tolower(static_cast<unsigned char>(*pos++)) != static_cast<unsigned char>(*iter))
+      {
+         return false;
+      }
+   }
+   return true;
+}
+
+}
@@ -0,0 +1,302 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      segment.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Class for a memory mapped, preallocated log subfile.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "segment.h"
+#include "exception.h"
+#include "logger.h"
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace PES_CLH {
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+Segment::Segment():
+m_path(),
+m_fd(-1),
+m_addr(0),
+m_size(0),
+m_capacity(0)
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+Segment::~Segment()
+{
+   close();
+}
+
+//----------------------------------------------------------------------------------------
+// Create and preallocate a new segment
+//----------------------------------------------------------------------------------------
+void Segment::create(const string& path, size_t capacity)
+{
+   close();
+
+   m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0666);
+   if (m_fd == -1)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to create file '" << path << "'.";
+      ex.sysError();
+      throw ex;
+   }
+
+   // Preallocate the disk blocks, a mapped write must never hit a full disk
+   int ret = posix_fallocate(m_fd, 0, capacity);
+   if (ret != 0)
+   {
+      ::close(m_fd);
+      m_fd = -1;
+      ::unlink(path.c_str());
+
+      errno = ret;
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to preallocate file '" << path << "'.";
+      ex.sysError();
+      throw ex;
+   }
+
+   m_path = path;
+   m_size = 0;
+   m_capacity = capacity;
+   map();
+}
+
+//----------------------------------------------------------------------------------------
+// Open an existing segment for appending
+//----------------------------------------------------------------------------------------
+void Segment::open(const string& path, size_t capacity, size_t size)
+{
+   close();
+
+   m_fd = ::open(path.c_str(), O_RDWR);
+   if (m_fd == -1)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to open file '" << path << "'.";
+      ex.sysError();
+      throw ex;
+   }
+
+   struct stat st;
+   if (fstat(m_fd, &st) == -1)
+   {
+      ::close(m_fd);
+      m_fd = -1;
+
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to get status for file '" << path << "'.";
+      ex.sysError();
+      throw ex;
+   }
+
+   if (static_cast<size_t>(st.st_size) > capacity)
+   {
+      capacity = st.st_size;
+   }
+
+   int ret = posix_fallocate(m_fd, 0, capacity);
+   if (ret != 0)
+   {
+      ::close(m_fd);
+      m_fd = -1;
+
+      errno = ret;
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to preallocate file '" << path << "'.";
+      ex.sysError();
+      throw ex;
+   }
+
+   m_path = path;
+   m_size = size;
+   m_capacity = capacity;
+   map();
+}
+
+//----------------------------------------------------------------------------------------
+// Map the preallocated file into memory
+//----------------------------------------------------------------------------------------
+void Segment::map()
+{
+   void* addr = mmap(0, m_capacity, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+   if (addr == MAP_FAILED)
+   {
+      // Truncate the file so that no preallocated space is left behind
+      ftruncate(m_fd, m_size);
+      ::close(m_fd);
+      m_fd = -1;
+
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to map file '" << m_path << "'.";
+      ex.sysError();
+      throw ex;
+   }
+   m_addr = static_cast<char*>(addr);
+}
+
+//----------------------------------------------------------------------------------------
+// Close segment, the file is truncated to its real length
+//----------------------------------------------------------------------------------------
+void Segment::close()
+{
+   if (m_fd == -1)
+   {
+      return;
+   }
+
+   if (m_addr)
+   {
+      munmap(m_addr, m_capacity);
+      m_addr = 0;
+   }
+
+   if (ftruncate(m_fd, m_size) == -1)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to truncate file '" << m_path << "'.";
+      ex.sysError();
+      Logger::event(ex);
+   }
+
+   ::close(m_fd);
+   m_fd = -1;
+   m_size = 0;
+   m_capacity = 0;
+   m_path.clear();
+}
+
+//----------------------------------------------------------------------------------------
+// Check if segment is open
+//----------------------------------------------------------------------------------------
+bool Segment::isOpen() const
+{
+   return m_fd != -1;
+}
+
+//----------------------------------------------------------------------------------------
+// Get the path to the segment file
+//----------------------------------------------------------------------------------------
+const string& Segment::getPath() const
+{
+   return m_path;
+}
+
+//----------------------------------------------------------------------------------------
+// Get real length of the segment
+//----------------------------------------------------------------------------------------
+size_t Segment::size() const
+{
+   return m_size;
+}
+
+//----------------------------------------------------------------------------------------
+// Get free space in the segment
+//----------------------------------------------------------------------------------------
+size_t Segment::avail() const
+{
+   return m_capacity - m_size;
+}
+
+//----------------------------------------------------------------------------------------
+// Append data to the segment
+//----------------------------------------------------------------------------------------
+void Segment::append(const void* data, size_t size)
+{
+   write(m_size, data, size);
+   m_size += size;
+}
+
+//----------------------------------------------------------------------------------------
+// Overwrite data in the segment
+//----------------------------------------------------------------------------------------
+void Segment::write(size_t offset, const void* data, size_t size)
+{
+   if (m_addr == 0 || offset + size > m_capacity)
+   {
+      Exception ex(Exception::internal(), WHERE__);
+      ex << "Write outside segment '" << m_path << "'.";
+      throw ex;
+   }
+   memcpy(m_addr + offset, data, size);
+}
+
+//----------------------------------------------------------------------------------------
+// Read data from the segment
+//----------------------------------------------------------------------------------------
+void Segment::read(size_t offset, void* data, size_t size) const
+{
+   if (m_addr == 0 || offset + size > m_size)
+   {
+      Exception ex(Exception::internal(), WHERE__);
+      ex << "Read outside segment '" << m_path << "'.";
+      throw ex;
+   }
+   memcpy(data, m_addr + offset, size);
+}
+
+//----------------------------------------------------------------------------------------
+// Write the segment data to disk, pages written through the mapping are included
+//----------------------------------------------------------------------------------------
+void Segment::sync()
+{
+   if (m_fd == -1)
+   {
+      return;
+   }
+
+   if (fdatasync(m_fd) == -1)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to sync file '" << m_path << "'.";
+      ex.sysError();
+      throw ex;
+   }
+}
+
+}
@@ -37,10 +37,14 @@
 //#</heading>
 
 #include "seltask.h"
+#include "logcursor.h"
+#include "outputsink.h"
 #include <acs_apbm_api.h>
 #include "common.h"
 #include "logger.h"
 #include <sstream>
+#include <fcntl.h>
+#include <unistd.h>
 
 
 
@@ -54,7 +58,8 @@ namespace PES_CLH {
 //----------------------------------------------------------------------------------------
 SelTask::SelTask():
 AppendTask(),
-m_parameters()
+m_parameters(),
+m_tmpsyncstate()
 {
 }
 
@@ -200,13 +205,13 @@ void SelTask::saveToFile(const fs::path& path,
    // Path to file
    const fs::path& filepath = path / filename;
 
-   fs::fstream ifs;
+   fs::fstream fs;
 
    // Check if sel.tmp does not exist, create it
    if (fs::exists(filepath) == false)
    {
       //Create new file
-      createFile(filepath);
+      openTmpFile(fs, filepath, true);
 
       // Log event
        Logger logger(LOG_LEVEL_INFO);
@@ -221,19 +226,22 @@ void SelTask::saveToFile(const fs::path& path,
    else
    {
       // Open the existing file
-      if (m_fs.is_open() == false)
-      {
-         // Open file
-         openFile(filepath);
-      }
+      openTmpFile(fs, filepath, false);
    }
 
-      m_fs.seekg(0, ios_base::end);         // Move get pointer to end of file
-      streamoff filesize = m_fs.tellg();   // File size
+      fs.seekg(0, ios_base::end);         // Move get pointer to end of file
+      streamoff filesize = fs.tellg();   // File size
       if (filesize + eventsize > 1000)
       {
          // File reached max size
-         m_fs.close();                     // Close current file
+         fs.close();                     // Close current file
+         if ((m_tmpsyncstate.m_unsynced > 0) &&
+             (m_parameters.getDurability().m_mode != e_syncNone))
+         {
+            // Sync the data that is left before the file is renamed
+            m_tmpsyncstate.m_unsynced = 0;
+            syncTmpFile(filepath);
+         }
 
          // Rename sel.tmp to sel_xxx.tmp and delete if the file list exceeds
          // TO DO
@@ -244,7 +252,8 @@ void SelTask::saveToFile(const fs::path& path,
          //m_fileListToFtpAP2.push_back(newpath);
 
          // Create new sel.tmp
-         createFile(filepath);
+         openTmpFile(fs, filepath, true);
+         filesize = 0;
       }
 
       //string selEvent = data + "\n\n";
@@ -271,15 +280,80 @@ void SelTask::saveToFile(const fs::path& path,
 
       if (filesize == 0)
    {
-         m_fs.write(selEvent.c_str(), sizeEvent);            // Write message
+         fs.write(selEvent.c_str(), sizeEvent);            // Write message
    }
    else
    {
-      m_fs.seekp(0, ios_base::end);      // Move put pointer to end of file
-      m_fs.write(selEvent.c_str(), sizeEvent);            // Write message
+      fs.seekp(0, ios_base::end);      // Move put pointer to end of file
+      fs.write(selEvent.c_str(), sizeEvent);            // Write message
+   }
+      fs.flush();
+      fs.close();
+
+   // Sync the tmp file according to the durability policy
+   if (needSync(m_tmpsyncstate, sizeEvent))
+   {
+      syncTmpFile(filepath);
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Write a tmp file to disk
+//----------------------------------------------------------------------------------------
+void SelTask::syncTmpFile(const fs::path& path)
+{
+   int fd = ::open(path.c_str(), O_RDONLY);
+   if ((fd == -1) || (fdatasync(fd) == -1))
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << *this << endl;
+      ex << "Failed to sync file " << path << ".";
+      ex.sysError();
+      Logger::event(ex);
+   }
+   if (fd != -1)
+   {
+      ::close(fd);
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Open a tmp file
+//----------------------------------------------------------------------------------------
+void SelTask::openTmpFile(fs::fstream& fs, const fs::path& path, bool create)
+{
+   if (create)
+   {
+      if (fs::exists(path) == true)
+      {
+         Exception ex(Exception::internal(), WHERE__);
+         ex << *this << endl;
+         ex << "File " << path << " already exists.";
+         throw ex;
+      }
+
+      // Create file
+      fs.open(path, ios_base::out | ios_base::binary);
+      if ((fs.is_open() == false) || (fs.fail() == true))
+      {
+         Exception ex(Exception::system(), WHERE__);
+         ex << *this << endl;
+         ex << "Failed to create file " << path << ".";
+         ex.sysError();
+         throw ex;
+      }
+      fs.close();
+   }
+
+   fs.open(path, ios_base::in | ios_base::out | ios_base::binary);
+   if ((fs.is_open() == false) || (fs.fail() == true))
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << *this << endl;
+      ex << "Failed to open file " << path << ".";
+      ex.sysError();
+      throw ex;
    }
-      m_fs.flush();
-      m_fs.close();
 }
 
 //----------------------------------------------------------------------------------------
@@ -301,103 +375,42 @@ Period SelTask::readSELEvents(
             bool checkonly
             ) const
 {
-   set<fs::path> list;
-
-   // Create a list with the log subfiles
-   const fs::path& logdir = getLogDir();
-
-   // Check log dir exist
-   if (fs::exists(logdir) == false)
-   {
-      return Period(Time(), Time());
-   }
-
-   fs::directory_iterator end;
-   for (fs::directory_iterator iter(logdir); iter != end; ++iter)
+   TimeStamp start;
+   TimeStamp stop;
+
+   // Print events in reverse order, start at the last event in the period.
+   // The record times are compared as time stamps, Time is only built for the printout.
+   const TimeStamp first(period.first());
+   LogCursor cursor(*this);
+   for (bool valid = cursor.seekBefore(period.last()); valid; valid = cursor.prev())
    {
-      const fs::path& path = *iter;
-      if (regex_match(path.filename().c_str(), getParameters().getLogFile()))
-      {
-         list.insert(path);
-      }
-   }
-
-   Time start;
-   Time stop;
+      const TimeStamp aptime = cursor.getAPStamp();
+      if (first > aptime) break;                      // Stop time reached
 
-   // Print events in reverse order from the log files
-   for (set<fs::path>::const_reverse_iterator riter = list.rbegin();
-        riter != list.rend();
-        ++riter)
-   {
-      bool nextfile = false;
-      const fs::path& path = *riter;
-      fs::ifstream fs(path, ios_base::binary);
-      if (fs.is_open() == false)
+      bool found = true;
+      if (eventcb)
       {
-         nextfile = true;
-      }
-
-      if (!nextfile)
-      {
-         t_header header;
-         readData(fs, header);
-         const Time& first(header.m_aptime);
-         size_t offset = header.m_prev;
-         fs.seekg(offset);
-         readData(fs, header);
-         const Time& last(header.m_aptime);
-
-         if (period.first() > last) break;                  // Stop time reached
-         if (period.last() >= first)
+         // Filter the printout, the data is only parsed if the filter reads it
+         const size_t size = cursor.getSize();
+         const char* const buf = cursor.getData();
+         found = (filter.needsData() == false) || filter.test(buf, size);
+         if (found)
          {
-            // Print events
-            fs.seekg(offset);
-            size_t next;
-
-            do
+            if (checkonly)
             {
-               next = offset;
-               readData(fs, header);
-               const Time& cptime(header.m_cptime);
-               const Time& aptime(header.m_aptime);
-               if (period.first() > aptime) break;       // Stop time reached
-               if (period.last() >= aptime)
-               {
-                  bool found = true;
-                  if (eventcb)
-                  {
-                     size_t size = header.m_size;
-                     boost::scoped_array<char> sarray(new char[size]);
-                     char* const buf = sarray.get();
-                     fs.read(buf, size);
-
-                     // Filter the printout
-                     found = filter.test(buf);
-                     if (found)
-                     {
-                        if (checkonly)
-                        {
-                           stop = aptime;
-                           return Period(stop, stop);
-                        }
-                        eventcb(cptime, aptime, size, buf, os);
-                     }
-                  }
-                  if (found)
-                  {
-                     if (stop.empty())
-                     {
-                        stop = aptime;
-                     }
-                     start = aptime;
-                  }
-               }
-               offset = header.m_prev;
-               fs.seekg(offset);
+               const Time& time = aptime.getTime();
+               return Period(time, time);
             }
-            while (next);
+            eventcb(cursor.getCPTime(), aptime.getTime(), size, buf, os);
+         }
+      }
+      if (found)
+      {
+         if (stop.empty())
+         {
+            stop = aptime;
          }
+         start = aptime;
       }
    }
 
@@ -410,10 +423,10 @@ Period SelTask::readSELEvents(
    // Start greater than stop time
    if  (start > stop)
    {
-      throw StartGreatStopTimeException(start, stop, WHERE__);
+      throw StartGreatStopTimeException(start.getTime(), stop.getTime(), WHERE__);
    }
 
-   return Period(start, stop);
+   return Period(start.getTime(), stop.getTime());
 }
 
 //----------------------------------------------------------------------------------------
@@ -423,7 +436,7 @@ string SelTask::transferSELLogs(
                      const Period& period,
                      const Filter& filter)
 {
-   const fs::path& tempfile = "temp";
+   const fs::path& tempfile = fs::unique_path("temp_%%%%%%%%");     // Unique for parallel transfers
    fs::ofstream fs(tempfile, ios_base::binary);
    if (fs.is_open() == false)
    {
@@ -439,13 +452,14 @@ string SelTask::transferSELLogs(
 
    try
    {
-   // Transfer append logs
-   const Period& tperiod = readSELEvents(
-                                   period,
-                                   filter,
-                                   printLogEvent,
-                                   fs
-                                   );
+      // Transfer append logs, the sink is flushed when it goes out of scope
+      OutputSink sink(fs);
+      const Period& tperiod = readSELEvents(
+                                      period,
+                                      filter,
+                                      printLogEvent,
+                                      sink
+                                      );
       if (tperiod.empty() == false)
       {
           start = tperiod.first();
@@ -475,7 +489,8 @@ string SelTask::transferSELLogs(
 
       ostringstream s;
       // sel_yyyymmdd_hhmmss__yyyymmdd_hhmmss.log
-      s << getParameters().getFilePrefix() << "_" << start << "__" << stop;
+      s << getParameters().getFilePrefix() << "_" << start.get(Time::e_plain) << "__"
+        << stop.get(Time::e_plain);
       
       if (m_issetap2)
       {
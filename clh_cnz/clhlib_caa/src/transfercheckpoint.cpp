@@ -0,0 +1,184 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      transfercheckpoint.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Checkpoints for incremental transfers, one per log and CP side.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "transfercheckpoint.h"
+#include "basetask.h"
+#include "exception.h"
+#include <boost/filesystem/fstream.hpp>
+#include <boost/thread/tss.hpp>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace std;
+
+namespace PES_CLH {
+
+namespace {
+
+// The checkpoints are owned by the creator of the object
+void noCleanup(TransferCheckpoint*)
+{
+}
+
+// Checkpoints of the current transfer of each thread
+boost::thread_specific_ptr<TransferCheckpoint> s_current(noCleanup);
+
+}
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+TransferCheckpoint::TransferCheckpoint(const fs::path& path, bool incremental):
+m_path(path),
+m_incremental(incremental),
+m_checkpointmap(),
+m_mutex()
+{
+   s_current.reset(this);
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+TransferCheckpoint::~TransferCheckpoint()
+{
+   if (s_current.get() == this)
+   {
+      s_current.reset(0);
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Get the checkpoint of a log in the current transfer
+//----------------------------------------------------------------------------------------
+string TransferCheckpoint::get(const BaseTask& task)
+{
+   TransferCheckpoint* const currentp = s_current.get();
+   if ((currentp == 0) || (currentp->m_incremental == false))
+   {
+      return string();
+   }
+
+   fs::ifstream fs(currentp->getPath(task));
+   string checkpoint;
+   getline(fs, checkpoint);
+   return checkpoint;
+}
+
+//----------------------------------------------------------------------------------------
+// Set the checkpoint of a log in the current transfer. A transfer of a whole period
+// leaves no checkpoints, as the period may end before the existing checkpoints.
+//----------------------------------------------------------------------------------------
+void TransferCheckpoint::set(const BaseTask& task, const string& checkpoint)
+{
+   TransferCheckpoint* const currentp = s_current.get();
+   if ((currentp == 0) || (currentp->m_incremental == false))
+   {
+      return;
+   }
+
+   const fs::path& path = currentp->getPath(task);
+   boost::mutex::scoped_lock lock(currentp->m_mutex);
+   currentp->m_checkpointmap[path] = checkpoint;
+}
+
+//----------------------------------------------------------------------------------------
+// Store the new checkpoints, each file is replaced in one step
+//----------------------------------------------------------------------------------------
+void TransferCheckpoint::commit()
+{
+   boost::mutex::scoped_lock lock(m_mutex);
+
+   for (CHECKPOINTMAP::const_iterator iter = m_checkpointmap.begin();
+        iter != m_checkpointmap.end();
+        ++iter)
+   {
+      const fs::path& path = iter->first;
+      fs::create_directories(path.parent_path());
+
+      fs::path temppath = path;
+      temppath += ".tmp";
+      fs::ofstream fs(temppath, ios_base::trunc);
+      fs << iter->second << endl;
+      fs.close();
+
+      // The checkpoint must be on disk before it replaces the old one
+      bool ok = (fs.fail() == false);
+      int fd = ok? ::open(temppath.c_str(), O_RDONLY): -1;
+      ok = (fd != -1) && (fdatasync(fd) == 0);
+      if (fd != -1)
+      {
+         ok = (::close(fd) == 0) && ok;
+      }
+      if (ok == false)
+      {
+         Exception ex(Exception::system(), WHERE__);
+         ex << "Failed to write transfer checkpoint " << temppath << ".";
+         ex.sysError();
+         throw ex;
+      }
+      fs::rename(temppath, path);
+   }
+   m_checkpointmap.clear();
+}
+
+//----------------------------------------------------------------------------------------
+// Get the checkpoints of the current transfer of the calling thread
+//----------------------------------------------------------------------------------------
+TransferCheckpoint* TransferCheckpoint::getCurrent()
+{
+   return s_current.get();
+}
+
+//----------------------------------------------------------------------------------------
+// Set the checkpoints of the current transfer of the calling thread
+//----------------------------------------------------------------------------------------
+void TransferCheckpoint::setCurrent(TransferCheckpoint* checkpointp)
+{
+   s_current.reset(checkpointp);
+}
+
+//----------------------------------------------------------------------------------------
+// Get path to the checkpoint file of a log
+//----------------------------------------------------------------------------------------
+fs::path TransferCheckpoint::getPath(const BaseTask& task) const
+{
+   return m_path / task.getParentDir() / (task.getParameters().getLogName() + ".ckpt");
+}
+
+}
@@ -0,0 +1,287 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      transferscheduler.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      Scheduler pacing the log reads of a transfer, to protect the log server.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "transferscheduler.h"
+#include "ingeststatus.h"
+#include "exception.h"
+#include <boost/lexical_cast.hpp>
+#include <boost/thread/tss.hpp>
+#include <algorithm>
+#include <iomanip>
+#include <time.h>
+
+using namespace std;
+
+namespace PES_CLH {
+
+namespace {
+
+// The scheduler is owned by its creator
+void noCleanup(TransferScheduler*)
+{
+}
+
+// Scheduler of the current transfer of each thread
+boost::thread_specific_ptr<TransferScheduler> s_current(noCleanup);
+
+}
+
+const int64_t TransferScheduler::s_checkinterval = 100000;    // 100 ms
+const int64_t TransferScheduler::s_maxpause = 10000000;       // 10 s
+const uint64_t TransferScheduler::s_maxbandwidth = 10000;     // 10 GB/s
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+TransferScheduler::TransferScheduler(uint64_t bandwidth, unsigned int cpushare):
+m_bandwidth(bandwidth),
+m_cpushare(cpushare),
+m_cores(boost::thread::hardware_concurrency()),
+m_start(getMonotonic()),
+m_cpustart(getCpuTime()),
+m_next(m_start),
+m_checked(0),
+m_backlog(false),
+m_pausestart(0),
+m_size(0),
+m_waiting(0),
+m_waitstart(0),
+m_throttled(0),
+m_mutex()
+{
+   if (m_cores == 0)
+   {
+      m_cores = 1;
+   }
+   s_current.reset(this);
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+TransferScheduler::~TransferScheduler()
+{
+   if (s_current.get() == this)
+   {
+      s_current.reset(0);
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Account data read by the current transfer of the calling thread and wait
+//----------------------------------------------------------------------------------------
+void TransferScheduler::throttle(size_t size)
+{
+   TransferScheduler* const currentp = s_current.get();
+   if (currentp)
+   {
+      currentp->wait(size);
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Get the scheduler of the current transfer of the calling thread
+//----------------------------------------------------------------------------------------
+TransferScheduler* TransferScheduler::getCurrent()
+{
+   return s_current.get();
+}
+
+//----------------------------------------------------------------------------------------
+// Set the scheduler of the current transfer of the calling thread
+//----------------------------------------------------------------------------------------
+void TransferScheduler::setCurrent(TransferScheduler* schedulerp)
+{
+   s_current.reset(schedulerp);
+}
+
+//----------------------------------------------------------------------------------------
+// Print throughput and time spent throttled
+//----------------------------------------------------------------------------------------
+void TransferScheduler::report(ostream& os) const
+{
+   boost::mutex::scoped_lock lock(m_mutex);
+
+   const double elapsed = (getMonotonic() - m_start) / 1e6;
+   const double size = m_size / 1e6;
+   os << "Read " << fixed << setprecision(1) << size << " MB in " << elapsed << " s";
+   if (elapsed > 0)
+   {
+      os << " (" << size / elapsed << " MB/s)";
+   }
+   os << ", throttled " << m_throttled / 1e6 << " s." << endl;
+}
+
+//----------------------------------------------------------------------------------------
+// Parse the read bandwidth from a command option argument in MB/s
+//----------------------------------------------------------------------------------------
+uint64_t TransferScheduler::getBandwidth(const string& arg)
+{
+   uint64_t bandwidth;
+   try
+   {
+      bandwidth = boost::lexical_cast<uint64_t>(arg);
+   }
+   catch (boost::bad_lexical_cast&)
+   {
+      throw Exception(Exception::illBandwidth(arg), WHERE__);
+   }
+   if ((bandwidth == 0) || (bandwidth > s_maxbandwidth))
+   {
+      throw Exception(Exception::illBandwidth(arg), WHERE__);
+   }
+   return bandwidth * 1000000;
+}
+
+//----------------------------------------------------------------------------------------
+// Parse the CPU share from a command option argument in percent
+//----------------------------------------------------------------------------------------
+unsigned int TransferScheduler::getCpuShare(const string& arg)
+{
+   unsigned int cpushare;
+   try
+   {
+      cpushare = boost::lexical_cast<unsigned int>(arg);
+   }
+   catch (boost::bad_lexical_cast&)
+   {
+      throw Exception(Exception::illCpuShare(arg), WHERE__);
+   }
+   if ((cpushare == 0) || (cpushare > 100))
+   {
+      throw Exception(Exception::illCpuShare(arg), WHERE__);
+   }
+   return cpushare;
+}
+
+//----------------------------------------------------------------------------------------
+// Account data read and wait. The time when a thread may continue is the latest of:
+// - the time when the data read so far is within the bandwidth,
+// - the time when the CPU time used so far is within the CPU share,
+// - the end of a pause for the log server.
+//----------------------------------------------------------------------------------------
+void TransferScheduler::wait(size_t size)
+{
+   boost::mutex::scoped_lock lock(m_mutex);
+
+   int64_t now = getMonotonic();
+   m_size += size;
+
+   int64_t until = now;
+   if (m_bandwidth != 0)
+   {
+      m_next = max(m_next, now) + static_cast<int64_t>(size * 1000000 / m_bandwidth);
+      until = max(until, m_next);
+   }
+   if (m_cpushare != 0)
+   {
+      const int64_t cputime = getCpuTime() - m_cpustart;
+      until = max(until, m_start + cputime * 100 / (m_cpushare * m_cores));
+   }
+
+   if ((until <= now) && (isPaused(now) == false))
+   {
+      return;
+   }
+
+   if (m_waiting++ == 0)
+   {
+      m_waitstart = now;
+   }
+   do
+   {
+      // The pause is checked again at intervals
+      const int64_t delay = (until > now)? min(until - now, s_checkinterval): s_checkinterval;
+      lock.unlock();
+      boost::this_thread::sleep(boost::posix_time::microseconds(delay));
+      lock.lock();
+      now = getMonotonic();
+   }
+   while ((until > now) || isPaused(now));
+   if (--m_waiting == 0)
+   {
+      m_throttled += now - m_waitstart;
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Check if reads are paused for the log server. A pause ends when the log server has
+// caught up, or after the longest pause so that the transfer is not stopped by a
+// lasting backlog.
+//----------------------------------------------------------------------------------------
+bool TransferScheduler::isPaused(int64_t now)
+{
+   if (now - m_checked >= s_checkinterval)
+   {
+      m_backlog = IngestStatus::isBacklogged();
+      m_checked = now;
+   }
+
+   if (m_backlog == false)
+   {
+      m_pausestart = 0;
+      return false;
+   }
+   if (m_pausestart == 0)
+   {
+      m_pausestart = now;
+   }
+   return now - m_pausestart < s_maxpause;
+}
+
+//----------------------------------------------------------------------------------------
+// Get monotonic time in microseconds
+//----------------------------------------------------------------------------------------
+int64_t TransferScheduler::getMonotonic()
+{
+   timespec ts;
+   clock_gettime(CLOCK_MONOTONIC, &ts);
+   return ts.tv_sec * int64_t(1000000) + ts.tv_nsec / 1000;
+}
+
+//----------------------------------------------------------------------------------------
+// Get CPU time used by the process in microseconds
+//----------------------------------------------------------------------------------------
+int64_t TransferScheduler::getCpuTime()
+{
+   timespec ts;
+   clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+   return ts.tv_sec * int64_t(1000000) + ts.tv_nsec / 1000;
+}
+
+}
@@ -38,6 +38,9 @@
 
 #include <boost/lexical_cast.hpp>
 #include <stdint.h>
+#include <string.h>
+#include <ctype.h>
+#include <limits>
 
 #include "xmfilter.h"
 #include "exception.h"
@@ -224,33 +227,54 @@ bool XmFilter::test(uint16_t xmno) const
    return false;
 }
 
+//----------------------------------------------------------------------------------------
+// Check if the filter reads the event data
+//----------------------------------------------------------------------------------------
+bool XmFilter::needsData() const
+{
+   return m_str.empty() == false;
+}
+
 //----------------------------------------------------------------------------------------
 // Test filter match
 //----------------------------------------------------------------------------------------
-bool XmFilter::test(const std::string& str) const
+bool XmFilter::test(const char* data, size_t size) const
 {
    if (m_str.empty()) return true;
 
-   uint16_t xmno;
-   if (str.substr(0, 3) == "XM ")
+   if ((size >= 3) && (memcmp(data, "XM ", 3) == 0))
    {
-      size_t pos = str.find(':');
-      if (pos == string::npos) return false;
-      try
+      const char* end = static_cast<const char*>(memchr(data, ':', size));
+      if (end == 0) return false;
+
+      uint32_t xmno = 0;
+      const char* pos = data + 3;
+      if (pos == end)
       {
-         xmno = boost::lexical_cast<uint16_t>(str.substr(3, pos - 3));
+         throw Exception(Exception::illXmno(0), WHERE__);
       }
-      catch (exception&)
+      for (; pos != end; ++pos)
       {
-                     throw Exception(Exception::illXmno(xmno), WHERE__);
+         if (isdigit(static_cast<unsigned char>(*pos)) == 0)
+         {
+            throw Exception(Exception::illXmno(static_cast<uint16_t>(xmno)), WHERE__);
+         }
+         xmno = xmno * 10 + (*pos - '0');
+         if (xmno > numeric_limits<uint16_t>::max())
+         {
+            // Not a 16-bit number
+            throw Exception(Exception::illXmno(static_cast<uint16_t>(xmno)), WHERE__);
+         }
       }
       if (xmno < 1 || xmno > s_maxmno) return false;
+
+      return test(static_cast<uint16_t>(xmno));
    }
-   else if (str.find("KERNEL:") == 0)
+   else if ((size >= 7) && (memcmp(data, "KERNEL:", 7) == 0))
    {
       return m_kernel? true: false;
    }
-   else if (str.find("PARENTX:") == 0)
+   else if ((size >= 8) && (memcmp(data, "PARENTX:", 8) == 0))
    {
       return m_parentx? true: false;
    }
@@ -258,8 +282,6 @@ bool XmFilter::test(const std::string& str) const
    {
       return false;
    }
-
-   return test(xmno);
 }
 
 //----------------------------------------------------------------------------------------
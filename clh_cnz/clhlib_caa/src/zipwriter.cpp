@@ -0,0 +1,964 @@
+//#<heading>
+//----------------------------------------------------------------------------------------
+//
+//  FILE
+//      zipwriter.cpp
+//
+//  COPYRIGHT
+//      Copyright Ericsson AB 2026. All rights reserved.
+//
+//      The Copyright to the computer program(s) herein is the property of
+//      Ericsson AB, Sweden. The program(s) may be used and/or copied only
+//      with the written permission from Ericsson AB or in accordance with
+//      the terms and conditions stipulated in the agreement/contract under
+//      which the program(s) have been supplied.
+//
+//  DESCRIPTION
+//      In-process writer for zip archives, replacing the zip command.
+//
+//  ERROR HANDLING
+//      C++ exceptions are used for error handling.
+//
+//  DOCUMENT NO
+//      190 89-CAA 109 1424  PA1
+//
+//  AUTHOR
+//      EAB/FLE/EM
+//
+//  REVISION HISTORY
+//      Rev.   Date         Prepared    Description
+//      ----   ----         --------    -----------
+//      PA1    2026-10-16   -           Created.
+//
+//  SEE ALSO
+//      -
+//
+//----------------------------------------------------------------------------------------
+//#</heading>
+
+#include "zipwriter.h"
+#include "common.h"
+#include "exception.h"
+#include "transferscheduler.h"
+#include <boost/bind.hpp>
+#include <boost/lexical_cast.hpp>
+#include <boost/thread.hpp>
+#include <algorithm>
+#include <zlib.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+using namespace std;
+
+namespace PES_CLH {
+
+const int ZipEntry::s_defaultlevel;
+const size_t ZipWriter::s_defaultthreads = 4;
+
+namespace {
+
+const uint32_t s_localsig = 0x04034b50;       // Local file header
+const uint32_t s_centralsig = 0x02014b50;     // Central directory file header
+const uint32_t s_endsig = 0x06054b50;         // End of central directory record
+const uint32_t s_end64sig = 0x06064b50;       // Zip64 end of central directory record
+const uint32_t s_locator64sig = 0x07064b50;   // Zip64 end of central directory locator
+const uint16_t s_zip64id = 0x0001;            // Zip64 extra field
+const uint16_t s_stored = 0;                  // Compression method, no compression
+const uint16_t s_deflated = 8;                // Compression method, deflate
+const uint16_t s_version = 20;                // Version needed to extract
+const uint16_t s_version64 = 45;              // Version needed to extract, zip64
+const uint16_t s_madebyunix = 3 << 8;         // Host system for "version made by"
+const uint32_t s_max32 = 0xffffffff;          // Value for a field kept in zip64 records
+const uint16_t s_max16 = 0xffff;              // Value for a count kept in zip64 records
+const uint64_t s_zip64size = 0xf0000000;      // File size where zip64 fields are used,
+                                              // allows for the deflate overhead
+const size_t s_chunksize = 256 * 1024;        // Size of compression chunks
+const size_t s_memsize = 1024 * 1024;         // Compressed entry data kept in memory,
+                                              // the rest is spilled to a file
+const size_t s_blocksize = 1024 * 1024;       // Size of file blocks compressed in parallel
+const size_t s_dictsize = 32 * 1024;          // Deflate window, primes the next block
+
+// Append little endian values
+void put16(string& s, uint16_t value)
+{
+   s += static_cast<char>(value & 0xff);
+   s += static_cast<char>(value >> 8);
+}
+
+void put32(string& s, uint32_t value)
+{
+   put16(s, static_cast<uint16_t>(value & 0xffff));
+   put16(s, static_cast<uint16_t>(value >> 16));
+}
+
+void put64(string& s, uint64_t value)
+{
+   put32(s, static_cast<uint32_t>(value & s_max32));
+   put32(s, static_cast<uint32_t>(value >> 32));
+}
+
+// Get a 32 bit field, or the zip64 marker if the value does not fit
+uint32_t get32(uint64_t value)
+{
+   return (value < s_max32)? static_cast<uint32_t>(value): s_max32;
+}
+
+// File block, deflated on its own
+struct t_block
+{
+   std::vector<char> m_dict;           // End of the previous block
+   std::vector<char> m_input;          // Uncompressed data
+   size_t m_size;                      // Size of the uncompressed data
+   bool m_last;                        // Last block of the file
+   std::vector<char> m_output;         // Compressed data
+   uint32_t m_crc;                     // CRC-32 of the uncompressed data
+   bool m_ok;                          // Compression succeeded
+};
+
+typedef std::vector<t_block> BLOCKLIST;
+
+// Deflate a block. The block ends on a byte boundary, with the final block bit only
+// if it is the last block, so the blocks can be joined into one deflate stream.
+void compressBlock(t_block& block, int level)
+{
+   const Bytef* const data = reinterpret_cast<const Bytef*>(&block.m_input[0]);
+   block.m_crc = crc32(crc32(0, Z_NULL, 0), data, block.m_size);
+   block.m_ok = false;
+
+   z_stream zs;
+   memset(&zs, 0, sizeof(zs));
+   if (deflateInit2(&zs, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+   {
+      block.m_output.clear();
+      return;
+   }
+   if (block.m_dict.empty() == false)
+   {
+      deflateSetDictionary(&zs, reinterpret_cast<const Bytef*>(&block.m_dict[0]),
+                           block.m_dict.size());
+   }
+
+   // Room for the flush marker as well
+   const size_t bound = deflateBound(&zs, block.m_size) + 16;
+   block.m_output.resize(bound);
+   zs.next_in = const_cast<Bytef*>(data);
+   zs.avail_in = block.m_size;
+   zs.next_out = reinterpret_cast<Bytef*>(&block.m_output[0]);
+   zs.avail_out = bound;
+   const int result = deflate(&zs, block.m_last? Z_FINISH: Z_SYNC_FLUSH);
+   block.m_ok = block.m_last?
+                (result == Z_STREAM_END):
+                ((result == Z_OK) && (zs.avail_in == 0) && (zs.avail_out > 0));
+   block.m_output.resize(bound - zs.avail_out);
+   deflateEnd(&zs);
+}
+
+// Worker thread, deflate every step'th block from first
+void compressBlocks(BLOCKLIST& blocklist, size_t first, size_t step, size_t count, int level)
+{
+   for (size_t i = first; i < count; i += step)
+   {
+      compressBlock(blocklist[i], level);
+   }
+}
+
+}
+
+//========================================================================================
+// Class ZipEntry
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+ZipEntry::ZipEntry(int level, const fs::path& tmpdir):
+ostream(0),
+m_buffer(level, tmpdir),
+m_time(::time(0))
+{
+   rdbuf(&m_buffer);
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+ZipEntry::~ZipEntry()
+{
+}
+
+//----------------------------------------------------------------------------------------
+// Finish the compression
+//----------------------------------------------------------------------------------------
+void ZipEntry::finish()
+{
+   m_buffer.finish();
+}
+
+//----------------------------------------------------------------------------------------
+// Get size of the data written
+//----------------------------------------------------------------------------------------
+uint64_t ZipEntry::getSize() const
+{
+   return m_buffer.getSize();
+}
+
+//========================================================================================
+// Class ZipEntry::Buffer
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+ZipEntry::Buffer::Buffer(int level, const fs::path& tmpdir):
+streambuf(),
+m_data(),
+m_fd(-1),
+m_spilled(0),
+m_crc(crc32(0, Z_NULL, 0)),
+m_size(0),
+m_ok(true),
+m_buffer(s_chunksize),
+m_tmpdir(tmpdir),
+m_zstreamp(new z_stream)
+{
+   memset(m_zstreamp, 0, sizeof(z_stream));
+   if (deflateInit2(m_zstreamp, level, Z_DEFLATED, -MAX_WBITS, 8,
+                    Z_DEFAULT_STRATEGY) != Z_OK)
+   {
+      delete m_zstreamp;
+      Exception ex(Exception::internal(), WHERE__);
+      ex << "Failed to initialize compression.";
+      throw ex;
+   }
+   setp(&m_buffer[0], &m_buffer[0] + m_buffer.size());
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+ZipEntry::Buffer::~Buffer()
+{
+   if (m_zstreamp)
+   {
+      deflateEnd(m_zstreamp);
+      delete m_zstreamp;
+   }
+   if (m_fd != -1)
+   {
+      ::close(m_fd);
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Compress the buffer and finish the compression
+//----------------------------------------------------------------------------------------
+void ZipEntry::Buffer::finish()
+{
+   if (m_zstreamp == 0)
+   {
+      return;
+   }
+
+   if (compress(Z_FINISH) == false)
+   {
+      m_ok = false;
+   }
+   deflateEnd(m_zstreamp);
+   delete m_zstreamp;
+   m_zstreamp = 0;
+   setp(0, 0);
+}
+
+//----------------------------------------------------------------------------------------
+// Get size of the data written, including the uncompressed part
+//----------------------------------------------------------------------------------------
+uint64_t ZipEntry::Buffer::getSize() const
+{
+   return m_size + (pptr() - pbase());
+}
+
+//----------------------------------------------------------------------------------------
+// Buffer is full, compress it
+//----------------------------------------------------------------------------------------
+ZipEntry::Buffer::int_type ZipEntry::Buffer::overflow(int_type ch)
+{
+   if ((m_zstreamp == 0) || (compress(Z_NO_FLUSH) == false))
+   {
+      return traits_type::eof();
+   }
+   if (traits_type::eq_int_type(ch, traits_type::eof()) == false)
+   {
+      *pptr() = traits_type::to_char_type(ch);
+      pbump(1);
+   }
+   return traits_type::not_eof(ch);
+}
+
+//----------------------------------------------------------------------------------------
+// Write a block of data
+//----------------------------------------------------------------------------------------
+streamsize ZipEntry::Buffer::xsputn(const char* data, streamsize size)
+{
+   streamsize done = 0;
+   while (done < size)
+   {
+      if (pptr() == epptr())
+      {
+         if ((m_zstreamp == 0) || (compress(Z_NO_FLUSH) == false))
+         {
+            break;
+         }
+      }
+      const streamsize len = min(size - done, static_cast<streamsize>(epptr() - pptr()));
+      memcpy(pptr(), data + done, len);
+      pbump(static_cast<int>(len));
+      done += len;
+   }
+   return done;
+}
+
+//----------------------------------------------------------------------------------------
+// Flush, the data is kept in the buffer until it is full
+//----------------------------------------------------------------------------------------
+int ZipEntry::Buffer::sync()
+{
+   return 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Compress the buffer, the compressed data is spilled when it exceeds the memory limit
+//----------------------------------------------------------------------------------------
+bool ZipEntry::Buffer::compress(int flush)
+{
+   if (m_ok == false)
+   {
+      return false;
+   }
+
+   const size_t size = pptr() - pbase();
+   m_crc = crc32(m_crc, reinterpret_cast<const Bytef*>(pbase()), size);
+   m_size += size;
+
+   z_stream& zs = *m_zstreamp;
+   zs.next_in = reinterpret_cast<Bytef*>(pbase());
+   zs.avail_in = size;
+   int result;
+   do
+   {
+      const size_t used = m_data.size();
+      m_data.resize(used + s_chunksize);
+      zs.next_out = reinterpret_cast<Bytef*>(&m_data[used]);
+      zs.avail_out = s_chunksize;
+      result = deflate(&zs, flush);
+      m_data.resize(used + s_chunksize - zs.avail_out);
+   }
+   while ((result == Z_OK) && ((zs.avail_out == 0) || (flush == Z_FINISH)));
+
+   setp(&m_buffer[0], &m_buffer[0] + m_buffer.size());
+
+   if ((result != Z_OK) && (result != Z_STREAM_END) && (result != Z_BUF_ERROR))
+   {
+      m_ok = false;
+   }
+   else if (m_data.size() >= s_memsize)
+   {
+      m_ok = spill();
+   }
+   return m_ok;
+}
+
+//----------------------------------------------------------------------------------------
+// Move the compressed data to the temporary file. The file is unlinked when it is
+// created, so it is removed when it is closed.
+//----------------------------------------------------------------------------------------
+bool ZipEntry::Buffer::spill()
+{
+   if (m_fd == -1)
+   {
+      const fs::path dir = m_tmpdir.empty()? fs::temp_directory_path(): m_tmpdir;
+      const string pattern = (dir / "clhzip_XXXXXX").string();
+      vector<char> name(pattern.begin(), pattern.end());
+      name.push_back('\0');
+      m_fd = ::mkstemp(&name[0]);
+      if (m_fd == -1)
+      {
+         return false;
+      }
+      ::unlink(&name[0]);
+   }
+
+   size_t done = 0;
+   while (done < m_data.size())
+   {
+      const ssize_t len = ::write(m_fd, &m_data[done], m_data.size() - done);
+      if (len < 0)
+      {
+         if (errno == EINTR)
+         {
+            continue;
+         }
+         return false;
+      }
+      done += len;
+   }
+   m_spilled += m_data.size();
+   m_data.clear();
+   return true;
+}
+
+//========================================================================================
+// Class ZipWriter
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+ZipWriter::ZipWriter(const fs::path& path, size_t threads, int level):
+m_path(path),
+m_fs(),
+m_offset(0),
+m_entrylist(),
+m_closed(false),
+m_threads(threads),
+m_level(level)
+{
+   if (m_threads == 0)
+   {
+      // Half of the cores, leaving the rest to the log server and the transfer jobs
+      m_threads = boost::thread::hardware_concurrency() / 2;
+      if (m_threads > s_defaultthreads)
+      {
+         m_threads = s_defaultthreads;
+      }
+      if (m_threads == 0)
+      {
+         m_threads = 1;
+      }
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+ZipWriter::~ZipWriter()
+{
+   if (m_fs.is_open())
+   {
+      // Incomplete archive
+      m_fs.close();
+      boost::system::error_code ec;
+      fs::remove(m_path, ec);
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Add a file or a directory tree
+//----------------------------------------------------------------------------------------
+void ZipWriter::add(const fs::path& path)
+{
+   const fs::file_status& stat = fs::status(path);
+   if (fs::is_directory(stat))
+   {
+      addDirectory(path);
+   }
+   else if (fs::is_regular_file(stat))
+   {
+      addFile(path);
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Add a compressed entry, the spilled data is streamed from the temporary file
+//----------------------------------------------------------------------------------------
+void ZipWriter::add(const string& name, ZipEntry& entry)
+{
+   entry.finish();
+   if (entry.bad() || (entry.m_buffer.m_ok == false))
+   {
+      Exception ex(Exception::internal(), WHERE__);
+      ex << "Failed to compress archive entry " << name << ".";
+      throw ex;
+   }
+
+   open();
+   const ZipEntry::Buffer& buffer = entry.m_buffer;
+   t_entry zentry = makeEntry(name, entry.m_time, S_IFREG | 0644);
+   zentry.m_method = s_deflated;
+   zentry.m_crc = buffer.m_crc;
+   zentry.m_csize = buffer.m_spilled + buffer.m_data.size();
+   zentry.m_size = buffer.m_size;
+   zentry.m_offset = m_offset;
+
+   writeLocalHeader(zentry, (zentry.m_size >= s_max32) || (zentry.m_csize >= s_max32));
+   if (buffer.m_spilled > 0)
+   {
+      if (::lseek(buffer.m_fd, 0, SEEK_SET) != 0)
+      {
+         Exception ex(Exception::system(), WHERE__);
+         ex << "Failed to read archive entry " << name << ".";
+         ex.sysError();
+         throw ex;
+      }
+      vector<char> chunk(s_chunksize);
+      uint64_t done = 0;
+      while (done < buffer.m_spilled)
+      {
+         const ssize_t len = ::read(buffer.m_fd, &chunk[0], chunk.size());
+         if ((len < 0) && (errno == EINTR))
+         {
+            continue;
+         }
+         if (len <= 0)
+         {
+            Exception ex(Exception::system(), WHERE__);
+            ex << "Failed to read archive entry " << name << ".";
+            ex.sysError();
+            throw ex;
+         }
+         write(&chunk[0], len);
+         done += len;
+      }
+   }
+   if (buffer.m_data.empty() == false)
+   {
+      write(&buffer.m_data[0], buffer.m_data.size());
+   }
+   m_entrylist.push_back(zentry);
+}
+
+//----------------------------------------------------------------------------------------
+// Create an entry with the compression level of the archive, spilling beside it
+//----------------------------------------------------------------------------------------
+ZIPENTRYPTR ZipWriter::createEntry() const
+{
+   return ZIPENTRYPTR(new ZipEntry(m_level, m_path.parent_path()));
+}
+
+//----------------------------------------------------------------------------------------
+// Write the central directory and close the archive
+//----------------------------------------------------------------------------------------
+void ZipWriter::close()
+{
+   if (m_closed)
+   {
+      return;
+   }
+   m_closed = true;
+   if (m_fs.is_open() == false)
+   {
+      // No entries, no archive
+      return;
+   }
+
+   const uint64_t cdoffset = m_offset;
+   for (ENTRYLIST::const_iterator iter = m_entrylist.begin(); iter != m_entrylist.end(); ++iter)
+   {
+      const t_entry& entry = *iter;
+      string extra;
+      if ((entry.m_size >= s_max32) || (entry.m_csize >= s_max32))
+      {
+         put64(extra, entry.m_size);
+         put64(extra, entry.m_csize);
+      }
+      if (entry.m_offset >= s_max32)
+      {
+         put64(extra, entry.m_offset);
+      }
+      const uint16_t version = extra.empty()? s_version: s_version64;
+
+      string s;
+      put32(s, s_centralsig);
+      put16(s, s_madebyunix | version);
+      put16(s, version);
+      put16(s, 0);                                  // Flags
+      put16(s, entry.m_method);
+      put16(s, entry.m_time);
+      put16(s, entry.m_date);
+      put32(s, entry.m_crc);
+      put32(s, extra.empty()? get32(entry.m_csize): s_max32);
+      put32(s, extra.empty()? get32(entry.m_size): s_max32);
+      put16(s, entry.m_name.size());
+      put16(s, extra.empty()? 0: extra.size() + 4);
+      put16(s, 0);                                  // Comment length
+      put16(s, 0);                                  // Disk number
+      put16(s, 0);                                  // Internal attributes
+      put32(s, entry.m_attr);
+      put32(s, get32(entry.m_offset));
+      s += entry.m_name;
+      if (extra.empty() == false)
+      {
+         put16(s, s_zip64id);
+         put16(s, extra.size());
+         s += extra;
+      }
+      write(s.data(), s.size());
+   }
+   const uint64_t cdsize = m_offset - cdoffset;
+   const uint64_t count = m_entrylist.size();
+
+   string s;
+   if ((count >= s_max16) || (cdsize >= s_max32) || (cdoffset >= s_max32))
+   {
+      const uint64_t end64offset = m_offset;
+      put32(s, s_end64sig);
+      put64(s, 44);                                 // Size of the rest of the record
+      put16(s, s_madebyunix | s_version64);
+      put16(s, s_version64);
+      put32(s, 0);                                  // Disk number
+      put32(s, 0);                                  // Disk with the central directory
+      put64(s, count);
+      put64(s, count);
+      put64(s, cdsize);
+      put64(s, cdoffset);
+
+      put32(s, s_locator64sig);
+      put32(s, 0);                                  // Disk with the zip64 record
+      put64(s, end64offset);
+      put32(s, 1);                                  // Number of disks
+   }
+   put32(s, s_endsig);
+   put16(s, 0);                                     // Disk number
+   put16(s, 0);                                     // Disk with the central directory
+   put16(s, (count < s_max16)? count: s_max16);
+   put16(s, (count < s_max16)? count: s_max16);
+   put32(s, get32(cdsize));
+   put32(s, get32(cdoffset));
+   put16(s, 0);                                     // Comment length
+   write(s.data(), s.size());
+
+   m_fs.close();
+   if (m_fs.fail())
+   {
+      writeError();
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Get path to the archive
+//----------------------------------------------------------------------------------------
+const fs::path& ZipWriter::getPath() const
+{
+   return m_path;
+}
+
+//----------------------------------------------------------------------------------------
+// Get compression level
+//----------------------------------------------------------------------------------------
+int ZipWriter::getLevel() const
+{
+   return m_level;
+}
+
+//----------------------------------------------------------------------------------------
+// Parse the compression level from a command option argument
+//----------------------------------------------------------------------------------------
+int ZipWriter::getCompressionLevel(const string& arg)
+{
+   int level;
+   try
+   {
+      level = boost::lexical_cast<int>(arg);
+   }
+   catch (boost::bad_lexical_cast&)
+   {
+      throw Exception(Exception::illCompressionLevel(arg), WHERE__);
+   }
+   if ((level < Z_NO_COMPRESSION) || (level > Z_BEST_COMPRESSION))
+   {
+      throw Exception(Exception::illCompressionLevel(arg), WHERE__);
+   }
+   return level;
+}
+
+//----------------------------------------------------------------------------------------
+// Create the archive file if not done
+//----------------------------------------------------------------------------------------
+void ZipWriter::open()
+{
+   if (m_closed)
+   {
+      Exception ex(Exception::internal(), WHERE__);
+      ex << "Archive " << m_path << " is closed.";
+      throw ex;
+   }
+   if (m_fs.is_open())
+   {
+      return;
+   }
+
+   m_fs.open(m_path, ios_base::out | ios_base::trunc | ios_base::binary);
+   if (m_fs.is_open() == false)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to create archive " << m_path << ".";
+      ex.sysError();
+      throw ex;
+   }
+   m_offset = 0;
+}
+
+//----------------------------------------------------------------------------------------
+// Add a directory entry and the directory contents, in name order
+//----------------------------------------------------------------------------------------
+void ZipWriter::addDirectory(const fs::path& path)
+{
+   struct stat st;
+   if (::stat(path.c_str(), &st) != 0)
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to read directory " << path << ".";
+      ex.sysError();
+      throw ex;
+   }
+
+   open();
+   t_entry entry = makeEntry(path.generic_string() + "/", st.st_mtime, st.st_mode);
+   entry.m_attr |= 0x10;                           // MS-DOS directory attribute
+   entry.m_offset = m_offset;
+   writeLocalHeader(entry, false);
+   m_entrylist.push_back(entry);
+
+   vector<fs::path> pathlist;
+   fs::directory_iterator end;
+   for (fs::directory_iterator iter(path); iter != end; ++iter)
+   {
+      pathlist.push_back(*iter);
+   }
+   sort(pathlist.begin(), pathlist.end());
+   for (vector<fs::path>::const_iterator iter = pathlist.begin(); iter != pathlist.end(); ++iter)
+   {
+      add(*iter);
+   }
+}
+
+//----------------------------------------------------------------------------------------
+// Add a file, deflated in blocks while it is read. The blocks of a batch are deflated
+// in parallel and written in order. The local header is written first and updated
+// with the CRC and the sizes when the file is written.
+//----------------------------------------------------------------------------------------
+void ZipWriter::addFile(const fs::path& path)
+{
+   fs::ifstream ifs(path, ios_base::binary);
+   struct stat st;
+   if ((ifs.is_open() == false) || (::stat(path.c_str(), &st) != 0))
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "Failed to open file " << path << ".";
+      ex.sysError();
+      throw ex;
+   }
+
+   open();
+   t_entry entry = makeEntry(path.generic_string(), st.st_mtime, st.st_mode);
+   entry.m_method = s_deflated;
+   entry.m_crc = crc32(0, Z_NULL, 0);
+   entry.m_offset = m_offset;
+   const bool zip64 = static_cast<uint64_t>(st.st_size) >= s_zip64size;
+   writeLocalHeader(entry, zip64);
+
+   // A few blocks per thread in each batch, to even out the load
+   BLOCKLIST blocklist(m_threads * 2);
+   vector<char> dict;
+   bool last = false;
+   while (last == false)
+   {
+      // Read a batch
+      size_t count = 0;
+      while ((count < blocklist.size()) && (last == false))
+      {
+         t_block& block = blocklist[count++];
+         block.m_dict = dict;
+         block.m_input.resize(s_blocksize);
+         ifs.read(&block.m_input[0], s_blocksize);
+         block.m_size = ifs.gcount();
+         if (ifs.bad())
+         {
+            Exception ex(Exception::system(), WHERE__);
+            ex << "Failed to read file " << path << ".";
+            ex.sysError();
+            throw ex;
+         }
+         last = ifs.eof() || (ifs.peek() == char_traits<char>::eof());
+         block.m_last = last;
+
+         const size_t dictsize = min(block.m_size, s_dictsize);
+         dict.assign(block.m_input.begin() + (block.m_size - dictsize),
+                     block.m_input.begin() + block.m_size);
+      }
+
+      // Compress the batch, within the CPU share of the transfer
+      TransferScheduler::throttle(0);
+      const size_t nothreads = min(m_threads, count);
+      if (nothreads <= 1)
+      {
+         compressBlocks(blocklist, 0, 1, count, m_level);
+      }
+      else
+      {
+         boost::thread_group threadgroup;
+         for (size_t i = 0; i < nothreads; i++)
+         {
+            threadgroup.create_thread(
+                  boost::bind(compressBlocks, boost::ref(blocklist), i, nothreads, count, m_level));
+         }
+         threadgroup.join_all();
+      }
+
+      // Write the batch
+      for (size_t i = 0; i < count; i++)
+      {
+         const t_block& block = blocklist[i];
+         if (block.m_ok == false)
+         {
+            Exception ex(Exception::internal(), WHERE__);
+            ex << "Failed to compress file " << path << ".";
+            throw ex;
+         }
+         entry.m_crc = crc32_combine(entry.m_crc, block.m_crc, block.m_size);
+         entry.m_size += block.m_size;
+         if (block.m_output.empty() == false)
+         {
+            write(&block.m_output[0], block.m_output.size());
+         }
+         entry.m_csize += block.m_output.size();
+      }
+   }
+
+   if ((zip64 == false) && ((entry.m_size >= s_max32) || (entry.m_csize >= s_max32)))
+   {
+      Exception ex(Exception::system(), WHERE__);
+      ex << "File " << path << " grew too large while it was archived.";
+      throw ex;
+   }
+
+   // Update the local header
+   const uint64_t end = m_offset;
+   m_fs.seekp(entry.m_offset);
+   m_offset = entry.m_offset;
+   writeLocalHeader(entry, zip64);
+   m_fs.seekp(end);
+   m_offset = end;
+
+   m_entrylist.push_back(entry);
+}
+
+//----------------------------------------------------------------------------------------
+// Create an entry description
+//----------------------------------------------------------------------------------------
+ZipWriter::t_entry ZipWriter::makeEntry(const string& name, time_t mtime, uint32_t mode)
+{
+   t_entry entry;
+   entry.m_name = name;
+   while ((entry.m_name.compare(0, 2, "./") == 0) || (entry.m_name.compare(0, 1, "/") == 0))
+   {
+      // Relative names, as the zip command
+      entry.m_name.erase(0, (entry.m_name[0] == '/')? 1: 2);
+   }
+   entry.m_method = s_stored;
+   entry.m_crc = 0;
+   entry.m_csize = 0;
+   entry.m_size = 0;
+   entry.m_offset = 0;
+   entry.m_attr = mode << 16;
+
+   // MS-DOS date and time, local time from 1980
+   tm tmtime;
+   localtime_r(&mtime, &tmtime);
+   if (tmtime.tm_year < 80)
+   {
+      entry.m_time = 0;
+      entry.m_date = (1 << 5) | 1;
+   }
+   else
+   {
+      entry.m_time = (tmtime.tm_hour << 11) | (tmtime.tm_min << 5) | (tmtime.tm_sec / 2);
+      entry.m_date = ((tmtime.tm_year - 80) << 9) | ((tmtime.tm_mon + 1) << 5) | tmtime.tm_mday;
+   }
+   return entry;
+}
+
+//----------------------------------------------------------------------------------------
+// Write a local header
+//----------------------------------------------------------------------------------------
+void ZipWriter::writeLocalHeader(const t_entry& entry, bool zip64)
+{
+   string s;
+   put32(s, s_localsig);
+   put16(s, zip64? s_version64: s_version);
+   put16(s, 0);                                     // Flags
+   put16(s, entry.m_method);
+   put16(s, entry.m_time);
+   put16(s, entry.m_date);
+   put32(s, entry.m_crc);
+   put32(s, zip64? s_max32: entry.m_csize);
+   put32(s, zip64? s_max32: entry.m_size);
+   put16(s, entry.m_name.size());
+   put16(s, zip64? 20: 0);
+   s += entry.m_name;
+   if (zip64)
+   {
+      put16(s, s_zip64id);
+      put16(s, 16);
+      put64(s, entry.m_size);
+      put64(s, entry.m_csize);
+   }
+   write(s.data(), s.size());
+}
+
+//----------------------------------------------------------------------------------------
+// Write to the archive
+//----------------------------------------------------------------------------------------
+void ZipWriter::write(const char* data, size_t size)
+{
+   m_fs.write(data, size);
+   if (m_fs.fail())
+   {
+      writeError();
+   }
+   m_offset += size;
+}
+
+//----------------------------------------------------------------------------------------
+// Throw an exception for a failed write
+//----------------------------------------------------------------------------------------
+void ZipWriter::writeError() const
+{
+   Exception ex(Exception::system(), WHERE__);
+   ex << "Failed to write archive " << m_path << ".";
+   ex.sysError();
+   throw ex;
+}
+
+//========================================================================================
+// Class ArchiveSession
+//========================================================================================
+
+//----------------------------------------------------------------------------------------
+// Constructor
+//----------------------------------------------------------------------------------------
+ArchiveSession::ArchiveSession(const fs::path& path, size_t threads, int level):
+m_writer(path, threads, level)
+{
+   Common::setArchive(&m_writer);
+}
+
+//----------------------------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------------------------
+ArchiveSession::~ArchiveSession()
+{
+   Common::setArchive(0);
+}
+
+//----------------------------------------------------------------------------------------
+// Write the central directory and close the archive
+//----------------------------------------------------------------------------------------
+void ArchiveSession::close()
+{
+   m_writer.close();
+}
+
+}